@@ -0,0 +1,182 @@
+#include "ImageKernels.h"
+#include "ImageSimd.h"
+#include "Parallel.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <stdexcept>
+#include <vector>
+
+namespace kernels {
+
+namespace {
+
+constexpr int64_t accLimit = int64_t(1) << 31;
+
+// Poids et décalage sur une même base 2^shift : w[k] ≈ weights[k] * 2^shift,
+// bias = offset * 2^shift + 2^(shift - 1) (arrondi au plus proche). Plus grand
+// shift tel que |w[k]| <= 32767 (pmaddwd) et que l'accumulateur tienne dans un
+// int32. L'écart d'arrondi de la somme des poids est reporté sur le plus
+// grand : des entrées égales à v donnent v quand les poids somment à 1.
+struct Fixed {
+    std::vector<int16_t> w;
+    int32_t bias = 0;
+    int shift = 0;
+};
+
+bool quantizeAt(const double* weights, int n, double offset, int shift, Fixed& f) {
+    const double scale = std::ldexp(1.0, shift);
+    f.w.assign(n, 0);
+    f.shift = shift;
+    double sum = 0;
+    int64_t qsum = 0;
+    int big = 0;
+    for (int k = 0; k < n; ++k) {
+        const double q = std::round(weights[k] * scale);
+        if (std::fabs(q) > 32767) return false;
+        f.w[k] = static_cast<int16_t>(q);
+        sum += weights[k];
+        qsum += f.w[k];
+        if (std::fabs(weights[k]) > std::fabs(weights[big])) big = k;
+    }
+    if (n) {
+        const int64_t fixed = f.w[big] + (static_cast<int64_t>(std::llround(sum * scale)) - qsum);
+        if (fixed < -32767 || fixed > 32767) return false;
+        f.w[big] = static_cast<int16_t>(fixed);
+    }
+    int64_t sumAbs = 0;
+    for (int16_t w : f.w) sumAbs += w < 0 ? -w : w;
+    const int64_t bias = std::llround(offset * scale) + (shift ? int64_t(1) << (shift - 1) : 0);
+    if (sumAbs * 255 + (bias < 0 ? -bias : bias) >= accLimit) return false;
+    f.bias = static_cast<int32_t>(bias);
+    return true;
+}
+
+Fixed quantize(const double* weights, int n, double offset) {
+    double sumAbs = 0;
+    for (int k = 0; k < n; ++k) {
+        if (!std::isfinite(weights[k])) throw std::invalid_argument("linearCombination: non-finite weight");
+        sumAbs += std::fabs(weights[k]);
+    }
+    if (std::isnan(offset)) throw std::invalid_argument("linearCombination: non-finite offset");
+    // Au-delà de 255 * (1 + Σ|w|), le résultat est saturé quelles que soient les entrées
+    const double bound = 255 * (1 + sumAbs);
+    offset = std::max(-bound, std::min(bound, offset));
+    Fixed f;
+    for (int shift = 15; shift >= 0; --shift)
+        if (quantizeAt(weights, n, offset, shift, f)) return f;
+    throw std::invalid_argument("linearCombination: weights too large for 8-bit fixed point");
+}
+
+inline uint8_t finish(int32_t acc, int shift) {
+    const int32_t v = acc >> shift;
+    return static_cast<uint8_t>(v < 0 ? 0 : (v > 255 ? 255 : v));
+}
+
+// Octets [from, to) : rows[k] à nul pour un terme absent de la ligne
+void combineBytes(const uint8_t* const* rows, const int16_t* w, int n, const Fixed& f, size_t from, size_t to,
+                  uint8_t* out) {
+    for (size_t i = from; i < to; ++i) {
+        int32_t acc = f.bias;
+        for (int k = 0; k < n; ++k)
+            if (rows[k]) acc += w[k] * rows[k][i];
+        out[i] = finish(acc, f.shift);
+    }
+}
+
+// Ligne y du terme k, complétée par des 0 jusqu'à `bytes` octets si la source
+// est plus étroite ; nul si la source n'a pas de ligne y
+const uint8_t* termRow(const ConstSurface& s, int y, size_t bytes, std::vector<uint8_t>& pad) {
+    if (y >= s.height || s.width <= 0) return nullptr;
+    const size_t have = static_cast<size_t>(s.width) * s.channels;
+    if (have >= bytes) return s.row(y);
+    pad.resize(bytes);
+    std::memcpy(pad.data(), s.row(y), have);
+    std::memset(pad.data() + have, 0, bytes - have);
+    return pad.data();
+}
+
+#ifdef IMAGE_HAVE_SSE2
+// === SSE2 ===
+// 16 octets par itération ; termes pris deux à deux, octets entrelacés en
+// int16 (a0, b0, a1, b1...) puis pmaddwd par (wa, wb) : 4 accumulateurs int32
+
+inline __m128i pairWeights(int16_t a, int16_t b) {
+    return _mm_set1_epi32(static_cast<int32_t>(uint32_t(uint16_t(a)) | uint32_t(uint16_t(b)) << 16));
+}
+
+size_t combineSse2(const uint8_t* const* rows, const int16_t* w, int n, const Fixed& f, size_t bytes,
+                   uint8_t* out) {
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i bias = _mm_set1_epi32(f.bias);
+    const __m128i shift = _mm_cvtsi32_si128(f.shift);
+    size_t i = 0;
+    for (; i + 16 <= bytes; i += 16) {
+        __m128i acc0 = bias, acc1 = bias, acc2 = bias, acc3 = bias;
+        for (int k = 0; k < n; k += 2) {
+            const __m128i a = simd::load(rows[k] + i);
+            const __m128i b = k + 1 < n ? simd::load(rows[k + 1] + i) : zero;
+            const __m128i wp = pairWeights(w[k], k + 1 < n ? w[k + 1] : 0);
+            const __m128i lo = _mm_unpacklo_epi8(a, b), hi = _mm_unpackhi_epi8(a, b);
+            acc0 = _mm_add_epi32(acc0, _mm_madd_epi16(_mm_unpacklo_epi8(lo, zero), wp));
+            acc1 = _mm_add_epi32(acc1, _mm_madd_epi16(_mm_unpackhi_epi8(lo, zero), wp));
+            acc2 = _mm_add_epi32(acc2, _mm_madd_epi16(_mm_unpacklo_epi8(hi, zero), wp));
+            acc3 = _mm_add_epi32(acc3, _mm_madd_epi16(_mm_unpackhi_epi8(hi, zero), wp));
+        }
+        const __m128i r01 = _mm_packs_epi32(_mm_sra_epi32(acc0, shift), _mm_sra_epi32(acc1, shift));
+        const __m128i r23 = _mm_packs_epi32(_mm_sra_epi32(acc2, shift), _mm_sra_epi32(acc3, shift));
+        simd::store(out + i, _mm_packus_epi16(r01, r23));
+    }
+    return i;
+}
+#endif
+
+} // namespace
+
+void linearCombination(const ConstSurface* src, const double* weights, int n, double offset, const Surface& dst) {
+    const Fixed f = quantize(weights, n, offset);
+    const size_t bytes = static_cast<size_t>(dst.width) * dst.channels;
+    parallel::forRange(0, dst.height, 64, [&](size_t first, size_t last) {
+        std::vector<std::vector<uint8_t>> pads(n);
+        std::vector<const uint8_t*> rows(n);
+        std::vector<int16_t> w(n);
+        for (size_t y = first; y < last; ++y) {
+            // Termes présents sur la ligne, rangés en tête
+            int m = 0;
+            for (int k = 0; k < n; ++k) {
+                const uint8_t* r = termRow(src[k], static_cast<int>(y), bytes, pads[k]);
+                if (!r || !f.w[k]) continue;
+                rows[m] = r;
+                w[m++] = f.w[k];
+            }
+            uint8_t* out = dst.row(static_cast<int>(y));
+            size_t i = 0;
+#ifdef IMAGE_HAVE_SSE2
+            i = combineSse2(rows.data(), w.data(), m, f, bytes, out);
+#endif
+            combineBytes(rows.data(), w.data(), m, f, i, bytes, out);
+        }
+    });
+}
+
+void linearCombinationScalar(const ConstSurface* src, const double* weights, int n, double offset,
+                             const Surface& dst) {
+    const Fixed f = quantize(weights, n, offset);
+    const size_t bytes = static_cast<size_t>(dst.width) * dst.channels;
+    std::vector<const uint8_t*> rows(n);
+    for (int y = 0; y < dst.height; ++y) {
+        for (int k = 0; k < n; ++k) {
+            const ConstSurface& s = src[k];
+            rows[k] = y < s.height ? s.row(y) : nullptr;
+        }
+        uint8_t* out = dst.row(y);
+        for (size_t i = 0; i < bytes; ++i) {
+            int32_t acc = f.bias;
+            for (int k = 0; k < n; ++k)
+                if (rows[k] && i < static_cast<size_t>(src[k].width) * src[k].channels) acc += f.w[k] * rows[k][i];
+            out[i] = finish(acc, f.shift);
+        }
+    }
+}
+
+} // namespace kernels
@@ -0,0 +1,221 @@
+#include "ImageKernels.h"
+#include "ImageSimd.h"
+#include "Parallel.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <vector>
+
+namespace kernels {
+
+namespace {
+
+// (sum + n/2) / n. Par multiplication-décalage, exacte tant que
+// (sum + n/2) * n < 2^32, soit n < 4096 pour sum <= 255 * n ; division au-delà.
+struct Divider {
+    uint32_t n;
+    uint32_t half;
+    uint64_t m;
+    bool exact;
+
+    explicit Divider(int window)
+        : n(static_cast<uint32_t>(window)), half(n / 2), m((uint64_t(1) << 32) / n + 1), exact(n > 1 && n < 4096) {}
+
+    uint8_t operator()(uint32_t sum) const {
+        return static_cast<uint8_t>(exact ? ((sum + half) * m) >> 32 : (sum + half) / n);
+    }
+};
+
+#ifdef IMAGE_HAVE_SSE2
+// Quatre divisions : poids fort des produits 32 x 32 -> 64 bits (pmuludq sur
+// les voies paires puis impaires)
+inline __m128i divide4(__m128i sum, __m128i m) {
+    const __m128i even = _mm_mul_epu32(sum, m);
+    const __m128i odd = _mm_mul_epu32(_mm_srli_epi64(sum, 32), m);
+    return _mm_or_si128(_mm_srli_epi64(even, 32), _mm_and_si128(odd, _mm_set_epi32(-1, 0, -1, 0)));
+}
+
+inline void widen16(__m128i v, __m128i out[4]) {
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i lo = _mm_unpacklo_epi8(v, zero), hi = _mm_unpackhi_epi8(v, zero);
+    out[0] = _mm_unpacklo_epi16(lo, zero);
+    out[1] = _mm_unpackhi_epi16(lo, zero);
+    out[2] = _mm_unpacklo_epi16(hi, zero);
+    out[3] = _mm_unpackhi_epi16(hi, zero);
+}
+#endif
+
+// acc[i] += add[i] - sub[i] (sub nul : initialisation), puis out[i] = acc[i] / n
+void slide(uint32_t* acc, const uint8_t* add, const uint8_t* sub, uint8_t* out, size_t count, const Divider& div) {
+    size_t i = 0;
+#ifdef IMAGE_HAVE_SSE2
+    if (div.exact) {
+        const __m128i half = _mm_set1_epi32(static_cast<int>(div.half));
+        const __m128i m = _mm_set1_epi32(static_cast<int>(static_cast<uint32_t>(div.m)));
+        for (; i + 16 <= count; i += 16) {
+            __m128i a[4], b[4], q[4];
+            widen16(simd::load(add + i), a);
+            widen16(sub ? simd::load(sub + i) : _mm_setzero_si128(), b);
+            for (int k = 0; k < 4; ++k) {
+                __m128i* p = reinterpret_cast<__m128i*>(acc + i + 4 * k);
+                const __m128i v = _mm_add_epi32(_mm_loadu_si128(p), _mm_sub_epi32(a[k], b[k]));
+                _mm_storeu_si128(p, v);
+                q[k] = divide4(_mm_add_epi32(v, half), m);
+            }
+            simd::store(out + i, _mm_packus_epi16(_mm_packs_epi32(q[0], q[1]), _mm_packs_epi32(q[2], q[3])));
+        }
+    }
+#endif
+    for (; i < count; ++i) {
+        acc[i] += add[i] - (sub ? sub[i] : 0);
+        out[i] = div(acc[i]);
+    }
+}
+
+// Une passe horizontale sur une ligne : `pad` reçoit la ligne avec r pixels
+// de bord de chaque côté, puis la fenêtre glisse canal par canal
+void rowPass(uint8_t* row, int width, int channels, int r, Border border, std::vector<uint8_t>& pad) {
+    const Divider div(2 * r + 1);
+    const size_t C = channels;
+    pad.resize((width + 2 * static_cast<size_t>(r)) * C);
+    std::memcpy(pad.data() + r * C, row, width * C);
+    for (int x = -r; x < 0; ++x) {
+        const int a = borderIndex(x, width, border), b = borderIndex(width - 1 - x, width, border);
+        for (size_t c = 0; c < C; ++c) {
+            pad[(x + r) * C + c] = a < 0 ? 0 : row[a * C + c];
+            pad[(width - 1 - x + r) * C + c] = b < 0 ? 0 : row[b * C + c];
+        }
+    }
+    uint32_t acc[16];
+    for (size_t c0 = 0; c0 < C; c0 += 16) {
+        const size_t cn = std::min<size_t>(16, C - c0);
+        for (size_t c = 0; c < cn; ++c) {
+            acc[c] = 0;
+            for (int i = 0; i < 2 * r; ++i) acc[c] += pad[i * C + c0 + c];
+        }
+        const uint8_t* add = pad.data() + 2 * r * C + c0;
+        const uint8_t* sub = pad.data() + c0;
+        uint8_t* out = row + c0;
+        for (int x = 0; x < width; ++x, add += C, sub += C, out += C)
+            for (size_t c = 0; c < cn; ++c) {
+                acc[c] += add[c];
+                out[c] = div(acc[c]);
+                acc[c] -= sub[c];
+            }
+    }
+}
+
+// Une passe verticale sur les échantillons [s0, s1) de chaque ligne. Les lignes
+// sont réécrites en descendant : les valeurs d'origine encore utiles (fenêtre
+// [y - r - 1, y + r], y compris les reflets) sont gardées dans un anneau.
+void columnPass(const Surface& s, size_t s0, size_t s1, int r, Border border, std::vector<uint8_t>& ring,
+                std::vector<uint32_t>& acc, const std::vector<uint8_t>& zeros) {
+    const int H = s.height;
+    const size_t bw = s1 - s0;
+    const int R = std::min(2 * r + 2, H);
+    const Divider div(2 * r + 1);
+    ring.resize(static_cast<size_t>(R) * bw);
+    acc.assign(bw, 0);
+
+    int loaded = -1;
+    auto load = [&](int upto) {
+        for (upto = std::min(upto, H - 1); loaded < upto;) {
+            ++loaded;
+            std::memcpy(ring.data() + static_cast<size_t>(loaded % R) * bw, s.row(loaded) + s0, bw);
+        }
+    };
+    auto original = [&](int i) -> const uint8_t* {
+        const int m = borderIndex(i, H, border);
+        return m < 0 ? zeros.data() : ring.data() + static_cast<size_t>(m % R) * bw;
+    };
+
+    load(r);
+    for (int i = -r; i < r; ++i) {
+        const uint8_t* p = original(i);
+        for (size_t k = 0; k < bw; ++k) acc[k] += p[k];
+    }
+    for (int y = 0; y < H; ++y) {
+        load(y + r);
+        slide(acc.data(), original(y + r), y > 0 ? original(y - r - 1) : nullptr, s.row(y) + s0, bw, div);
+    }
+}
+
+} // namespace
+
+void boxBlurRows(const Surface& s, const int* radii, int passes, Border border) {
+    parallel::forRange(0, s.height, 16, [&](size_t first, size_t last) {
+        std::vector<uint8_t> pad;
+        for (size_t y = first; y < last; ++y)
+            for (int p = 0; p < passes; ++p)
+                if (radii[p] > 0) rowPass(s.row(static_cast<int>(y)), s.width, s.channels, radii[p], border, pad);
+    });
+}
+
+void boxBlurColumns(const Surface& s, const int* radii, int passes, Border border) {
+    // Blocs de colonnes : anneau et sommes d'un bloc restent en cache L1/L2
+    const size_t n = static_cast<size_t>(s.width) * s.channels;
+    const size_t block = 256;
+    parallel::forRange(0, (n + block - 1) / block, 1, [&](size_t first, size_t last) {
+        std::vector<uint8_t> ring;
+        std::vector<uint32_t> acc;
+        const std::vector<uint8_t> zeros(block, 0);
+        for (size_t b = first; b < last; ++b)
+            for (int p = 0; p < passes; ++p)
+                if (radii[p] > 0) columnPass(s, b * block, std::min(n, (b + 1) * block), radii[p], border, ring, acc, zeros);
+    });
+}
+
+// === RÉFÉRENCES ===
+void boxBlurRowsScalar(const Surface& s, const int* radii, int passes, Border border) {
+    std::vector<uint8_t> copy(static_cast<size_t>(s.width) * s.channels);
+    for (int y = 0; y < s.height; ++y) {
+        uint8_t* row = s.row(y);
+        for (int p = 0; p < passes; ++p) {
+            const int r = radii[p], n = 2 * r + 1;
+            if (r == 0) continue;
+            std::copy(row, row + copy.size(), copy.begin());
+            for (int x = 0; x < s.width; ++x)
+                for (int c = 0; c < s.channels; ++c) {
+                    uint32_t sum = 0;
+                    for (int i = x - r; i <= x + r; ++i) {
+                        const int xx = borderIndex(i, s.width, border);
+                        if (xx >= 0) sum += copy[static_cast<size_t>(xx) * s.channels + c];
+                    }
+                    row[static_cast<size_t>(x) * s.channels + c] = static_cast<uint8_t>((sum + n / 2) / n);
+                }
+        }
+    }
+}
+
+void boxBlurColumnsScalar(const Surface& s, const int* radii, int passes, Border border) {
+    std::vector<uint8_t> copy(s.height);
+    for (size_t k = 0; k < static_cast<size_t>(s.width) * s.channels; ++k) {
+        for (int p = 0; p < passes; ++p) {
+            const int r = radii[p], n = 2 * r + 1;
+            if (r == 0) continue;
+            for (int y = 0; y < s.height; ++y) copy[y] = s.row(y)[k];
+            for (int y = 0; y < s.height; ++y) {
+                uint32_t sum = 0;
+                for (int i = y - r; i <= y + r; ++i) {
+                    const int yy = borderIndex(i, s.height, border);
+                    if (yy >= 0) sum += copy[yy];
+                }
+                s.row(y)[k] = static_cast<uint8_t>((sum + n / 2) / n);
+            }
+        }
+    }
+}
+
+void gaussianBoxRadii(double sigma, int passes, int* radii) {
+    // Largeurs wl et wl + 2 (impaires) : m passes à wl, le reste à wl + 2, m
+    // choisi pour que la somme des variances (w² - 1) / 12 soit au plus près de sigma²
+    const double ideal = std::sqrt(12 * sigma * sigma / passes + 1);
+    int wl = static_cast<int>(std::floor(ideal));
+    if (wl % 2 == 0) --wl;
+    wl = std::max(wl, 1);
+    const double mIdeal = (12 * sigma * sigma - passes * wl * wl - 4.0 * passes * wl - 3.0 * passes) / (-4.0 * wl - 4);
+    const int m = static_cast<int>(std::lround(mIdeal));
+    for (int i = 0; i < passes; ++i) radii[i] = ((i < m ? wl : wl + 2) - 1) / 2;
+}
+
+} // namespace kernels
@@ -0,0 +1,270 @@
+#include "ImageKernels.h"
+#include "ImageSimd.h"
+#include <algorithm>
+
+namespace kernels {
+
+namespace {
+
+// Coefficients Q15 (somme 32768 pour Y, 0 pour Cb et Cr) et inverses Q14
+struct YuvCoeffs {
+    int16_t yr, yg, yb;
+    int16_t ur, ug, ub;
+    int16_t vr, vg, vb;
+    int16_t rv, gu, gv, bu;
+};
+
+const YuvCoeffs& coeffs(LumaStandard standard) {
+    static const YuvCoeffs bt601 = {9798, 19235, 3735,
+                                    -5529, -10855, 16384,
+                                    16384, -13720, -2664,
+                                    22970, -5638, -11700, 29032};
+    static const YuvCoeffs bt709 = {6966, 23436, 2366,
+                                    -3754, -12630, 16384,
+                                    16384, -14882, -1502,
+                                    25802, -3069, -7670, 30402};
+    return standard == LumaStandard::BT709 ? bt709 : bt601;
+}
+
+const int ROUND15 = 1 << 14;
+const int ROUND14 = 1 << 13;
+const int CHROMA15 = (128 << 15) + ROUND15;
+
+inline uint8_t clamp255(int v) { return static_cast<uint8_t>(v < 0 ? 0 : (v > 255 ? 255 : v)); }
+
+// Arrondi exact de x / 255 pour x dans [0, 65535]
+inline int div255(int x) { return (x + 128 + ((x + 128) >> 8)) >> 8; }
+
+#ifdef IMAGE_HAVE_SSE2
+// Charge 16 pixels RGB ou RGBA ; alpha = 255 pour les sources sans alpha
+template <int C>
+inline void loadRgb(const uint8_t* p, __m128i& r, __m128i& g, __m128i& b, __m128i& a) {
+    if (C == 4) simd::deinterleave4(p, r, g, b, a);
+    else { simd::deinterleave3(p, r, g, b); a = _mm_set1_epi8(-1); }
+}
+
+template <int C>
+inline void storeRgb(uint8_t* p, __m128i r, __m128i g, __m128i b) {
+    if (C == 4) simd::interleave4(p, r, g, b, _mm_set1_epi8(-1));
+    else simd::interleave3(p, r, g, b);
+}
+
+inline __m128i pair(int lo, int hi) {
+    return _mm_set1_epi32(static_cast<int>((static_cast<uint32_t>(static_cast<uint16_t>(hi)) << 16) |
+                                           static_cast<uint16_t>(lo)));
+}
+
+// Coefficients d'une combinaison c0*a + c1*b + c2*c + offset, décalée de `shift`
+struct Dot3 {
+    __m128i ab, c0, offset;
+    int shift;
+    Dot3(int k0, int k1, int k2, int off, int sh)
+        : ab(pair(k0, k1)), c0(pair(k2, 0)), offset(_mm_set1_epi32(off)), shift(sh) {}
+};
+
+// 8 entrées 16 bits signées -> 8 résultats 16 bits saturés (madd sur paires (a, b) et (c, 0))
+inline __m128i dot3x8(__m128i a, __m128i b, __m128i c, const Dot3& k) {
+    const __m128i zero = _mm_setzero_si128();
+    __m128i lo = _mm_add_epi32(_mm_madd_epi16(_mm_unpacklo_epi16(a, b), k.ab),
+                               _mm_madd_epi16(_mm_unpacklo_epi16(c, zero), k.c0));
+    __m128i hi = _mm_add_epi32(_mm_madd_epi16(_mm_unpackhi_epi16(a, b), k.ab),
+                               _mm_madd_epi16(_mm_unpackhi_epi16(c, zero), k.c0));
+    lo = _mm_srai_epi32(_mm_add_epi32(lo, k.offset), k.shift);
+    hi = _mm_srai_epi32(_mm_add_epi32(hi, k.offset), k.shift);
+    return _mm_packs_epi32(lo, hi);
+}
+
+// 16 pixels octets -> 16 résultats octets saturés sur [0, 255]
+inline __m128i dot3x16(__m128i a, __m128i b, __m128i c, const Dot3& k) {
+    const __m128i zero = _mm_setzero_si128();
+    __m128i lo = dot3x8(_mm_unpacklo_epi8(a, zero), _mm_unpacklo_epi8(b, zero), _mm_unpacklo_epi8(c, zero), k);
+    __m128i hi = dot3x8(_mm_unpackhi_epi8(a, zero), _mm_unpackhi_epi8(b, zero), _mm_unpackhi_epi8(c, zero), k);
+    return _mm_packus_epi16(lo, hi);
+}
+
+template <int SC, int DC>
+size_t rgbToGraySse2(const uint8_t* src, uint8_t* dst, size_t pixels, const YuvCoeffs& k) {
+    const Dot3 y(k.yr, k.yg, k.yb, ROUND15, 15);
+    size_t i = 0;
+    for (; i + 16 <= pixels; i += 16) {
+        __m128i r, g, b, a;
+        loadRgb<SC>(src + i * SC, r, g, b, a);
+        __m128i lum = dot3x16(r, g, b, y);
+        if (DC == 2) simd::interleave2(dst + i * 2, lum, a);
+        else simd::store(dst + i, lum);
+    }
+    return i;
+}
+
+template <int SC>
+size_t rgbToYuvSse2(const uint8_t* src, uint8_t* dst, size_t pixels, const YuvCoeffs& k) {
+    const Dot3 y(k.yr, k.yg, k.yb, ROUND15, 15);
+    const Dot3 u(k.ur, k.ug, k.ub, CHROMA15, 15);
+    const Dot3 v(k.vr, k.vg, k.vb, CHROMA15, 15);
+    size_t i = 0;
+    for (; i + 16 <= pixels; i += 16) {
+        __m128i r, g, b, a;
+        loadRgb<SC>(src + i * SC, r, g, b, a);
+        simd::interleave3(dst + i * 3, dot3x16(r, g, b, y), dot3x16(r, g, b, u), dot3x16(r, g, b, v));
+    }
+    return i;
+}
+
+template <int DC>
+size_t yuvToRgbSse2(const uint8_t* src, uint8_t* dst, size_t pixels, const YuvCoeffs& k) {
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i bias = _mm_set1_epi16(128);
+    const Dot3 r(16384, k.rv, 0, ROUND14, 14);    // (Y, V', -)
+    const Dot3 g(16384, k.gu, k.gv, ROUND14, 14); // (Y, U', V')
+    const Dot3 b(16384, k.bu, 0, ROUND14, 14);    // (Y, U', -)
+    size_t i = 0;
+    for (; i + 16 <= pixels; i += 16) {
+        __m128i y8, u8, v8;
+        simd::deinterleave3(src + i * 3, y8, u8, v8);
+        __m128i out[3];
+        for (int half = 0; half < 2; ++half) {
+            __m128i y = half ? _mm_unpackhi_epi8(y8, zero) : _mm_unpacklo_epi8(y8, zero);
+            __m128i u = _mm_sub_epi16(half ? _mm_unpackhi_epi8(u8, zero) : _mm_unpacklo_epi8(u8, zero), bias);
+            __m128i v = _mm_sub_epi16(half ? _mm_unpackhi_epi8(v8, zero) : _mm_unpacklo_epi8(v8, zero), bias);
+            __m128i rr = dot3x8(y, v, zero, r), gg = dot3x8(y, u, v, g), bb = dot3x8(y, u, zero, b);
+            out[0] = half ? _mm_packus_epi16(out[0], rr) : rr;
+            out[1] = half ? _mm_packus_epi16(out[1], gg) : gg;
+            out[2] = half ? _mm_packus_epi16(out[2], bb) : bb;
+        }
+        storeRgb<DC>(dst + i * DC, out[0], out[1], out[2]);
+    }
+    return i;
+}
+#endif
+
+// Tables HSV en Q12 : 255 / v pour la saturation, 256 / (6 d) pour la teinte
+struct HsvTables {
+    int sdiv[256];
+    int hdiv[256];
+    HsvTables() {
+        sdiv[0] = hdiv[0] = 0;
+        for (int i = 1; i < 256; ++i) {
+            sdiv[i] = ((255 << 12) + i / 2) / i;
+            hdiv[i] = ((256 << 12) + 3 * i) / (6 * i);
+        }
+    }
+};
+
+} // namespace
+
+// === LUMINANCE ===
+void rgbToGrayScalar(const uint8_t* src, int srcChannels, uint8_t* dst, int dstChannels,
+                     size_t pixels, LumaStandard standard) {
+    const YuvCoeffs& k = coeffs(standard);
+    for (size_t i = 0; i < pixels; ++i, src += srcChannels, dst += dstChannels) {
+        dst[0] = clamp255((k.yr * src[0] + k.yg * src[1] + k.yb * src[2] + ROUND15) >> 15);
+        if (dstChannels == 2) dst[1] = srcChannels == 4 ? src[3] : 255;
+    }
+}
+
+void rgbToGray(const uint8_t* src, int srcChannels, uint8_t* dst, int dstChannels,
+               size_t pixels, LumaStandard standard) {
+    size_t done = 0;
+#ifdef IMAGE_HAVE_SSE2
+    const YuvCoeffs& k = coeffs(standard);
+    if (srcChannels == 3) done = dstChannels == 2 ? rgbToGraySse2<3, 2>(src, dst, pixels, k)
+                                                  : rgbToGraySse2<3, 1>(src, dst, pixels, k);
+    else done = dstChannels == 2 ? rgbToGraySse2<4, 2>(src, dst, pixels, k)
+                                 : rgbToGraySse2<4, 1>(src, dst, pixels, k);
+#endif
+    rgbToGrayScalar(src + done * srcChannels, srcChannels, dst + done * dstChannels, dstChannels,
+                    pixels - done, standard);
+}
+
+// === YCbCr ===
+void rgbToYuvScalar(const uint8_t* src, int srcChannels, uint8_t* dst, size_t pixels, LumaStandard standard) {
+    const YuvCoeffs& k = coeffs(standard);
+    for (size_t i = 0; i < pixels; ++i, src += srcChannels, dst += 3) {
+        int r = src[0], g = src[1], b = src[2];
+        dst[0] = clamp255((k.yr * r + k.yg * g + k.yb * b + ROUND15) >> 15);
+        dst[1] = clamp255((k.ur * r + k.ug * g + k.ub * b + CHROMA15) >> 15);
+        dst[2] = clamp255((k.vr * r + k.vg * g + k.vb * b + CHROMA15) >> 15);
+    }
+}
+
+void rgbToYuv(const uint8_t* src, int srcChannels, uint8_t* dst, size_t pixels, LumaStandard standard) {
+    size_t done = 0;
+#ifdef IMAGE_HAVE_SSE2
+    const YuvCoeffs& k = coeffs(standard);
+    done = srcChannels == 4 ? rgbToYuvSse2<4>(src, dst, pixels, k) : rgbToYuvSse2<3>(src, dst, pixels, k);
+#endif
+    rgbToYuvScalar(src + done * srcChannels, srcChannels, dst + done * 3, pixels - done, standard);
+}
+
+void yuvToRgbScalar(const uint8_t* src, uint8_t* dst, int dstChannels, size_t pixels, LumaStandard standard) {
+    const YuvCoeffs& k = coeffs(standard);
+    for (size_t i = 0; i < pixels; ++i, src += 3, dst += dstChannels) {
+        int y = src[0] * 16384, u = src[1] - 128, v = src[2] - 128;
+        dst[0] = clamp255((y + k.rv * v + ROUND14) >> 14);
+        dst[1] = clamp255((y + k.gu * u + k.gv * v + ROUND14) >> 14);
+        dst[2] = clamp255((y + k.bu * u + ROUND14) >> 14);
+        if (dstChannels == 4) dst[3] = 255;
+    }
+}
+
+void yuvToRgb(const uint8_t* src, uint8_t* dst, int dstChannels, size_t pixels, LumaStandard standard) {
+    size_t done = 0;
+#ifdef IMAGE_HAVE_SSE2
+    const YuvCoeffs& k = coeffs(standard);
+    done = dstChannels == 4 ? yuvToRgbSse2<4>(src, dst, pixels, k) : yuvToRgbSse2<3>(src, dst, pixels, k);
+#endif
+    yuvToRgbScalar(src + done * 3, dst + done * dstChannels, dstChannels, pixels - done, standard);
+}
+
+// === HSV ===
+void rgbToHsv(const uint8_t* src, int srcChannels, uint8_t* dst, size_t pixels) {
+    static const HsvTables t;
+    for (size_t i = 0; i < pixels; ++i, src += srcChannels, dst += 3) {
+        int r = src[0], g = src[1], b = src[2];
+        int v = std::max(r, std::max(g, b));
+        int diff = v - std::min(r, std::min(g, b));
+        int num = v == r ? g - b : (v == g ? b - r + 2 * diff : r - g + 4 * diff);
+        int h = (num * t.hdiv[diff] + (1 << 11)) >> 12;
+        dst[0] = static_cast<uint8_t>(h < 0 ? h + 256 : h);
+        dst[1] = static_cast<uint8_t>((diff * t.sdiv[v] + (1 << 11)) >> 12);
+        dst[2] = static_cast<uint8_t>(v);
+    }
+}
+
+void hsvToRgb(const uint8_t* src, uint8_t* dst, int dstChannels, size_t pixels) {
+    for (size_t i = 0; i < pixels; ++i, src += 3, dst += dstChannels) {
+        int h6 = src[0] * 6, s = src[1], v = src[2];
+        int f = h6 & 255;
+        uint8_t p = static_cast<uint8_t>(div255(v * (255 - s)));
+        uint8_t q = static_cast<uint8_t>(div255(v * (255 - div255(s * f))));
+        uint8_t t = static_cast<uint8_t>(div255(v * (255 - div255(s * (255 - f)))));
+        uint8_t vv = static_cast<uint8_t>(v);
+        switch (h6 >> 8) {
+            case 0:  dst[0] = vv; dst[1] = t;  dst[2] = p;  break;
+            case 1:  dst[0] = q;  dst[1] = vv; dst[2] = p;  break;
+            case 2:  dst[0] = p;  dst[1] = vv; dst[2] = t;  break;
+            case 3:  dst[0] = p;  dst[1] = q;  dst[2] = vv; break;
+            case 4:  dst[0] = t;  dst[1] = p;  dst[2] = vv; break;
+            default: dst[0] = vv; dst[1] = p;  dst[2] = q;  break;
+        }
+        if (dstChannels == 4) dst[3] = 255;
+    }
+}
+
+// === RÉPLICATION / ALPHA ===
+void grayToRgb(const uint8_t* src, int srcChannels, uint8_t* dst, int dstChannels, size_t pixels) {
+    for (size_t i = 0; i < pixels; ++i, src += srcChannels, dst += dstChannels) {
+        dst[0] = dst[1] = dst[2] = src[0];
+        if (dstChannels == 4) dst[3] = srcChannels == 2 ? src[1] : 255;
+    }
+}
+
+void convertAlpha(const uint8_t* src, int srcChannels, uint8_t* dst, int dstChannels, size_t pixels) {
+    const int color = std::min(srcChannels, dstChannels);
+    for (size_t i = 0; i < pixels; ++i, src += srcChannels, dst += dstChannels) {
+        for (int c = 0; c < color; ++c) dst[c] = src[c];
+        if (dstChannels > srcChannels) dst[color] = 255;
+    }
+}
+
+} // namespace kernels
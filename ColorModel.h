@@ -0,0 +1,65 @@
+#ifndef COLOR_MODEL_H
+#define COLOR_MODEL_H
+
+#include <cstdint>
+#include <iostream>
+
+// Modèle colorimétrique d'une image : une simple étiquette d'un octet,
+// comparée en une instruction (plus de std::string copiée à chaque image).
+enum class ColorModel : uint8_t {
+    NONE,   // image vide / modèle inconnu
+    GRAY,   // luminance
+    GRAYA,  // luminance + alpha
+    RGB,
+    RGBA,
+    YUV,    // YCbCr pleine échelle (coefficients BT.601 ou BT.709)
+    HSV     // teinte sur 0..255, saturation, valeur
+};
+
+// Coefficients de luminance utilisés pour GRAY et YUV
+enum class LumaStandard : uint8_t {
+    BT601,  // 0.299 R + 0.587 G + 0.114 B (SD, JPEG)
+    BT709   // 0.2126 R + 0.7152 G + 0.0722 B (HD)
+};
+
+// Nombre de canaux attendu (0 pour NONE)
+inline int channelCount(ColorModel m) {
+    switch (m) {
+        case ColorModel::GRAY:  return 1;
+        case ColorModel::GRAYA: return 2;
+        case ColorModel::RGB:
+        case ColorModel::YUV:
+        case ColorModel::HSV:   return 3;
+        case ColorModel::RGBA:  return 4;
+        default:                return 0;
+    }
+}
+
+inline bool hasAlpha(ColorModel m) { return m == ColorModel::GRAYA || m == ColorModel::RGBA; }
+
+// Modèle par défaut pour un nombre de canaux (images chargées depuis un fichier)
+inline ColorModel defaultModel(int channels) {
+    switch (channels) {
+        case 1:  return ColorModel::GRAY;
+        case 2:  return ColorModel::GRAYA;
+        case 3:  return ColorModel::RGB;
+        case 4:  return ColorModel::RGBA;
+        default: return ColorModel::NONE;
+    }
+}
+
+inline const char* toString(ColorModel m) {
+    switch (m) {
+        case ColorModel::GRAY:  return "GRAY";
+        case ColorModel::GRAYA: return "GRAYA";
+        case ColorModel::RGB:   return "RGB";
+        case ColorModel::RGBA:  return "RGBA";
+        case ColorModel::YUV:   return "YUV";
+        case ColorModel::HSV:   return "HSV";
+        default:                return "NONE";
+    }
+}
+
+inline std::ostream& operator<<(std::ostream& os, ColorModel m) { return os << toString(m); }
+
+#endif
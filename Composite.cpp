@@ -0,0 +1,204 @@
+#include "ImageKernels.h"
+#include "ImageSimd.h"
+#include "Parallel.h"
+#include <cstring>
+
+namespace kernels {
+
+namespace {
+
+// Facteurs entiers de l'opérateur (255 = 1) : fs = s0 + s1·αd, fd = d0 + d1·αs
+struct Factors {
+    int s0, s1, d0, d1;
+};
+
+Factors factors(Composite op) {
+    switch (op) {
+        case Composite::Over:     return {255, 0, 255, -1};
+        case Composite::In:       return {0, 1, 0, 0};
+        case Composite::Out:      return {255, -1, 0, 0};
+        case Composite::Atop:     return {0, 1, 255, -1};
+        case Composite::Xor:      return {255, -1, 255, -1};
+        case Composite::DestOver: return {255, -1, 255, 0};
+        case Composite::DestIn:   return {0, 0, 0, 1};
+        case Composite::DestOut:  return {0, 0, 255, -1};
+        default:                  return {255, -1, 0, 1};  // DestAtop
+    }
+}
+
+// Pixels [from, to) d'une ligne ; sc, dc : canaux de src et dst (dc = sc - 1 : dst opaque)
+void blendRow(const uint8_t* s, uint8_t* d, int from, int to, int sc, int dc, const Factors& f) {
+    for (int x = from; x < to; ++x) {
+        const uint8_t* ps = s + static_cast<size_t>(x) * sc;
+        uint8_t* pd = d + static_cast<size_t>(x) * dc;
+        const int as = ps[sc - 1], ad = dc == sc ? pd[dc - 1] : 255;
+        // Poids des couleurs prémultipliées, sans arrondi intermédiaire
+        const int ws = (f.s0 + f.s1 * ad) * as, wd = (f.d0 + f.d1 * as) * ad;
+        const int D = ws + wd;
+        if (D)
+            for (int c = 0; c < sc - 1; ++c) pd[c] = static_cast<uint8_t>((ws * ps[c] + wd * pd[c] + D / 2) / D);
+        if (dc == sc) pd[dc - 1] = static_cast<uint8_t>((D + 127) / 255);
+    }
+}
+
+#ifdef IMAGE_HAVE_SSE2
+// === SSE2 ===
+// 4 pixels par itération, un pixel par voie 32 bits (canal k à l'octet k),
+// calcul en float sur des entiers exacts (< 2^24)
+
+// Chargement de 4 pixels de C canaux, sans lire au-delà du 4e
+template <int C>
+inline __m128i loadPixels(const uint8_t* p) {
+    const __m128i zero = _mm_setzero_si128();
+    if constexpr (C == 4) {
+        return simd::load(p);
+    } else if constexpr (C == 3) {
+        int32_t tail;
+        std::memcpy(&tail, p + 8, 4);
+        const __m128i v = _mm_unpacklo_epi64(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(p)),
+                                             _mm_cvtsi32_si128(tail));
+        const __m128i p01 = _mm_unpacklo_epi32(v, _mm_srli_si128(v, 3));
+        const __m128i p23 = _mm_unpacklo_epi32(_mm_srli_si128(v, 6), _mm_srli_si128(v, 9));
+        return _mm_unpacklo_epi64(p01, p23);
+    } else if constexpr (C == 2) {
+        return _mm_unpacklo_epi16(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(p)), zero);
+    } else {
+        int32_t v;
+        std::memcpy(&v, p, 4);
+        return _mm_unpacklo_epi16(_mm_unpacklo_epi8(_mm_cvtsi32_si128(v), zero), zero);
+    }
+}
+
+// Écriture des C premiers octets de chaque voie
+template <int C>
+inline void storePixels(uint8_t* p, __m128i v) {
+    if constexpr (C == 4) {
+        simd::store(p, v);
+    } else if constexpr (C == 3) {
+        // Voie i décalée de i octets vers le bas : pixel i à l'octet 3i
+        const __m128i low = _mm_set_epi32(0, 0, 0, 0xFFFFFF);
+        const __m128i r = _mm_or_si128(
+            _mm_or_si128(_mm_and_si128(v, low), _mm_srli_si128(_mm_and_si128(v, _mm_slli_si128(low, 4)), 1)),
+            _mm_or_si128(_mm_srli_si128(_mm_and_si128(v, _mm_slli_si128(low, 8)), 2),
+                         _mm_srli_si128(_mm_and_si128(v, _mm_slli_si128(low, 12)), 3)));
+        _mm_storel_epi64(reinterpret_cast<__m128i*>(p), r);
+        const int32_t tail = _mm_cvtsi128_si32(_mm_srli_si128(r, 8));
+        std::memcpy(p + 8, &tail, 4);
+    } else if constexpr (C == 2) {
+        // Voies ramenées en int16 signé (même motif binaire) pour packs_epi32
+        const __m128i w = _mm_srai_epi32(_mm_slli_epi32(v, 16), 16);
+        _mm_storel_epi64(reinterpret_cast<__m128i*>(p), _mm_packs_epi32(w, w));
+    } else {
+        const __m128i w = _mm_and_si128(v, _mm_set1_epi32(0xFF));
+        const __m128i b = _mm_packus_epi16(_mm_packs_epi32(w, w), w);
+        const int32_t out = _mm_cvtsi128_si32(b);
+        std::memcpy(p, &out, 4);
+    }
+}
+
+inline __m128 channel(__m128i v, int k) {
+    return _mm_cvtepi32_ps(_mm_and_si128(_mm_srli_epi32(v, 8 * k), _mm_set1_epi32(0xFF)));
+}
+
+// floor(n / d) exact pour des entiers 0 <= n < 2^24, 1 <= d <= 65025 et un
+// quotient <= 255 : n · (1 / d) juste à 1 près, corrigé par le reste (q·d <
+// 2^24, exact en float). Une seule division par pixel pour tous les canaux.
+inline __m128 divFloor(__m128 n, __m128 d, __m128 inverse) {
+    const __m128 one = _mm_set1_ps(1.0f);
+    __m128 q = _mm_cvtepi32_ps(_mm_cvttps_epi32(_mm_mul_ps(n, inverse)));
+    const __m128 r = _mm_sub_ps(n, _mm_mul_ps(q, d));
+    q = _mm_sub_ps(q, _mm_and_ps(_mm_cmplt_ps(r, _mm_setzero_ps()), one));
+    return _mm_add_ps(q, _mm_and_ps(_mm_cmpge_ps(r, d), one));
+}
+
+// floor(n / 255) pour un entier 0 <= n < 2^16 : erreur de n · (1 / 255) < 2^-15,
+// écart à l'entier suivant >= 1 / 255, d'où le biais de 2^-10
+inline __m128i div255(__m128 n) {
+    return _mm_cvttps_epi32(_mm_add_ps(_mm_mul_ps(n, _mm_set1_ps(1.0f / 255)), _mm_set1_ps(1.0f / 1024)));
+}
+
+// Pixels traités : multiple de 4, le reste est laissé à blendRow
+template <int SC, int DC>
+int blendRowSse2(const uint8_t* s, uint8_t* d, int width, const Factors& f, bool over) {
+    const __m128 s0 = _mm_set1_ps(static_cast<float>(f.s0)), s1 = _mm_set1_ps(static_cast<float>(f.s1));
+    const __m128 d0 = _mm_set1_ps(static_cast<float>(f.d0)), d1 = _mm_set1_ps(static_cast<float>(f.d1));
+    const __m128 half = _mm_set1_ps(0.5f), one = _mm_set1_ps(1.0f);
+    const __m128i opaque = _mm_set1_epi32(0xFF);
+    int x = 0;
+    for (; x + 4 <= width; x += 4) {
+        const __m128i vs = loadPixels<SC>(s + x * SC);
+        if (over) {
+            // Source entièrement opaque : copie ; transparente : dst inchangé
+            const __m128i alpha = _mm_and_si128(_mm_srli_epi32(vs, 8 * (SC - 1)), opaque);
+            if (_mm_movemask_epi8(_mm_cmpeq_epi32(alpha, opaque)) == 0xFFFF) {
+                storePixels<DC>(d + x * DC, vs);
+                continue;
+            }
+            if (_mm_movemask_epi8(_mm_cmpeq_epi32(alpha, _mm_setzero_si128())) == 0xFFFF) continue;
+        }
+        const __m128i vd = loadPixels<DC>(d + x * DC);
+        const __m128 as = channel(vs, SC - 1);
+        const __m128 ad = DC == SC ? channel(vd, DC - 1) : _mm_set1_ps(255.0f);
+        __m128i out = _mm_setzero_si128();
+        if (over && (DC < SC || _mm_movemask_ps(_mm_cmpeq_ps(ad, _mm_set1_ps(255.0f))) == 0xF)) {
+            // dst opaque : D = 255², couleur = (αs·cs + (255 - αs)·cd + 127) / 255
+            const __m128 rest = _mm_sub_ps(_mm_set1_ps(255.0f), as);
+            for (int c = 0; c < SC - 1; ++c) {
+                const __m128 n = _mm_add_ps(_mm_mul_ps(as, channel(vs, c)), _mm_mul_ps(rest, channel(vd, c)));
+                out = _mm_or_si128(out, _mm_slli_epi32(div255(_mm_add_ps(n, _mm_set1_ps(127.0f))), 8 * c));
+            }
+            if constexpr (DC == SC) out = _mm_or_si128(out, _mm_slli_epi32(opaque, 8 * (DC - 1)));
+            storePixels<DC>(d + x * DC, out);
+            continue;
+        }
+        const __m128 ws = _mm_mul_ps(_mm_add_ps(s0, _mm_mul_ps(s1, ad)), as);
+        const __m128 wd = _mm_mul_ps(_mm_add_ps(d0, _mm_mul_ps(d1, as)), ad);
+        const __m128 D = _mm_add_ps(ws, wd);
+        const __m128 rounding = _mm_cvtepi32_ps(_mm_cvttps_epi32(_mm_mul_ps(D, half)));  // D / 2
+        // D = 0 : numérateur cd (ws = wd = 0) sur 1, couleur de dst conservée
+        const __m128 empty = _mm_cmpeq_ps(D, _mm_setzero_ps());
+        const __m128 divisor = _mm_max_ps(D, one), inverse = _mm_div_ps(one, divisor);
+        for (int c = 0; c < SC - 1; ++c) {
+            const __m128 cd = channel(vd, c);
+            const __m128 n = _mm_add_ps(_mm_add_ps(_mm_mul_ps(ws, channel(vs, c)), _mm_mul_ps(wd, cd)),
+                                        _mm_add_ps(rounding, _mm_and_ps(empty, cd)));
+            out = _mm_or_si128(out, _mm_slli_epi32(_mm_cvttps_epi32(divFloor(n, divisor, inverse)), 8 * c));
+        }
+        if constexpr (DC == SC) {
+            const __m128i a = div255(_mm_add_ps(D, _mm_set1_ps(127.0f)));
+            out = _mm_or_si128(out, _mm_slli_epi32(a, 8 * (DC - 1)));
+        }
+        storePixels<DC>(d + x * DC, out);
+    }
+    return x;
+}
+#endif
+
+} // namespace
+
+void composite(const ConstSurface& src, const Surface& dst, Composite op) {
+    const Factors f = factors(op);
+    const int sc = src.channels, dc = dst.channels;
+    parallel::forRange(0, dst.height, 64, [&](size_t first, size_t last) {
+        for (size_t y = first; y < last; ++y) {
+            const uint8_t* s = src.row(static_cast<int>(y));
+            uint8_t* d = dst.row(static_cast<int>(y));
+            int x = 0;
+#ifdef IMAGE_HAVE_SSE2
+            const bool over = op == Composite::Over;
+            if (sc == 4 && dc == 4) x = blendRowSse2<4, 4>(s, d, dst.width, f, over);
+            else if (sc == 4 && dc == 3) x = blendRowSse2<4, 3>(s, d, dst.width, f, over);
+            else if (sc == 2 && dc == 2) x = blendRowSse2<2, 2>(s, d, dst.width, f, over);
+            else if (sc == 2 && dc == 1) x = blendRowSse2<2, 1>(s, d, dst.width, f, over);
+#endif
+            blendRow(s, d, x, dst.width, sc, dc, f);
+        }
+    });
+}
+
+void compositeScalar(const ConstSurface& src, const Surface& dst, Composite op) {
+    const Factors f = factors(op);
+    for (int y = 0; y < dst.height; ++y) blendRow(src.row(y), dst.row(y), 0, dst.width, src.channels, dst.channels, f);
+}
+
+} // namespace kernels
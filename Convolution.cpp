@@ -0,0 +1,341 @@
+#include "ImageKernels.h"
+#include "ImageSimd.h"
+#include "Parallel.h"
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include <vector>
+
+namespace kernels {
+
+int borderIndex(int i, int n, Border border) {
+    if (i >= 0 && i < n) return i;
+    switch (border) {
+        case Border::Zero:      return -1;
+        case Border::Replicate: return i < 0 ? 0 : n - 1;
+        case Border::Reflect:
+            if (n == 1) return 0;
+            while (i < 0 || i >= n) i = i < 0 ? -i : 2 * (n - 1) - i;
+            return i;
+    }
+    return -1;
+}
+
+void padRow(const uint8_t* src, int width, int channels, int r, Border border, uint8_t* out) {
+    const size_t C = channels;
+    std::copy(src, src + static_cast<size_t>(width) * C, out + r * C);
+    for (int x = -r; x < 0; ++x) {
+        const int a = borderIndex(x, width, border), b = borderIndex(width - 1 - x, width, border);
+        for (size_t c = 0; c < C; ++c) {
+            out[(x + r) * C + c] = a < 0 ? 0 : src[a * C + c];
+            out[(width - 1 - x + r) * C + c] = b < 0 ? 0 : src[b * C + c];
+        }
+    }
+}
+
+namespace {
+
+constexpr int64_t accLimit = int64_t(1) << 31;
+
+// Poids d'une passe en virgule fixe : w[i] ≈ weights[i] * 2^shift. On prend le
+// plus grand shift tel que |w[i]| <= 32767 (pmaddwd) et que la somme des
+// produits, biais d'arrondi de 2^(shift + extra - 1) compris, tienne dans un
+// int32 pour des entrées bornées par inputMax. L'écart d'arrondi de la somme
+// des poids est reporté sur le plus grand : une zone uniforme reste uniforme.
+struct Taps {
+    std::vector<int16_t> w;
+    int shift = 0;
+};
+
+bool quantizeAt(const float* weights, size_t n, int64_t inputMax, int shift, int extra, Taps& t) {
+    const double scale = std::ldexp(1.0, shift);
+    t.w.assign(n, 0);
+    t.shift = shift;
+    double sum = 0;
+    int64_t qsum = 0;
+    size_t big = 0;
+    for (size_t i = 0; i < n; ++i) {
+        const double q = std::round(weights[i] * scale);
+        if (std::fabs(q) > 32767) return false;
+        t.w[i] = static_cast<int16_t>(q);
+        sum += weights[i];
+        qsum += t.w[i];
+        if (std::fabs(weights[i]) > std::fabs(weights[big])) big = i;
+    }
+    const int64_t fixed = t.w[big] + (static_cast<int64_t>(std::llround(sum * scale)) - qsum);
+    if (fixed < -32767 || fixed > 32767) return false;
+    t.w[big] = static_cast<int16_t>(fixed);
+    int64_t sumAbs = 0;
+    for (int16_t w : t.w) sumAbs += w < 0 ? -w : w;
+    return sumAbs * inputMax + (int64_t(1) << (shift + extra)) < accLimit;
+}
+
+bool quantize(const float* weights, size_t n, int64_t inputMax, int extra, Taps& t) {
+    for (int shift = 30 - extra; shift >= 0; --shift)
+        if (quantizeAt(weights, n, inputMax, shift, extra, t)) return true;
+    return false;
+}
+
+int64_t sumAbs(const Taps& t) {
+    int64_t s = 0;
+    for (int16_t w : t.w) s += w < 0 ? -w : w;
+    return s;
+}
+
+inline int32_t roundShift(int32_t acc, int shift) { return shift ? (acc + (1 << (shift - 1))) >> shift : acc; }
+
+// Séparable : passe horizontale vers un intermédiaire int16 à `fraction` bits
+// fractionnaires, puis passe verticale et arrondi final de v.shift + fraction bits
+struct SeparablePlan {
+    Taps h;
+    Taps v;
+    int fraction = 0;
+    int hShift() const { return h.shift - fraction; }
+    int vShift() const { return v.shift + fraction; }
+};
+
+bool planSeparable(const float* h, int hw, const float* v, int vh, SeparablePlan& p) {
+    if (!quantize(h, hw, 255, 0, p.h)) return false;
+    const int64_t hsum = sumAbs(p.h) * 255;
+    // Plus grande précision (<= 7 bits) où l'intermédiaire tient sur 16 bits
+    int64_t bound = 0;
+    for (p.fraction = std::min(7, p.h.shift); p.fraction >= 0; --p.fraction) {
+        const int k = p.hShift();
+        bound = (hsum + (k ? int64_t(1) << (k - 1) : 0)) >> k;
+        if (bound <= 32767) break;
+    }
+    if (p.fraction < 0) return false;
+    return quantize(v, vh, std::max<int64_t>(bound, 1), p.fraction, p.v);
+}
+
+SeparablePlan separablePlan(const float* h, int hw, const float* v, int vh) {
+    SeparablePlan p;
+    if (!planSeparable(h, hw, v, vh, p))
+        throw std::invalid_argument("Convolution weights too large for 8-bit fixed point");
+    return p;
+}
+
+// Poids non nuls du noyau 2D, en ligne
+struct Taps2D {
+    Taps taps;
+    std::vector<int> dx;
+    std::vector<int> dy;
+};
+
+Taps2D taps2D(const Kernel& k) {
+    Taps all;
+    const size_t n = static_cast<size_t>(k.getWidth()) * k.getHeight();
+    if (!quantize(k.getWeights().data(), n, 255, 0, all))
+        throw std::invalid_argument("Convolution weights too large for 8-bit fixed point");
+    Taps2D t;
+    t.taps.shift = all.shift;
+    for (size_t i = 0; i < n; ++i) {
+        if (all.w[i] == 0) continue;
+        t.taps.w.push_back(all.w[i]);
+        t.dx.push_back(static_cast<int>(i % k.getWidth()));
+        t.dy.push_back(static_cast<int>(i / k.getWidth()));
+    }
+    return t;
+}
+
+template <typename Out> inline Out saturate(int32_t v);
+template <> inline int16_t saturate<int16_t>(int32_t v) { return static_cast<int16_t>(std::clamp(v, -32768, 32767)); }
+template <> inline uint8_t saturate<uint8_t>(int32_t v) { return static_cast<uint8_t>(std::clamp(v, 0, 255)); }
+
+#ifdef IMAGE_HAVE_SSE2
+inline __m128i pairWeights(int16_t a, int16_t b) {
+    return _mm_set1_epi32(static_cast<int32_t>(uint32_t(uint16_t(a)) | uint32_t(uint16_t(b)) << 16));
+}
+
+inline __m128i loadI16(const int16_t* p) { return _mm_loadu_si128(reinterpret_cast<const __m128i*>(p)); }
+#endif
+
+// out[s] = saturate(arrondi(Σ_k w[k] * rows[k][s]) >> shift), s dans [0, n).
+// Cœur commun des passes horizontale (rows[k] = ligne décalée de k pixels),
+// verticale et 2D. SSE2 : 8 échantillons à la fois, taps appariés pour pmaddwd.
+template <typename Out>
+void accumulate(const int16_t* const* rows, const int16_t* w, size_t taps, int shift, Out* out, size_t n) {
+    size_t s = 0;
+#ifdef IMAGE_HAVE_SSE2
+    const __m128i bias = _mm_set1_epi32(shift ? 1 << (shift - 1) : 0);
+    const __m128i count = _mm_cvtsi32_si128(shift);
+    const __m128i zero = _mm_setzero_si128();
+    for (; s + 8 <= n; s += 8) {
+        __m128i lo = bias, hi = bias;
+        size_t k = 0;
+        for (; k + 2 <= taps; k += 2) {
+            const __m128i a = loadI16(rows[k] + s), b = loadI16(rows[k + 1] + s);
+            const __m128i pair = pairWeights(w[k], w[k + 1]);
+            lo = _mm_add_epi32(lo, _mm_madd_epi16(_mm_unpacklo_epi16(a, b), pair));
+            hi = _mm_add_epi32(hi, _mm_madd_epi16(_mm_unpackhi_epi16(a, b), pair));
+        }
+        if (k < taps) {
+            const __m128i a = loadI16(rows[k] + s);
+            const __m128i pair = pairWeights(w[k], 0);
+            lo = _mm_add_epi32(lo, _mm_madd_epi16(_mm_unpacklo_epi16(a, zero), pair));
+            hi = _mm_add_epi32(hi, _mm_madd_epi16(_mm_unpackhi_epi16(a, zero), pair));
+        }
+        const __m128i packed = _mm_packs_epi32(_mm_sra_epi32(lo, count), _mm_sra_epi32(hi, count));
+        if constexpr (sizeof(Out) == 2)
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(out + s), packed);
+        else
+            _mm_storel_epi64(reinterpret_cast<__m128i*>(out + s), _mm_packus_epi16(packed, packed));
+    }
+#endif
+    for (; s < n; ++s) {
+        int32_t acc = shift ? 1 << (shift - 1) : 0;
+        for (size_t k = 0; k < taps; ++k) acc += w[k] * rows[k][s];
+        out[s] = saturate<Out>(acc >> shift);
+    }
+}
+
+// Ligne élargie en int16 avec r pixels de bord de chaque côté
+void padRow(const uint8_t* src, int width, int channels, int r, Border border, int16_t* out) {
+    const size_t n = static_cast<size_t>(width) * channels;
+    int16_t* mid = out + static_cast<size_t>(r) * channels;
+    for (size_t i = 0; i < n; ++i) mid[i] = src[i];
+    for (int x = -r; x < 0; ++x) {
+        const int xx = borderIndex(x, width, border);
+        for (int c = 0; c < channels; ++c) mid[x * channels + c] = xx < 0 ? 0 : src[xx * channels + c];
+    }
+    for (int x = width; x < width + r; ++x) {
+        const int xx = borderIndex(x, width, border);
+        for (int c = 0; c < channels; ++c) mid[x * channels + c] = xx < 0 ? 0 : src[xx * channels + c];
+    }
+}
+
+// Bande de lignes traitée d'un bloc : intermédiaires de quelques centaines de
+// Ko (cache L2), au moins 8 lignes et 2 rayons pour amortir les lignes de bord
+int stripRows(size_t rowSamples, int radius) {
+    const size_t budget = (size_t(256) << 10) / (2 * std::max<size_t>(rowSamples, 1));
+    return static_cast<int>(std::max<size_t>({budget, 8, 2 * static_cast<size_t>(radius)}));
+}
+
+} // namespace
+
+// === SÉPARABLE ===
+bool separableFits(const float* h, int hw) {
+    const float one = 1.0f;
+    SeparablePlan p;
+    return planSeparable(h, hw, &one, 1, p);
+}
+
+void convolveSeparable(const ConstSurface& src, const Surface& dst, const float* h, int hw,
+                       const float* v, int vh, Border border) {
+    const SeparablePlan p = separablePlan(h, hw, v, vh);
+    const int W = src.width, H = src.height, C = src.channels;
+    const int hr = hw / 2, vr = vh / 2;
+    const size_t n = static_cast<size_t>(W) * C;
+    const int strip = stripRows(n, vr);
+    const std::vector<int16_t> zero(n, 0);
+
+    parallel::forRange(0, (H + strip - 1) / strip, 1, [&](size_t first, size_t last) {
+        std::vector<int16_t> pad(static_cast<size_t>(W + 2 * hr) * C);
+        std::vector<int16_t> temp;
+        std::vector<const int16_t*> rows(std::max(hw, vh));
+        std::vector<const int16_t*> trow;
+        for (size_t b = first; b < last; ++b) {
+            const int y0 = static_cast<int>(b) * strip, y1 = std::min(H, y0 + strip);
+            const int count = y1 - y0 + 2 * vr;
+            temp.resize(static_cast<size_t>(count) * n);
+            trow.assign(count, zero.data());
+            for (int r = 0; r < count; ++r) {
+                const int yy = borderIndex(y0 - vr + r, H, border);
+                if (yy < 0) continue;
+                padRow(src.row(yy), W, C, hr, border, pad.data());
+                for (int k = 0; k < hw; ++k) rows[k] = pad.data() + static_cast<size_t>(k) * C;
+                int16_t* out = temp.data() + static_cast<size_t>(r) * n;
+                accumulate(rows.data(), p.h.w.data(), hw, p.hShift(), out, n);
+                trow[r] = out;
+            }
+            for (int y = y0; y < y1; ++y)
+                accumulate(trow.data() + (y - y0), p.v.w.data(), vh, p.vShift(), dst.row(y), n);
+        }
+    });
+}
+
+void convolveSeparableScalar(const ConstSurface& src, const Surface& dst, const float* h, int hw,
+                             const float* v, int vh, Border border) {
+    const SeparablePlan p = separablePlan(h, hw, v, vh);
+    const int W = src.width, H = src.height, C = src.channels;
+    const int hr = hw / 2, vr = vh / 2;
+    for (int y = 0; y < H; ++y) {
+        for (int x = 0; x < W; ++x) {
+            for (int c = 0; c < C; ++c) {
+                int32_t accV = p.vShift() ? 1 << (p.vShift() - 1) : 0;
+                for (int j = 0; j < vh; ++j) {
+                    const int yy = borderIndex(y + j - vr, H, border);
+                    if (yy < 0) continue;
+                    int32_t accH = 0;
+                    for (int i = 0; i < hw; ++i) {
+                        const int xx = borderIndex(x + i - hr, W, border);
+                        if (xx >= 0) accH += p.h.w[i] * src.row(yy)[xx * C + c];
+                    }
+                    accV += p.v.w[j] * saturate<int16_t>(roundShift(accH, p.hShift()));
+                }
+                dst.row(y)[x * C + c] = saturate<uint8_t>(accV >> p.vShift());
+            }
+        }
+    }
+}
+
+// === 2D ===
+void convolve2D(const ConstSurface& src, const Surface& dst, const Kernel& kernel, Border border) {
+    const Taps2D t = taps2D(kernel);
+    const int W = src.width, H = src.height, C = src.channels;
+    const int rx = kernel.getWidth() / 2, ry = kernel.getHeight() / 2;
+    const size_t n = static_cast<size_t>(W) * C;
+    const size_t padded = static_cast<size_t>(W + 2 * rx) * C;
+    const int strip = stripRows(padded, ry);
+    const std::vector<int16_t> zero(padded, 0);
+
+    parallel::forRange(0, (H + strip - 1) / strip, 1, [&](size_t first, size_t last) {
+        std::vector<int16_t> pad;
+        std::vector<const int16_t*> prow;
+        std::vector<const int16_t*> rows(t.taps.w.size());
+        for (size_t b = first; b < last; ++b) {
+            const int y0 = static_cast<int>(b) * strip, y1 = std::min(H, y0 + strip);
+            const int count = y1 - y0 + 2 * ry;
+            pad.resize(static_cast<size_t>(count) * padded);
+            prow.assign(count, zero.data());
+            for (int r = 0; r < count; ++r) {
+                const int yy = borderIndex(y0 - ry + r, H, border);
+                if (yy < 0) continue;
+                int16_t* out = pad.data() + static_cast<size_t>(r) * padded;
+                padRow(src.row(yy), W, C, rx, border, out);
+                prow[r] = out;
+            }
+            for (int y = y0; y < y1; ++y) {
+                for (size_t k = 0; k < rows.size(); ++k)
+                    rows[k] = prow[y - y0 + t.dy[k]] + static_cast<size_t>(t.dx[k]) * C;
+                accumulate(rows.data(), t.taps.w.data(), rows.size(), t.taps.shift, dst.row(y), n);
+            }
+        }
+    });
+}
+
+void convolve2DScalar(const ConstSurface& src, const Surface& dst, const Kernel& kernel, Border border) {
+    Taps t;
+    const int kw = kernel.getWidth(), kh = kernel.getHeight();
+    if (!quantize(kernel.getWeights().data(), static_cast<size_t>(kw) * kh, 255, 0, t))
+        throw std::invalid_argument("Convolution weights too large for 8-bit fixed point");
+    const int W = src.width, H = src.height, C = src.channels;
+    for (int y = 0; y < H; ++y) {
+        for (int x = 0; x < W; ++x) {
+            for (int c = 0; c < C; ++c) {
+                int32_t acc = t.shift ? 1 << (t.shift - 1) : 0;
+                for (int j = 0; j < kh; ++j) {
+                    const int yy = borderIndex(y + j - kh / 2, H, border);
+                    if (yy < 0) continue;
+                    for (int i = 0; i < kw; ++i) {
+                        const int xx = borderIndex(x + i - kw / 2, W, border);
+                        if (xx >= 0) acc += t.w[static_cast<size_t>(j) * kw + i] * src.row(yy)[xx * C + c];
+                    }
+                }
+                dst.row(y)[x * C + c] = saturate<uint8_t>(acc >> t.shift);
+            }
+        }
+    }
+}
+
+} // namespace kernels
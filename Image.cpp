@@ -1,35 +1,89 @@
 #include "Image.h"
+#include "ImageKernels.h"
+#include "Instrumentation.h"
+#include "Trace.h"
 #include <algorithm>
 #include <cmath>
 #include <cassert>
+#include <climits>
+#include <cstdio>
+#include <cstring>
 
-#define STB_IMAGE_IMPLEMENTATION
+// Implémentations compilées à part : _tparty/stb_impl.cpp
 #include "_tparty/stb_image.h"
-
-#define STB_IMAGE_WRITE_IMPLEMENTATION
 #include "_tparty/stb_image_write.h"
 
 size_t Image::index(int x, int y, int c) const {
     if (x < 0 || x >= width || y < 0 || y >= height || c < 0 || c >= channels)
         throw std::out_of_range("Pixel coordinates out of bounds");
+    if (layout == Layout::Planar)
+        return (static_cast<size_t>(c) * height + y) * width + x;
     return static_cast<size_t>(y) * width * channels + x * channels + c;
 }
 
+void Image::checkCompatible(const Image& other) const {
+    if (channels != other.channels || model != other.model)
+        throw std::invalid_argument("Incompatible channels or model");
+}
+
 void Image::enlargeTo(int newWidth, int newHeight) {
     if (newWidth <= width && newHeight <= height) return;
 
-    Image temp(newWidth, newHeight, channels, model);
-    for (int y = 0; y < height; ++y) {
-        for (int x = 0; x < width; ++x) {
-            for (int c = 0; c < channels; ++c) {
-                temp(x, y, c) = (*this)(x, y, c);
-            }
-        }
+    IMAGE_INSTR_SCOPE(Enlarge, data.size());
+    IMAGE_TRACE_SCOPE("enlarge", width, height, channels);
+    newWidth = std::max(newWidth, width);
+    newHeight = std::max(newHeight, height);
+    Image temp(newWidth, newHeight, channels, model, uint8_t(0), layout);
+    if (layout == Layout::Planar) {
+        for (int c = 0; c < channels; ++c)
+            for (int y = 0; y < height; ++y)
+                std::copy_n(plane(c) + static_cast<size_t>(y) * width, width,
+                            temp.plane(c) + static_cast<size_t>(y) * newWidth);
+    } else {
+        const size_t row = static_cast<size_t>(width) * channels;
+        for (int y = 0; y < height; ++y)
+            std::copy_n(data.data() + y * row, row, temp.data.data() + static_cast<size_t>(y) * newWidth * channels);
     }
 
+    IMAGE_INSTR_COPY(data.size());
     *this = std::move(temp);
 }
 
+const uint8_t* Image::alignWith(const Image& other, Image& scratch) {
+    checkCompatible(other);
+    int nw = std::max(width, other.width);
+    int nh = std::max(height, other.height);
+    enlargeTo(nw, nh);
+    if (other.width == nw && other.height == nh && other.layout == layout)
+        return other.data.data();
+    if (other.layout == layout) {
+        scratch = other;
+        IMAGE_INSTR_DUP(other.data.size());
+    } else {
+        scratch = other.toLayout(layout);
+    }
+    scratch.enlargeTo(nw, nh);
+    return scratch.data.data();
+}
+
+namespace {
+// Applique op(valeur, pixel[c]) à chaque canal : plan par plan si planaire
+template <typename Op>
+void applyPixel(uint8_t* data, size_t pixels, int channels, Layout layout,
+                const std::vector<uint8_t>& pixel, Op op) {
+    if (layout == Layout::Planar) {
+        for (int c = 0; c < channels; ++c) {
+            uint8_t* p = data + c * pixels;
+            const int v = pixel[c];
+            for (size_t i = 0; i < pixels; ++i) p[i] = op(p[i], v);
+        }
+    } else {
+        for (size_t i = 0; i < pixels; ++i, data += channels)
+            for (int c = 0; c < channels; ++c) data[c] = op(data[c], pixel[c]);
+    }
+}
+} // namespace
+
 
 uint8_t Image::clampAdd(int a, int b) {
     int res = a + b;
@@ -59,23 +113,66 @@ uint8_t Image::clampDiv(int a, double b) {
 // Constructeurs (déjà dans .h, corps ici si besoin)
 Image::Image() = default;
 
-Image::Image(int w, int h, int c, const std::string& m, uint8_t fill_value)
-    : width(w), height(h), channels(c), model(m) {
+Image::Image(int w, int h, int c, ColorModel m, uint8_t fill_value, Layout l)
+    : width(w), height(h), channels(c), model(m), layout(l) {
     if (w < 0 || h < 0 || c <= 0) throw std::invalid_argument("Invalid dimensions");
+    if (m != ColorModel::NONE && channelCount(m) != c)
+        throw std::invalid_argument("Channel count does not match model");
     data.assign(static_cast<size_t>(w) * h * c, fill_value);
+    IMAGE_INSTR_ALLOC(data.size());
 }
 
-Image::Image(int w, int h, int c, const std::string& m, const uint8_t* buffer)
-    : width(w), height(h), channels(c), model(m) {
+Image::Image(int w, int h, int c, ColorModel m, const uint8_t* buffer, Layout l)
+    : width(w), height(h), channels(c), model(m), layout(l) {
     if (w < 0 || h < 0 || c <= 0) throw std::invalid_argument("Invalid dimensions");
+    if (m != ColorModel::NONE && channelCount(m) != c)
+        throw std::invalid_argument("Channel count does not match model");
     data.assign(buffer, buffer + static_cast<size_t>(w) * h * c);
+    IMAGE_INSTR_DUP(data.size());
+}
+
+Image::Image(const Mask& mask, uint8_t on, uint8_t off)
+    : width(mask.getWidth()), height(mask.getHeight()), channels(1), model(ColorModel::GRAY) {
+    IMAGE_INSTR_SCOPE(FromMask, static_cast<size_t>(mask.getWordsPerRow()) * height * sizeof(uint64_t));
+    IMAGE_TRACE_SCOPE("from_mask", width, height, 1);
+    data.resize(static_cast<size_t>(width) * height);
+    IMAGE_INSTR_ALLOC(data.size());
+    for (int y = 0; y < height; ++y)
+        kernels::expandBits(mask.row(y), data.data() + static_cast<size_t>(y) * width, width, on, off);
 }
 
 // Accès
 int Image::getWidth() const { return width; }
 int Image::getHeight() const { return height; }
 int Image::getChannels() const { return channels; }
-const std::string& Image::getModel() const { return model; }
+ColorModel Image::getModel() const { return model; }
+Layout Image::getLayout() const { return layout; }
+
+uint8_t* Image::getData() { return data.data(); }
+const uint8_t* Image::getData() const { return data.data(); }
+
+uint8_t* Image::plane(int c) { return const_cast<uint8_t*>(static_cast<const Image&>(*this).plane(c)); }
+const uint8_t* Image::plane(int c) const {
+    if (layout != Layout::Planar) throw std::logic_error("Image is not planar");
+    if (c < 0 || c >= channels) throw std::out_of_range("Channel out of bounds");
+    return data.data() + static_cast<size_t>(c) * width * height;
+}
+
+// === LAYOUT ===
+Image Image::toLayout(Layout l) const {
+    IMAGE_INSTR_SCOPE(ToLayout, data.size());
+    IMAGE_TRACE_SCOPE("to_layout", width, height, channels);
+    Image res = data.empty() || l == layout ? *this : Image(width, height, channels, model, uint8_t(0), l);
+    res.layout = l;
+    if (l == layout || data.empty()) {
+        IMAGE_INSTR_DUP(data.size());
+        return res;
+    }
+    const size_t n = static_cast<size_t>(width) * height;
+    if (l == Layout::Planar) kernels::deinterleave(data.data(), res.data.data(), n, channels);
+    else kernels::interleave(data.data(), res.data.data(), n, channels);
+    return res;
+}
 
 uint8_t& Image::at(int x, int y, int c) { return data[index(x, y, c)]; }
 const uint8_t& Image::at(int x, int y, int c) const { return data[index(x, y, c)]; }
@@ -85,126 +182,198 @@ const uint8_t& Image::operator()(int x, int y, int c) const { return data[index(
 // === OPÉRATEURS ARITHMÉTIQUES ===
 
 // + avec image
-Image Image::operator+(const Image& other) const { Image res = *this; res += other; return res; }
+Image Image::operator+(const Image& other) const {
+    IMAGE_INSTR_SCOPE(Add, data.size() + other.data.size());
+    IMAGE_TRACE_SCOPE("add", width, height, channels);
+    Image res = *this;
+    IMAGE_INSTR_DUP(data.size());
+    res += other;
+    return res;
+}
 Image& Image::operator+=(const Image& other) {
-    if (channels != other.channels || model != other.model)
-        throw std::invalid_argument("Incompatible channels or model");
-    int nw = std::max(width, other.width);
-    int nh = std::max(height, other.height);
-    Image temp = other;
-    temp.enlargeTo(nw, nh);
-    enlargeTo(nw, nh);
-    for (int y = 0; y < nh; ++y)
-        for (int x = 0; x < nw; ++x)
-            for (int c = 0; c < channels; ++c)
-                (*this)(x, y, c) = clampAdd((*this)(x, y, c), temp(x, y, c));
+    IMAGE_INSTR_SCOPE(Add, data.size() + other.data.size());
+    IMAGE_TRACE_SCOPE("add", width, height, channels);
+    Image scratch;
+    const uint8_t* src = alignWith(other, scratch);
+    for (size_t i = 0; i < data.size(); ++i)
+        data[i] = clampAdd(data[i], src[i]);
     return *this;
 }
 
 // + avec scalaire
-Image Image::operator+(int value) const { Image res = *this; res += value; return res; }
+Image Image::operator+(int value) const {
+    IMAGE_INSTR_SCOPE(Add, data.size());
+    IMAGE_TRACE_SCOPE("add", width, height, channels);
+    Image res = *this;
+    IMAGE_INSTR_DUP(data.size());
+    res += value;
+    return res;
+}
 Image& Image::operator+=(int value) {
+    IMAGE_INSTR_SCOPE(Add, data.size());
+    IMAGE_TRACE_SCOPE("add", width, height, channels);
     for (size_t i = 0; i < data.size(); ++i)
         data[i] = clampAdd(data[i], value);
     return *this;
 }
 
 // + avec pixel (vector)
-Image Image::operator+(const std::vector<uint8_t>& pixel) const { Image res = *this; res += pixel; return res; }
+Image Image::operator+(const std::vector<uint8_t>& pixel) const {
+    IMAGE_INSTR_SCOPE(Add, data.size());
+    IMAGE_TRACE_SCOPE("add", width, height, channels);
+    Image res = *this;
+    IMAGE_INSTR_DUP(data.size());
+    res += pixel;
+    return res;
+}
 Image& Image::operator+=(const std::vector<uint8_t>& pixel) {
+    IMAGE_INSTR_SCOPE(Add, data.size());
+    IMAGE_TRACE_SCOPE("add", width, height, channels);
     if (pixel.size() != static_cast<size_t>(channels))
         throw std::invalid_argument("Pixel size mismatch");
-    for (int y = 0; y < height; ++y)
-        for (int x = 0; x < width; ++x)
-            for (int c = 0; c < channels; ++c)
-                (*this)(x, y, c) = clampAdd((*this)(x, y, c), pixel[c]);
+    applyPixel(data.data(), static_cast<size_t>(width) * height, channels, layout, pixel,
+               [](int a, int b) { return clampAdd(a, b); });
     return *this;
 }
 
 // - avec image
-Image Image::operator-(const Image& other) const { Image res = *this; res -= other; return res; }
+Image Image::operator-(const Image& other) const {
+    IMAGE_INSTR_SCOPE(Sub, data.size() + other.data.size());
+    IMAGE_TRACE_SCOPE("sub", width, height, channels);
+    Image res = *this;
+    IMAGE_INSTR_DUP(data.size());
+    res -= other;
+    return res;
+}
 Image& Image::operator-=(const Image& other) {
-    if (channels != other.channels || model != other.model)
-        throw std::invalid_argument("Incompatible channels or model");
-    int nw = std::max(width, other.width);
-    int nh = std::max(height, other.height);
-    Image temp = other;
-    temp.enlargeTo(nw, nh);
-    enlargeTo(nw, nh);
-    for (int y = 0; y < nh; ++y)
-        for (int x = 0; x < nw; ++x)
-            for (int c = 0; c < channels; ++c)
-                (*this)(x, y, c) = clampSub((*this)(x, y, c), temp(x, y, c));
+    IMAGE_INSTR_SCOPE(Sub, data.size() + other.data.size());
+    IMAGE_TRACE_SCOPE("sub", width, height, channels);
+    Image scratch;
+    const uint8_t* src = alignWith(other, scratch);
+    for (size_t i = 0; i < data.size(); ++i)
+        data[i] = clampSub(data[i], src[i]);
     return *this;
 }
 
 // - avec scalaire
-Image Image::operator-(int value) const { Image res = *this; res -= value; return res; }
+Image Image::operator-(int value) const {
+    IMAGE_INSTR_SCOPE(Sub, data.size());
+    IMAGE_TRACE_SCOPE("sub", width, height, channels);
+    Image res = *this;
+    IMAGE_INSTR_DUP(data.size());
+    res -= value;
+    return res;
+}
 Image& Image::operator-=(int value) {
+    IMAGE_INSTR_SCOPE(Sub, data.size());
+    IMAGE_TRACE_SCOPE("sub", width, height, channels);
     for (size_t i = 0; i < data.size(); ++i)
         data[i] = clampSub(data[i], value);
     return *this;
 }
 
 // - avec pixel
-Image Image::operator-(const std::vector<uint8_t>& pixel) const { Image res = *this; res -= pixel; return res; }
+Image Image::operator-(const std::vector<uint8_t>& pixel) const {
+    IMAGE_INSTR_SCOPE(Sub, data.size());
+    IMAGE_TRACE_SCOPE("sub", width, height, channels);
+    Image res = *this;
+    IMAGE_INSTR_DUP(data.size());
+    res -= pixel;
+    return res;
+}
 Image& Image::operator-=(const std::vector<uint8_t>& pixel) {
+    IMAGE_INSTR_SCOPE(Sub, data.size());
+    IMAGE_TRACE_SCOPE("sub", width, height, channels);
     if (pixel.size() != static_cast<size_t>(channels))
         throw std::invalid_argument("Pixel size mismatch");
-    for (int y = 0; y < height; ++y)
-        for (int x = 0; x < width; ++x)
-            for (int c = 0; c < channels; ++c)
-                (*this)(x, y, c) = clampSub((*this)(x, y, c), pixel[c]);
+    applyPixel(data.data(), static_cast<size_t>(width) * height, channels, layout, pixel,
+               [](int a, int b) { return clampSub(a, b); });
     return *this;
 }
 
 // ^ (différence) avec image
-Image Image::operator^(const Image& other) const { Image res = *this; res ^= other; return res; }
+Image Image::operator^(const Image& other) const {
+    IMAGE_INSTR_SCOPE(Diff, data.size() + other.data.size());
+    IMAGE_TRACE_SCOPE("diff", width, height, channels);
+    Image res = *this;
+    IMAGE_INSTR_DUP(data.size());
+    res ^= other;
+    return res;
+}
 Image& Image::operator^=(const Image& other) {
-    if (channels != other.channels || model != other.model)
-        throw std::invalid_argument("Incompatible channels or model");
-    int nw = std::max(width, other.width);
-    int nh = std::max(height, other.height);
-    Image temp = other;
-    temp.enlargeTo(nw, nh);
-    enlargeTo(nw, nh);
-    for (int y = 0; y < nh; ++y)
-        for (int x = 0; x < nw; ++x)
-            for (int c = 0; c < channels; ++c)
-                (*this)(x, y, c) = clampDiff((*this)(x, y, c), temp(x, y, c));
+    IMAGE_INSTR_SCOPE(Diff, data.size() + other.data.size());
+    IMAGE_TRACE_SCOPE("diff", width, height, channels);
+    Image scratch;
+    const uint8_t* src = alignWith(other, scratch);
+    for (size_t i = 0; i < data.size(); ++i)
+        data[i] = clampDiff(data[i], src[i]);
     return *this;
 }
 
 // ^ avec scalaire
-Image Image::operator^(int value) const { Image res = *this; res ^= value; return res; }
+Image Image::operator^(int value) const {
+    IMAGE_INSTR_SCOPE(Diff, data.size());
+    IMAGE_TRACE_SCOPE("diff", width, height, channels);
+    Image res = *this;
+    IMAGE_INSTR_DUP(data.size());
+    res ^= value;
+    return res;
+}
 Image& Image::operator^=(int value) {
+    IMAGE_INSTR_SCOPE(Diff, data.size());
+    IMAGE_TRACE_SCOPE("diff", width, height, channels);
     for (size_t i = 0; i < data.size(); ++i)
         data[i] = clampDiff(data[i], value);
     return *this;
 }
 
 // ^ avec pixel
-Image Image::operator^(const std::vector<uint8_t>& pixel) const { Image res = *this; res ^= pixel; return res; }
+Image Image::operator^(const std::vector<uint8_t>& pixel) const {
+    IMAGE_INSTR_SCOPE(Diff, data.size());
+    IMAGE_TRACE_SCOPE("diff", width, height, channels);
+    Image res = *this;
+    IMAGE_INSTR_DUP(data.size());
+    res ^= pixel;
+    return res;
+}
 Image& Image::operator^=(const std::vector<uint8_t>& pixel) {
+    IMAGE_INSTR_SCOPE(Diff, data.size());
+    IMAGE_TRACE_SCOPE("diff", width, height, channels);
     if (pixel.size() != static_cast<size_t>(channels))
         throw std::invalid_argument("Pixel size mismatch");
-    for (int y = 0; y < height; ++y)
-        for (int x = 0; x < width; ++x)
-            for (int c = 0; c < channels; ++c)
-                (*this)(x, y, c) = clampDiff((*this)(x, y, c), pixel[c]);
+    applyPixel(data.data(), static_cast<size_t>(width) * height, channels, layout, pixel,
+               [](int a, int b) { return clampDiff(a, b); });
     return *this;
 }
 
 // * et / avec double
-Image Image::operator*(double value) const { Image res = *this; res *= value; return res; }
+Image Image::operator*(double value) const {
+    IMAGE_INSTR_SCOPE(Mul, data.size());
+    IMAGE_TRACE_SCOPE("mul", width, height, channels);
+    Image res = *this;
+    IMAGE_INSTR_DUP(data.size());
+    res *= value;
+    return res;
+}
 Image& Image::operator*=(double value) {
+    IMAGE_INSTR_SCOPE(Mul, data.size());
+    IMAGE_TRACE_SCOPE("mul", width, height, channels);
     for (size_t i = 0; i < data.size(); ++i)
         data[i] = clampMul(data[i], value);
     return *this;
 }
 
-Image Image::operator/(double value) const { Image res = *this; res /= value; return res; }
+Image Image::operator/(double value) const {
+    IMAGE_INSTR_SCOPE(Div, data.size());
+    IMAGE_TRACE_SCOPE("div", width, height, channels);
+    Image res = *this;
+    IMAGE_INSTR_DUP(data.size());
+    res /= value;
+    return res;
+}
 Image& Image::operator/=(double value) {
+    IMAGE_INSTR_SCOPE(Div, data.size());
+    IMAGE_TRACE_SCOPE("div", width, height, channels);
     for (size_t i = 0; i < data.size(); ++i)
         data[i] = clampDiv(data[i], value);
     return *this;
@@ -212,54 +381,273 @@ Image& Image::operator/=(double value) {
 
 // Inversion
 Image Image::operator~() const {
-    Image res(width, height, channels, model);
+    IMAGE_INSTR_SCOPE(Invert, data.size());
+    IMAGE_TRACE_SCOPE("invert", width, height, channels);
+    Image res(width, height, channels, model, uint8_t(0), layout);
     for (size_t i = 0; i < data.size(); ++i)
         res.data[i] = 255 - data[i];
     return res;
 }
 
+// === COMBINAISONS LINÉAIRES ===
+Image Image::linearCombination(const std::vector<std::reference_wrapper<const Image>>& images,
+                               const std::vector<double>& weights, double offset) {
+    if (images.empty()) throw std::invalid_argument("linearCombination: no image");
+    if (weights.size() != images.size()) throw std::invalid_argument("linearCombination: one weight per image");
+    const Image& first = images.front();
+    int w = 0, h = 0;
+    size_t bytes = 0;
+    for (const Image& img : images) {
+        first.checkCompatible(img);
+        w = std::max(w, img.width);
+        h = std::max(h, img.height);
+        bytes += img.data.size();
+    }
+    IMAGE_INSTR_SCOPE(Blend, bytes);
+    IMAGE_TRACE_SCOPE("blend", w, h, first.channels);
+    if (first.channels == 0) return Image();
+
+    // Sources dans le layout du résultat (copie seulement si différent) ; les
+    // plus petites sont lues sur place, le noyau complétant leurs lignes par des 0
+    std::vector<Image> converted;
+    converted.reserve(images.size());
+    std::vector<const Image*> sources;
+    for (const Image& img : images) {
+        if (img.layout == first.layout) {
+            sources.push_back(&img);
+        } else {
+            converted.push_back(img.toLayout(first.layout));
+            sources.push_back(&converted.back());
+        }
+    }
+    Image res(w, h, first.channels, first.model, uint8_t(0), first.layout);
+    const int planes = first.layout == Layout::Planar ? first.channels : 1;
+    const int c = first.layout == Layout::Planar ? 1 : first.channels;
+    std::vector<kernels::ConstSurface> src(sources.size());
+    for (int p = 0; p < planes; ++p) {
+        for (size_t k = 0; k < sources.size(); ++k) {
+            const Image& s = *sources[k];
+            src[k] = {s.data.data() + static_cast<size_t>(p) * s.width * s.height, s.width, s.height, c,
+                      static_cast<size_t>(s.width) * c};
+        }
+        const kernels::Surface dst{res.data.data() + static_cast<size_t>(p) * w * h, w, h, c,
+                                   static_cast<size_t>(w) * c};
+        kernels::linearCombination(src.data(), weights.data(), static_cast<int>(src.size()), offset, dst);
+    }
+    return res;
+}
+
+Image Image::addWeighted(const Image& a, double alpha, const Image& b, double beta, double gamma) {
+    return linearCombination({a, b}, {alpha, beta}, gamma);
+}
+
 // === SEUILLAGE COMPLET ===
-#define THRESHOLD_OP(op) \
-    Image result(width, height, 1, "GRAY"); \
+#define THRESHOLD_OP(cmp) \
+    IMAGE_INSTR_SCOPE(Threshold, data.size()); \
+    IMAGE_TRACE_SCOPE("threshold", width, height, channels); \
+    Mask result(width, height); \
+    IMAGE_INSTR_ALLOC(static_cast<size_t>(result.getWordsPerRow()) * height * sizeof(uint64_t)); \
     for (int y = 0; y < height; ++y) { \
-        for (int x = 0; x < width; ++x) { \
-            uint32_t sum = 0; \
-            for (int c = 0; c < channels; ++c) sum += (*this)(x, y, c); \
-            uint8_t intensity = static_cast<uint8_t>(sum / channels); \
-            result(x, y, 0) = (intensity op threshold) ? 255 : 0; \
-        } \
+        if (layout == Layout::Planar) \
+            kernels::thresholdPlanar(data.data() + static_cast<size_t>(y) * width, \
+                                     static_cast<size_t>(width) * height, channels, result.row(y), \
+                                     width, threshold, kernels::Compare::cmp); \
+        else \
+            kernels::threshold(data.data() + static_cast<size_t>(y) * width * channels, result.row(y), \
+                               width, channels, threshold, kernels::Compare::cmp); \
     } \
     return result;
 
-Image Image::operator<(uint8_t threshold) const { THRESHOLD_OP(<) }
-Image Image::operator<=(uint8_t threshold) const { THRESHOLD_OP(<=) }
-Image Image::operator>(uint8_t threshold) const { THRESHOLD_OP(>) }
-Image Image::operator>=(uint8_t threshold) const { THRESHOLD_OP(>=) }
-Image Image::operator==(uint8_t threshold) const { THRESHOLD_OP(==) }
-Image Image::operator!=(uint8_t threshold) const { THRESHOLD_OP(!=) }
+Mask Image::operator<(uint8_t threshold) const { THRESHOLD_OP(Less) }
+Mask Image::operator<=(uint8_t threshold) const { THRESHOLD_OP(LessEqual) }
+Mask Image::operator>(uint8_t threshold) const { THRESHOLD_OP(Greater) }
+Mask Image::operator>=(uint8_t threshold) const { THRESHOLD_OP(GreaterEqual) }
+Mask Image::operator==(uint8_t threshold) const { THRESHOLD_OP(Equal) }
+Mask Image::operator!=(uint8_t threshold) const { THRESHOLD_OP(NotEqual) }
+
+// === CONVERSION DE MODÈLE ===
+Image Image::convertTo(ColorModel target, LumaStandard standard) const {
+    IMAGE_INSTR_SCOPE(Convert, data.size());
+    IMAGE_TRACE_SCOPE("convert", width, height, channels);
+    if (target == model) {
+        IMAGE_INSTR_DUP(data.size());
+        return *this;
+    }
+    if (model == ColorModel::NONE || target == ColorModel::NONE)
+        throw std::invalid_argument("Unsupported color conversion");
+    // Les noyaux de conversion travaillent sur des pixels entrelacés
+    if (layout == Layout::Planar)
+        return toLayout(Layout::Interleaved).convertTo(target, standard).toLayout(Layout::Planar);
+
+    const bool srcGray = model == ColorModel::GRAY || model == ColorModel::GRAYA;
+    const bool srcRgb = model == ColorModel::RGB || model == ColorModel::RGBA;
+    const bool dstGray = target == ColorModel::GRAY || target == ColorModel::GRAYA;
+    const bool dstRgb = target == ColorModel::RGB || target == ColorModel::RGBA;
+
+    const int tc = channelCount(target);
+    Image res(width, height, tc, target);
+    const uint8_t* src = data.data();
+    uint8_t* dst = res.data.data();
+    const size_t n = static_cast<size_t>(width) * height;
+
+    if ((srcGray && dstGray) || (srcRgb && dstRgb)) kernels::convertAlpha(src, channels, dst, tc, n);
+    else if (srcRgb && dstGray) kernels::rgbToGray(src, channels, dst, tc, n, standard);
+    else if (srcGray && dstRgb) kernels::grayToRgb(src, channels, dst, tc, n);
+    else if (srcRgb && target == ColorModel::YUV) kernels::rgbToYuv(src, channels, dst, n, standard);
+    else if (model == ColorModel::YUV && dstRgb) kernels::yuvToRgb(src, dst, tc, n, standard);
+    else if (srcRgb && target == ColorModel::HSV) kernels::rgbToHsv(src, channels, dst, n);
+    else if (model == ColorModel::HSV && dstRgb) kernels::hsvToRgb(src, dst, tc, n);
+    else {
+        // Pas de chemin direct : étape intermédiaire en RGB (RGBA si l'alpha doit survivre)
+        ColorModel via = hasAlpha(model) && hasAlpha(target) ? ColorModel::RGBA : ColorModel::RGB;
+        return convertTo(via, standard).convertTo(target, standard);
+    }
+    return res;
+}
 
 // === LOAD / SAVE ===
 bool Image::save(const char* filename) const {
+    IMAGE_INSTR_SCOPE(Save, data.size());
+    IMAGE_TRACE_SCOPE("save", width, height, channels);
     if (channels > 4) return false;
+    if (layout == Layout::Planar) return toLayout(Layout::Interleaved).save(filename);
     int stride = width * channels;
     return stbi_write_png(filename, width, height, channels, data.data(), stride) != 0;
 }
 
-Image Image::load(const char* filename, int desired_channels) {
+Image Image::fromDecoded(uint8_t* pixels, int w, int h, int loaded_channels, int desired_channels) {
     Image img;
-    int loaded_channels;
-    unsigned char* ptr = stbi_load(filename, &img.width, &img.height, &loaded_channels, desired_channels);
-    if (!ptr) throw std::runtime_error("Failed to load image: " + std::string(filename));
+    img.width = w;
+    img.height = h;
     img.channels = desired_channels != 0 ? desired_channels : loaded_channels;
-    img.model = (img.channels == 1) ? "GRAY" : "RGB";
+    img.model = defaultModel(img.channels);
     size_t size = static_cast<size_t>(img.width) * img.height * img.channels;
-    img.data.assign(ptr, ptr + size);
-    stbi_image_free(ptr);
+    img.data.assign(pixels, pixels + size);
+    IMAGE_INSTR_DUP(size);
+    IMAGE_INSTR_BYTES(size);
+    stbi_image_free(pixels);
+    return img;
+}
+
+namespace {
+
+// Orientation EXIF d'un JPEG (tag 0x0112 de l'IFD0 du segment APP1 "Exif"),
+// Normal si absente ou illisible. Seuls les octets [0, size) sont lus.
+Orientation exifOrientation(const uint8_t* p, size_t size) {
+    if (size < 4 || p[0] != 0xFF || p[1] != 0xD8) return Orientation::Normal;
+    size_t pos = 2;
+    while (pos + 4 <= size) {
+        if (p[pos] != 0xFF) break;
+        const uint8_t marker = p[pos + 1];
+        if (marker == 0xFF) { ++pos; continue; }       // octet de remplissage
+        if (marker == 0xDA || marker == 0xD9) break;  // début des données compressées
+        const size_t len = (p[pos + 2] << 8) | p[pos + 3];
+        if (len < 2) break;
+        const size_t seg = pos + 4, end = std::min(size, pos + 2 + len);
+        if (marker == 0xE1 && end >= seg + 14 && std::memcmp(p + seg, "Exif\0\0", 6) == 0) {
+            // En-tête TIFF : ordre des octets, 42, décalage de l'IFD0
+            const uint8_t* t = p + seg + 6;
+            const size_t n = end - seg - 6;
+            const bool little = t[0] == 'I' && t[1] == 'I';
+            if (!little && !(t[0] == 'M' && t[1] == 'M')) break;
+            auto u16 = [&](size_t o) -> uint32_t { return little ? t[o] | t[o + 1] << 8 : t[o] << 8 | t[o + 1]; };
+            auto u32 = [&](size_t o) { return little ? u16(o) | u16(o + 2) << 16 : u16(o) << 16 | u16(o + 2); };
+            if (u16(2) != 42) break;
+            const size_t ifd = u32(4);
+            if (ifd + 2 > n) break;
+            const size_t count = u16(ifd);
+            for (size_t i = 0; i < count && ifd + 2 + 12 * (i + 1) <= n; ++i) {
+                const size_t e = ifd + 2 + 12 * i;
+                if (u16(e) != 0x0112) continue;
+                const uint32_t v = u16(e + 8);
+                if (u16(e + 2) == 3 && v >= 1 && v <= 8) return static_cast<Orientation>(v);
+                break;
+            }
+            break;
+        }
+        pos += 2 + len;
+    }
+    return Orientation::Normal;
+}
+
+} // namespace
+
+Image Image::load(const char* filename, int desired_channels, bool applyOrientation) {
+    IMAGE_INSTR_SCOPE(Load, 0);
+    IMAGE_TRACE_SCOPE("load", 0, 0, 0);
+    int w, h, loaded_channels;
+    unsigned char* ptr = stbi_load(filename, &w, &h, &loaded_channels, desired_channels);
+    if (!ptr) throw std::runtime_error("Failed to load image: " + std::string(filename));
+    Image img = fromDecoded(ptr, w, h, loaded_channels, desired_channels);
+    if (applyOrientation) {
+        // Le segment APP1 suit SOI (et APP0) : les premiers 64 Kio suffisent
+        if (std::FILE* f = std::fopen(filename, "rb")) {
+            std::vector<uint8_t> head(65536);
+            head.resize(std::fread(head.data(), 1, head.size(), f));
+            std::fclose(f);
+            img.orient(exifOrientation(head.data(), head.size()));
+        }
+    }
+    IMAGE_TRACE_SIZE(img.width, img.height, img.channels);
     return img;
 }
 
+Image Image::decode(const uint8_t* bytes, size_t size, int desired_channels, bool applyOrientation) {
+    IMAGE_INSTR_SCOPE(Decode, size);
+    IMAGE_TRACE_SCOPE("decode", 0, 0, 0);
+    if (size > static_cast<size_t>(INT_MAX)) throw std::runtime_error("Failed to decode image: buffer too large");
+    int w, h, loaded_channels;
+    unsigned char* ptr = stbi_load_from_memory(bytes, static_cast<int>(size), &w, &h, &loaded_channels,
+                                               desired_channels);
+    if (!ptr) throw std::runtime_error(std::string("Failed to decode image: ") + stbi_failure_reason());
+    Image img = fromDecoded(ptr, w, h, loaded_channels, desired_channels);
+    if (applyOrientation) img.orient(exifOrientation(bytes, size));
+    IMAGE_TRACE_SIZE(img.width, img.height, img.channels);
+    return img;
+}
+
+namespace {
+// Rappel de stb_image_write : ajoute les octets produits au vecteur
+void appendBytes(void* context, void* bytes, int size) {
+    auto* out = static_cast<std::vector<uint8_t>*>(context);
+    const uint8_t* p = static_cast<const uint8_t*>(bytes);
+    out->insert(out->end(), p, p + size);
+}
+} // namespace
+
+std::vector<uint8_t> Image::encode(FileFormat format, int jpegQuality) const {
+    std::vector<uint8_t> out;
+    encode(out, format, jpegQuality);
+    return out;
+}
+
+void Image::encode(std::vector<uint8_t>& out, FileFormat format, int jpegQuality) const {
+    IMAGE_INSTR_SCOPE(Encode, data.size());
+    IMAGE_TRACE_SCOPE("encode", width, height, channels);
+    if (channels > 4) throw std::runtime_error("Failed to encode image: more than 4 channels");
+    if (layout == Layout::Planar) return toLayout(Layout::Interleaved).encode(out, format, jpegQuality);
+    out.clear();
+    int ok = 0;
+    switch (format) {
+        case FileFormat::PNG:
+            ok = stbi_write_png_to_func(appendBytes, &out, width, height, channels, data.data(), width * channels);
+            break;
+        case FileFormat::BMP:
+            ok = stbi_write_bmp_to_func(appendBytes, &out, width, height, channels, data.data());
+            break;
+        case FileFormat::TGA:
+            ok = stbi_write_tga_to_func(appendBytes, &out, width, height, channels, data.data());
+            break;
+        case FileFormat::JPEG:
+            ok = stbi_write_jpg_to_func(appendBytes, &out, width, height, channels, data.data(), jpegQuality);
+            break;
+    }
+    if (!ok) throw std::runtime_error("Failed to encode image");
+}
+
 // Affichage
 std::ostream& operator<<(std::ostream& os, const Image& img) {
-    os << img.width << "x" << img.height << "x" << img.channels << " (" << img.model << ")";
+    os << img.width << "x" << img.height << "x" << img.channels << " (" << img.model
+       << (img.layout == Layout::Planar ? ", planar" : "") << ")";
     return os;
 }
\ No newline at end of file
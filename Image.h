@@ -1,25 +1,89 @@
 #ifndef IMAGE_H
 #define IMAGE_H
 
+#include <functional>
 #include <string>
 #include <vector>
 #include <cstdint>
 #include <iostream>
 #include <stdexcept>
+#include "ColorModel.h"
+#include "Kernel.h"
+#include "StructuringElement.h"
+#include "Mask.h"
+#include "Transform.h"
+
+// Organisation mémoire des pixels
+enum class Layout : uint8_t {
+    Interleaved,  // RGBRGB... (HWC), format des fichiers
+    Planar        // RRR...GGG...BBB... un plan contigu par canal (CHW)
+};
+
+// Formats d'encodage en mémoire (encode) ; save écrit toujours du PNG
+enum class FileFormat : uint8_t { PNG, BMP, TGA, JPEG };
+
+class Image;
+
+// Vue sans copie sur un rectangle d'une Image (Image::crop) : lignes de l'image
+// d'origine, avec son pas. Valide tant que l'image n'est ni détruite, ni
+// réallouée (agrandissement, changement de layout...).
+class ImageView {
+private:
+    const uint8_t* origin = nullptr;  // canal 0 du pixel (0, 0)
+    int width = 0;
+    int height = 0;
+    int channels = 0;
+    ColorModel model = ColorModel::NONE;
+    Layout layout = Layout::Interleaved;
+    size_t stride = 0;       // octets d'une ligne à la suivante
+    size_t planeStride = 0;  // octets d'un plan au suivant (planaire)
+
+    friend class Image;
+
+public:
+    ImageView() = default;
+    ImageView(const Image& img);  // image entière
+
+    int getWidth() const;
+    int getHeight() const;
+    int getChannels() const;
+    ColorModel getModel() const;
+    Layout getLayout() const;
+    size_t getStride() const;
+
+    // Ligne y (du plan c en planaire, du pixel 0 en entrelacé)
+    const uint8_t* row(int y, int c = 0) const;
+    const uint8_t& at(int x, int y, int c) const;
+
+    // Sous-rectangle, mêmes règles que Image::crop
+    ImageView crop(int x, int y, int w, int h) const;
+};
 
 class Image {
 private:
     int width = 0;
     int height = 0;
     int channels = 0;
-    std::string model = "NONE";
+    ColorModel model = ColorModel::NONE;
+    Layout layout = Layout::Interleaved;
     std::vector<uint8_t> data;
 
     size_t index(int x, int y, int c) const;
 
+    // Même nombre de canaux et même modèle, sinon std::invalid_argument
+    void checkCompatible(const Image& other) const;
+
     // Fonction helper pour agrandir l'image (padding à 0)
     void enlargeTo(int newWidth, int newHeight);
 
+    // Prépare une opération image-image : vérifie la compatibilité, agrandit *this
+    // et renvoie le buffer de other à la même taille et dans le même layout
+    // (other lui-même si possible, sinon une copie dans scratch).
+    const uint8_t* alignWith(const Image& other, Image& scratch);
+
+    // Reprend un buffer décodé par stb (copié puis libéré)
+    static Image fromDecoded(uint8_t* pixels, int w, int h, int loaded_channels, int desired_channels);
+
     // Fonctions de clamping
     static uint8_t clampAdd(int a, int b);
     static uint8_t clampSub(int a, int b);
@@ -29,8 +93,12 @@ private:
 
 public:
     Image();
-    Image(int w, int h, int c, const std::string& m, uint8_t fill_value = 0);
-    Image(int w, int h, int c, const std::string& m, const uint8_t* buffer);
+    Image(int w, int h, int c, ColorModel m, uint8_t fill_value = 0, Layout l = Layout::Interleaved);
+    Image(int w, int h, int c, ColorModel m, const uint8_t* buffer, Layout l = Layout::Interleaved);
+    // Expansion d'un masque binaire en image GRAY (on/off par pixel)
+    Image(const Mask& mask, uint8_t on = 255, uint8_t off = 0);
+    // Copie compacte d'une vue, dans son layout
+    explicit Image(const ImageView& view);
 
     // Règle des 5
     ~Image() = default;
@@ -42,7 +110,18 @@ public:
     int getWidth() const;
     int getHeight() const;
     int getChannels() const;
-    const std::string& getModel() const;
+    ColorModel getModel() const;
+    Layout getLayout() const;
+
+    // Accès brut au buffer (width * height * channels octets, dans le layout courant)
+    uint8_t* getData();
+    const uint8_t* getData() const;
+    // Plan contigu du canal c (width * height octets) ; images planaires uniquement
+    uint8_t* plane(int c);
+    const uint8_t* plane(int c) const;
+
+    // Copie dans l'autre organisation mémoire (ou copie simple si déjà dans l)
+    Image toLayout(Layout l) const;
 
     uint8_t& at(int x, int y, int c);
     const uint8_t& at(int x, int y, int c) const;
@@ -78,17 +157,137 @@ public:
 
     Image operator~() const;  // inversion
 
-    // Seuillage
-    Image operator<(uint8_t threshold) const;
-    Image operator<=(uint8_t threshold) const;
-    Image operator>(uint8_t threshold) const;
-    Image operator>=(uint8_t threshold) const;
-    Image operator==(uint8_t threshold) const;
-    Image operator!=(uint8_t threshold) const;
+    // === COMBINAISONS LINÉAIRES ===
+    // Σ weights[k]·images[k] + offset en un seul passage, sans temporaire :
+    // poids en virgule fixe 16 bits, un seul arrondi final puis saturation
+    // (fondus enchaînés, fusion d'expositions). Mêmes canaux et modèle partout,
+    // sinon std::invalid_argument, comme pour weights.size() != images.size().
+    // Résultat à la plus grande largeur et hauteur, les images plus petites
+    // valant 0 au-delà de leurs bords (comme +, - et ^), dans le layout de la
+    // première image.
+    static Image linearCombination(const std::vector<std::reference_wrapper<const Image>>& images,
+                                   const std::vector<double>& weights, double offset = 0);
+    // alpha·a + beta·b + gamma ; fondu de a vers b : addWeighted(a, 1 - t, b, t)
+    static Image addWeighted(const Image& a, double alpha, const Image& b, double beta, double gamma = 0);
+
+    // Seuillage -> masque 1 bit/pixel (converti en image GRAY 0/255 à la demande)
+    Mask operator<(uint8_t threshold) const;
+    Mask operator<=(uint8_t threshold) const;
+    Mask operator>(uint8_t threshold) const;
+    Mask operator>=(uint8_t threshold) const;
+    Mask operator==(uint8_t threshold) const;
+    Mask operator!=(uint8_t threshold) const;
+
+    // Conversion de modèle (GRAY, GRAYA, RGB, RGBA, YUV, HSV), sans relire le fichier.
+    // Les conversions sans chemin direct passent par RGB / RGBA.
+    Image convertTo(ColorModel target, LumaStandard standard = LumaStandard::BT601) const;
+
+    // === VOISINAGES (ImageFilters.cpp) ===
+    // Résultat de même taille, modèle et layout ; tous les canaux sont filtrés
+    // (alpha compris). Calcul en virgule fixe, bandes de lignes en parallèle.
+
+    // Convolution par un noyau quelconque, en deux passes 1D s'il est séparable.
+    // std::invalid_argument si le noyau est vide ou ses poids trop grands pour le 8 bits.
+    Image convolve(const Kernel& kernel, Border border = Border::Replicate) const;
+
+    // Flou moyen (2rx+1) x (2ry+1) en place, par sommes glissantes : coût par
+    // pixel indépendant du rayon. Arrondi au plus proche après chaque passe 1D.
+    Image& boxBlur(int radius, Border border = Border::Replicate);
+    Image& boxBlur(int radiusX, int radiusY, Border border = Border::Replicate);
+    // Gaussienne approchée par trois flous moyens successifs, en place ; pour les
+    // grands sigma (fond de page...), là où convolve(Kernel::gaussian) coûte O(sigma).
+    // Près des bords, chaque passe s'applique au résultat de la précédente.
+    // std::invalid_argument hors de ]0, Kernel::maxRadius / 3].
+    Image& gaussianBlur(double sigma, Border border = Border::Replicate);
+
+    // Filtre de rang sur une fenêtre (2r+1) x (2r+1) : valeur d'indice
+    // round(rank * (n - 1)) parmi les n voisins triés (0 = minimum, 0.5 =
+    // médiane, 1 = maximum). Réseaux de tri vectorisés jusqu'à r = 2,
+    // histogrammes glissants au-delà (coût indépendant de r).
+    // std::invalid_argument si radius hors de [0, 16383] ou rank hors de [0, 1].
+    Image rankFilter(int radius, double rank, Border border = Border::Replicate) const;
+    // Médiane : élimine le bruit poivre et sel (scans) avant un seuillage
+    Image median(int radius = 1, Border border = Border::Replicate) const;
+
+    // Morphologie en niveaux de gris, canal par canal : erode = minimum de
+    // f(x + b), dilate = maximum de f(x - b) sur les points b de l'élément.
+    // Coût indépendant de la taille pour un rectangle (van Herk / Gil-Werman).
+    // Avec Border::Replicate un rectangle ignore simplement l'extérieur.
+    // Sur un seuillage 0/255, préférer Mask (64 pixels par opération).
+    Image erode(const StructuringElement& se, Border border = Border::Replicate) const;
+    Image dilate(const StructuringElement& se, Border border = Border::Replicate) const;
+    Image open(const StructuringElement& se, Border border = Border::Replicate) const;   // dilate(erode)
+    Image close(const StructuringElement& se, Border border = Border::Replicate) const;  // erode(dilate)
+
+    // === GÉOMÉTRIE (ImageFilters.cpp) ===
+    // Redimensionnement par filtre séparable (tables de poids Q14, SSE2, bandes
+    // en parallèle), bords répliqués. Area par un facteur 2^k : sommes de blocs
+    // directes, le chemin à privilégier pour les vignettes.
+    // std::invalid_argument si une dimension demandée n'est pas positive ou si l'image est vide.
+    Image resize(int newWidth, int newHeight, ResizeFilter filter = ResizeFilter::Bilinear) const;
+
+    // Orientations exactes (copie de pixels) : quarts de tour par blocs
+    // transposés en SSE2 et bandes en parallèle, sans parcours en colonne de
+    // l'image entière. std::invalid_argument si o n'est pas une Orientation.
+    Image oriented(Orientation o) const;
+    // En place : miroirs et demi-tour sans tampon image, quarts de tour aussi
+    // sur une image carrée ; une image non carrée est réallouée
+    Image& orient(Orientation o);
+    Image transpose() const;
+    Image rotate90() const;   // sens horaire
+    Image rotate180() const;
+    Image rotate270() const;  // sens antihoraire
+    Image flipHorizontal() const;
+    Image flipVertical() const;
+
+    // Déformation affine ou perspective : sortie(x, y) = image(t^-1(x, y)),
+    // position calculée par incréments entiers le long des lignes (sans
+    // produit matriciel par pixel), tuiles en parallèle. Border::Zero : noir
+    // hors de l'image. std::invalid_argument si t n'est pas inversible, si une
+    // dimension n'est pas positive ou si l'image est vide.
+    Image warp(const Transform& t, int outWidth, int outHeight, Interpolation interp = Interpolation::Bilinear,
+               Border border = Border::Zero) const;
+
+    // === RECTANGLES (ImageView.cpp) ===
+    // Vue sans copie sur le rectangle (x, y, w, h) : std::out_of_range s'il
+    // déborde de l'image, std::invalid_argument si w ou h n'est pas positif
+    ImageView crop(int x, int y, int w, int h) const;
+    // Copie src avec son coin haut-gauche en (x, y), décalage quelconque : la
+    // partie hors de l'image est ignorée, pas d'agrandissement (contrairement
+    // aux opérateurs image-image). Même nombre de canaux et même modèle.
+    Image& paste(const ImageView& src, int x, int y);
+    // Composition de Porter-Duff de src (RGBA ou GRAYA, alpha non prémultiplié)
+    // sur la zone de *this couverte par src placé en (x, y). *this a le même
+    // modèle, ou le même sans alpha (RGB sous RGBA...) : il est alors opaque et
+    // l'alpha résultant est ignoré. Prémultiplication exacte en entier et un
+    // seul arrondi par canal ; SSE2 par 4 pixels, bandes en parallèle.
+    Image& composite(const ImageView& src, int x, int y, Composite op = Composite::Over);
+
+    // === PYRAMIDES (ImageFilters.cpp) ===
+    // Niveaux de réduction par 2 (ceil(w / 2) x ceil(h / 2)), du plus grand au
+    // plus petit, l'image elle-même exclue ; levels = 0 : jusqu'à 1x1. Un seul
+    // passage sur l'image, chaque niveau étant calculé ligne à ligne depuis le
+    // précédent encore en cache. std::invalid_argument si levels < 0 ou si
+    // l'image est vide ; le nombre de niveaux est borné par l'arrivée à 1x1.
+    std::vector<Image> mipmaps(int levels = 0) const;          // moyenne 2x2
+    std::vector<Image> gaussianPyramid(int levels = 0) const;  // binomial 5x5, miroir, puis décimation
+    // L_k = G_k - expand(G_k+1) + 128 saturé (G_0 = l'image), suivis du dernier
+    // niveau gaussien : levels + 1 images, la première à la taille de l'image
+    std::vector<Image> laplacianPyramid(int levels = 0) const;
+    // Inverse de laplacianPyramid, exact tant qu'aucun détail n'a saturé
+    static Image collapseLaplacian(const std::vector<Image>& pyramid);
 
     // Load / Save
     bool save(const char* filename) const;
-    static Image load(const char* filename, int desired_channels = 0);
+    // applyOrientation : une orientation EXIF (JPEG) est appliquée au chargement
+    static Image load(const char* filename, int desired_channels = 0, bool applyOrientation = true);
+
+    // Décodage / encodage en mémoire (fichier reçu ou envoyé sur le réseau) ;
+    // std::runtime_error si le décodage ou l'encodage échoue
+    static Image decode(const uint8_t* bytes, size_t size, int desired_channels = 0, bool applyOrientation = true);
+    std::vector<uint8_t> encode(FileFormat format = FileFormat::PNG, int jpegQuality = 90) const;
+    // Variante qui réutilise la capacité de out (vidé au préalable)
+    void encode(std::vector<uint8_t>& out, FileFormat format = FileFormat::PNG, int jpegQuality = 90) const;
 
     friend std::ostream& operator<<(std::ostream& os, const Image& img);
 };
@@ -0,0 +1,271 @@
+#include "Image.h"
+#include "ImageKernels.h"
+#include "Instrumentation.h"
+#include "Trace.h"
+#include <cmath>
+
+namespace {
+
+// Surfaces vues par les noyaux de voisinage : l'image entière si entrelacée,
+// un plan par canal si planaire
+std::vector<kernels::ConstSurface> surfaces(const Image& img) {
+    const int w = img.getWidth(), h = img.getHeight(), c = img.getChannels();
+    if (img.getLayout() == Layout::Interleaved)
+        return {kernels::ConstSurface{img.getData(), w, h, c, static_cast<size_t>(w) * c}};
+    std::vector<kernels::ConstSurface> s;
+    for (int i = 0; i < c; ++i) s.push_back(kernels::ConstSurface{img.plane(i), w, h, 1, static_cast<size_t>(w)});
+    return s;
+}
+
+std::vector<kernels::Surface> surfaces(Image& img) {
+    const int w = img.getWidth(), h = img.getHeight(), c = img.getChannels();
+    if (img.getLayout() == Layout::Interleaved)
+        return {kernels::Surface{img.getData(), w, h, c, static_cast<size_t>(w) * c}};
+    std::vector<kernels::Surface> s;
+    for (int i = 0; i < c; ++i) s.push_back(kernels::Surface{img.plane(i), w, h, 1, static_cast<size_t>(w)});
+    return s;
+}
+
+} // namespace
+
+// === CONVOLUTION ===
+Image Image::convolve(const Kernel& kernel, Border border) const {
+    IMAGE_INSTR_SCOPE(Convolve, data.size());
+    IMAGE_TRACE_SCOPE("convolve", width, height, channels);
+    if (kernel.getWidth() == 0) throw std::invalid_argument("Empty kernel");
+    Image res(width, height, channels, model, uint8_t(0), layout);
+    if (data.empty()) return res;
+
+    std::vector<float> h, v;
+    const bool separable = kernel.separate(h, v) && kernels::separableFits(h.data(), static_cast<int>(h.size()));
+    const auto src = surfaces(*this);
+    const auto dst = surfaces(res);
+    for (size_t i = 0; i < src.size(); ++i) {
+        if (separable)
+            kernels::convolveSeparable(src[i], dst[i], h.data(), static_cast<int>(h.size()), v.data(),
+                                       static_cast<int>(v.size()), border);
+        else
+            kernels::convolve2D(src[i], dst[i], kernel, border);
+    }
+    return res;
+}
+
+// === FLOUS PAR SOMMES GLISSANTES ===
+Image& Image::boxBlur(int radius, Border border) { return boxBlur(radius, radius, border); }
+
+Image& Image::boxBlur(int radiusX, int radiusY, Border border) {
+    IMAGE_INSTR_SCOPE(Blur, data.size());
+    IMAGE_TRACE_SCOPE("box_blur", width, height, channels);
+    if (radiusX < 0 || radiusY < 0) throw std::invalid_argument("boxBlur: negative radius");
+    for (const kernels::Surface& s : surfaces(*this)) {
+        kernels::boxBlurRows(s, &radiusX, 1, border);
+        kernels::boxBlurColumns(s, &radiusY, 1, border);
+    }
+    return *this;
+}
+
+Image& Image::gaussianBlur(double sigma, Border border) {
+    IMAGE_INSTR_SCOPE(Blur, data.size());
+    IMAGE_TRACE_SCOPE("gaussian_blur", width, height, channels);
+    // Même borne que Kernel::gaussian : rayons des box représentables (pas de cast hors int)
+    if (!(sigma > 0 && sigma <= Kernel::maxRadius / 3.0))
+        throw std::invalid_argument("gaussianBlur: sigma out of ]0, " + std::to_string(Kernel::maxRadius / 3) + "]");
+    int radii[3];
+    kernels::gaussianBoxRadii(sigma, 3, radii);
+    for (const kernels::Surface& s : surfaces(*this)) {
+        // Les trois passes d'une ligne s'enchaînent pendant qu'elle est en cache
+        kernels::boxBlurRows(s, radii, 3, border);
+        kernels::boxBlurColumns(s, radii, 3, border);
+    }
+    return *this;
+}
+
+// === FILTRES DE RANG ===
+Image Image::rankFilter(int radius, double rank, Border border) const {
+    IMAGE_INSTR_SCOPE(Rank, data.size());
+    IMAGE_TRACE_SCOPE("rank_filter", width, height, channels);
+    if (radius < 0 || radius > kernels::maxRankRadius)
+        throw std::invalid_argument("rankFilter: radius out of [0, 16383]");
+    if (!(rank >= 0 && rank <= 1)) throw std::invalid_argument("rankFilter: rank must be in [0, 1]");
+    Image res(width, height, channels, model, uint8_t(0), layout);
+    if (data.empty()) return res;
+
+    const int n = (2 * radius + 1) * (2 * radius + 1);
+    const int k = static_cast<int>(std::lround(rank * (n - 1)));
+    const auto src = surfaces(*this);
+    const auto dst = surfaces(res);
+    for (size_t i = 0; i < src.size(); ++i) kernels::rankFilter(src[i], dst[i], radius, k, border);
+    return res;
+}
+
+Image Image::median(int radius, Border border) const { return rankFilter(radius, 0.5, border); }
+
+// === MORPHOLOGIE ===
+namespace {
+
+Image extremum(const Image& img, const StructuringElement& se, kernels::Extremum ext, Border border) {
+    if (se.getWidth() == 0) throw std::invalid_argument("Empty structuring element");
+    Image res(img.getWidth(), img.getHeight(), img.getChannels(), img.getModel(), uint8_t(0), img.getLayout());
+    if (img.getWidth() == 0 || img.getHeight() == 0) return res;
+    const auto src = surfaces(img);
+    const auto dst = surfaces(res);
+    for (size_t i = 0; i < src.size(); ++i) kernels::windowExtremum(src[i], dst[i], se, ext, border);
+    return res;
+}
+
+} // namespace
+
+Image Image::erode(const StructuringElement& se, Border border) const {
+    IMAGE_INSTR_SCOPE(Morphology, data.size());
+    IMAGE_TRACE_SCOPE("erode", width, height, channels);
+    return extremum(*this, se, kernels::Extremum::Min, border);
+}
+
+Image Image::dilate(const StructuringElement& se, Border border) const {
+    IMAGE_INSTR_SCOPE(Morphology, data.size());
+    IMAGE_TRACE_SCOPE("dilate", width, height, channels);
+    return extremum(*this, se.reflected(), kernels::Extremum::Max, border);
+}
+
+Image Image::open(const StructuringElement& se, Border border) const { return erode(se, border).dilate(se, border); }
+Image Image::close(const StructuringElement& se, Border border) const { return dilate(se, border).erode(se, border); }
+
+// === GÉOMÉTRIE ===
+Image Image::resize(int newWidth, int newHeight, ResizeFilter filter) const {
+    IMAGE_INSTR_SCOPE(Resize, data.size());
+    IMAGE_TRACE_SCOPE("resize", newWidth, newHeight, channels);
+    if (newWidth <= 0 || newHeight <= 0) throw std::invalid_argument("resize: dimensions must be positive");
+    if (data.empty()) throw std::invalid_argument("resize: empty image");
+    Image res(newWidth, newHeight, channels, model, uint8_t(0), layout);
+    const auto src = surfaces(*this);
+    const auto dst = surfaces(res);
+    for (size_t i = 0; i < src.size(); ++i) kernels::resize(src[i], dst[i], filter);
+    return res;
+}
+
+// === ORIENTATION ===
+Image Image::oriented(Orientation o) const {
+    IMAGE_INSTR_SCOPE(Orient, data.size());
+    IMAGE_TRACE_SCOPE("orient", width, height, channels);
+    if (o < Orientation::Normal || o > Orientation::Rotate270) throw std::invalid_argument("Invalid orientation");
+    const bool swap = kernels::swapsAxes(o);
+    Image res(swap ? height : width, swap ? width : height, channels, model, uint8_t(0), layout);
+    if (data.empty()) return res;
+    const auto src = surfaces(*this);
+    const auto dst = surfaces(res);
+    for (size_t i = 0; i < src.size(); ++i) kernels::orient(src[i], dst[i], o);
+    return res;
+}
+
+Image& Image::orient(Orientation o) {
+    if (o < Orientation::Normal || o > Orientation::Rotate270) throw std::invalid_argument("Invalid orientation");
+    if (o == Orientation::Normal || data.empty()) return *this;
+    if (kernels::swapsAxes(o) && width != height) return *this = oriented(o);
+    IMAGE_INSTR_SCOPE(Orient, data.size());
+    IMAGE_TRACE_SCOPE("orient_in_place", width, height, channels);
+    for (const kernels::Surface& s : surfaces(*this)) kernels::orientInPlace(s, o);
+    return *this;
+}
+
+Image Image::transpose() const { return oriented(Orientation::Transpose); }
+Image Image::rotate90() const { return oriented(Orientation::Rotate90); }
+Image Image::rotate180() const { return oriented(Orientation::Rotate180); }
+Image Image::rotate270() const { return oriented(Orientation::Rotate270); }
+Image Image::flipHorizontal() const { return oriented(Orientation::FlipHorizontal); }
+Image Image::flipVertical() const { return oriented(Orientation::FlipVertical); }
+
+// === DÉFORMATIONS ===
+Image Image::warp(const Transform& t, int outWidth, int outHeight, Interpolation interp, Border border) const {
+    IMAGE_INSTR_SCOPE(Warp, data.size());
+    IMAGE_TRACE_SCOPE("warp", outWidth, outHeight, channels);
+    if (outWidth <= 0 || outHeight <= 0) throw std::invalid_argument("warp: dimensions must be positive");
+    if (data.empty()) throw std::invalid_argument("warp: empty image");
+    const kernels::WarpMap map = kernels::warpMap(t.inverse().coefficients().data(), outWidth, outHeight);
+    Image res(outWidth, outHeight, channels, model, uint8_t(0), layout);
+    const auto src = surfaces(*this);
+    const auto dst = surfaces(res);
+    for (size_t i = 0; i < src.size(); ++i) kernels::warp(src[i], dst[i], map, interp, border);
+    return res;
+}
+
+// === PYRAMIDES ===
+namespace {
+
+// Niveaux 1..levels de img, remplis d'un seul passage ; laplacian reçoit
+// alors levels images de la taille des niveaux 0..levels - 1
+std::vector<Image> reduceChain(const Image& img, int levels, kernels::PyramidKind kind, std::vector<Image>* laplacian) {
+    if (levels < 0) throw std::invalid_argument("pyramid: negative level count");
+    if (img.getWidth() <= 0 || img.getHeight() <= 0 || img.getChannels() <= 0)
+        throw std::invalid_argument("pyramid: empty image");
+    std::vector<Image> res;
+    int w = img.getWidth(), h = img.getHeight();
+    while ((levels == 0 || static_cast<int>(res.size()) < levels) && (w > 1 || h > 1)) {
+        if (laplacian) laplacian->emplace_back(w, h, img.getChannels(), img.getModel(), uint8_t(0), img.getLayout());
+        w = (w + 1) / 2, h = (h + 1) / 2;
+        res.emplace_back(w, h, img.getChannels(), img.getModel(), uint8_t(0), img.getLayout());
+    }
+    if (res.empty()) return res;
+
+    const auto src = surfaces(img);
+    std::vector<std::vector<kernels::Surface>> dst, lap;
+    for (Image& level : res) dst.push_back(surfaces(level));
+    if (laplacian)
+        for (Image& level : *laplacian) lap.push_back(surfaces(level));
+    // Une cascade par plan : surfaces d'indice i de chaque niveau
+    std::vector<kernels::Surface> levelSurfaces(res.size()), lapSurfaces(res.size());
+    for (size_t i = 0; i < src.size(); ++i) {
+        for (size_t k = 0; k < res.size(); ++k) {
+            levelSurfaces[k] = dst[k][i];
+            if (laplacian) lapSurfaces[k] = lap[k][i];
+        }
+        kernels::pyramid(src[i], levelSurfaces.data(), static_cast<int>(res.size()), kind,
+                         laplacian ? lapSurfaces.data() : nullptr);
+    }
+    return res;
+}
+
+} // namespace
+
+std::vector<Image> Image::mipmaps(int levels) const {
+    IMAGE_INSTR_SCOPE(Pyramid, data.size());
+    IMAGE_TRACE_SCOPE("mipmaps", width, height, channels);
+    return reduceChain(*this, levels, kernels::PyramidKind::Box, nullptr);
+}
+
+std::vector<Image> Image::gaussianPyramid(int levels) const {
+    IMAGE_INSTR_SCOPE(Pyramid, data.size());
+    IMAGE_TRACE_SCOPE("gaussian_pyramid", width, height, channels);
+    return reduceChain(*this, levels, kernels::PyramidKind::Gaussian, nullptr);
+}
+
+std::vector<Image> Image::laplacianPyramid(int levels) const {
+    IMAGE_INSTR_SCOPE(Pyramid, data.size());
+    IMAGE_TRACE_SCOPE("laplacian_pyramid", width, height, channels);
+    std::vector<Image> res;
+    std::vector<Image> gaussian = reduceChain(*this, levels, kernels::PyramidKind::Gaussian, &res);
+    if (gaussian.empty()) return {*this};
+    res.push_back(std::move(gaussian.back()));
+    return res;
+}
+
+Image Image::collapseLaplacian(const std::vector<Image>& pyramid) {
+    if (pyramid.empty()) throw std::invalid_argument("collapseLaplacian: empty pyramid");
+    const Image& base = pyramid.front();
+    IMAGE_INSTR_SCOPE(Pyramid, static_cast<size_t>(base.getWidth()) * base.getHeight() * base.getChannels());
+    IMAGE_TRACE_SCOPE("collapse_laplacian", base.getWidth(), base.getHeight(), base.getChannels());
+    Image cur = pyramid.back();
+    for (size_t k = pyramid.size() - 1; k-- > 0;) {
+        const Image& detail = pyramid[k];
+        if (detail.getChannels() != cur.getChannels() || detail.getLayout() != cur.getLayout() ||
+            (detail.getWidth() + 1) / 2 != cur.getWidth() || (detail.getHeight() + 1) / 2 != cur.getHeight())
+            throw std::invalid_argument("collapseLaplacian: inconsistent level sizes");
+        Image next(detail.getWidth(), detail.getHeight(), detail.getChannels(), detail.getModel(), uint8_t(0),
+                   detail.getLayout());
+        const auto coarse = surfaces(static_cast<const Image&>(cur));
+        const auto d = surfaces(detail);
+        const auto dst = surfaces(next);
+        for (size_t i = 0; i < dst.size(); ++i) kernels::expandAdd(coarse[i], d[i], dst[i]);
+        cur = std::move(next);
+    }
+    return cur;
+}
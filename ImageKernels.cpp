@@ -0,0 +1,322 @@
+#include "ImageKernels.h"
+#include "ImageSimd.h"
+#include <algorithm>
+#include <cstring>
+
+namespace kernels {
+
+namespace {
+
+// Les six comparaisons se ramènent à un test d'appartenance à [lo, lo + span],
+// éventuellement inversé : un seul noyau couvre <, <=, >, >=, == et !=.
+struct Range {
+    uint8_t lo;
+    uint8_t span;
+    bool invert;
+};
+
+Range toRange(uint8_t t, Compare op) {
+    switch (op) {
+        case Compare::Less:         return t == 0 ? Range{0, 255, true} : Range{0, uint8_t(t - 1), false};
+        case Compare::LessEqual:    return Range{0, t, false};
+        case Compare::Greater:      return t == 255 ? Range{0, 255, true} : Range{uint8_t(t + 1), uint8_t(254 - t), false};
+        case Compare::GreaterEqual: return Range{t, uint8_t(255 - t), false};
+        case Compare::Equal:        return Range{t, 0, false};
+        case Compare::NotEqual:     return Range{t, 0, true};
+    }
+    return Range{0, 255, true};
+}
+
+inline bool test(uint8_t mean, const Range& r) {
+    bool inside = static_cast<uint8_t>(mean - r.lo) <= r.span;
+    return inside != r.invert;
+}
+
+inline void setBit(uint64_t* dst, size_t i) { dst[i / 64] |= uint64_t(1) << (i % 64); }
+
+// Division exacte par multiplication-décalage : floor(sum / c) == (sum * m) >> 32
+// pour sum <= 255 * c, dès que c * c * 255 < 2^32 (c < 4104).
+inline uint64_t reciprocal(int c) { return (uint64_t(1) << 32) / c + 1; }
+
+// Les versions rapides supposent dst déjà remis à zéro et traitent [begin, pixels).
+template <int C>
+void thresholdFixed(const uint8_t* src, uint64_t* dst, size_t begin, size_t pixels, const Range& r) {
+    // C = 3 : (sum * 21846) >> 16 == sum / 3 pour sum <= 765
+    for (size_t i = begin; i < pixels; ++i) {
+        const uint8_t* p = src + i * C;
+        uint32_t sum = 0;
+        for (int c = 0; c < C; ++c) sum += p[c];
+        uint32_t mean = C == 1 ? sum : C == 2 ? sum >> 1 : C == 4 ? sum >> 2 : (sum * 21846u) >> 16;
+        if (test(static_cast<uint8_t>(mean), r)) setBit(dst, i);
+    }
+}
+
+void thresholdGeneric(const uint8_t* src, uint64_t* dst, size_t pixels, int channels, const Range& r) {
+    const bool exact = channels < 4104;
+    const uint64_t m = exact ? reciprocal(channels) : 0;
+    for (size_t i = 0; i < pixels; ++i, src += channels) {
+        uint64_t sum = 0;
+        for (int c = 0; c < channels; ++c) sum += src[c];
+        uint64_t mean = exact ? (sum * m) >> 32 : sum / channels;
+        if (test(static_cast<uint8_t>(mean), r)) setBit(dst, i);
+    }
+}
+
+void thresholdDispatchScalar(const uint8_t* src, uint64_t* dst, size_t pixels, int channels, const Range& r) {
+    switch (channels) {
+        case 1: thresholdFixed<1>(src, dst, 0, pixels, r); break;
+        case 2: thresholdFixed<2>(src, dst, 0, pixels, r); break;
+        case 3: thresholdFixed<3>(src, dst, 0, pixels, r); break;
+        case 4: thresholdFixed<4>(src, dst, 0, pixels, r); break;
+        default: thresholdGeneric(src, dst, pixels, channels, r); break;
+    }
+}
+
+#ifdef IMAGE_HAVE_SSE2
+// Moyenne de 16 pixels (un octet par pixel) pour C = 1..4 canaux.
+template <int C>
+inline __m128i mean16(const uint8_t* p) {
+    const __m128i lo8 = _mm_set1_epi16(0x00FF);
+    if (C == 1) return simd::load(p);
+    if (C == 2) {
+        __m128i v0 = simd::load(p), v1 = simd::load(p + 16);
+        __m128i s0 = _mm_add_epi16(_mm_and_si128(v0, lo8), _mm_srli_epi16(v0, 8));
+        __m128i s1 = _mm_add_epi16(_mm_and_si128(v1, lo8), _mm_srli_epi16(v1, 8));
+        return _mm_packus_epi16(_mm_srli_epi16(s0, 1), _mm_srli_epi16(s1, 1));
+    }
+    if (C == 3) {
+        const __m128i zero = _mm_setzero_si128();
+        const __m128i third = _mm_set1_epi16(21846);
+        __m128i r, g, b;
+        simd::deinterleave3(p, r, g, b);
+        __m128i slo = _mm_add_epi16(_mm_add_epi16(_mm_unpacklo_epi8(r, zero), _mm_unpacklo_epi8(g, zero)),
+                                    _mm_unpacklo_epi8(b, zero));
+        __m128i shi = _mm_add_epi16(_mm_add_epi16(_mm_unpackhi_epi8(r, zero), _mm_unpackhi_epi8(g, zero)),
+                                    _mm_unpackhi_epi8(b, zero));
+        return _mm_packus_epi16(_mm_mulhi_epu16(slo, third), _mm_mulhi_epu16(shi, third));
+    }
+    // C == 4 : somme des paires en 16 bits puis des deux moitiés de chaque mot de 32 bits
+    const __m128i lo16 = _mm_set1_epi32(0x0000FFFF);
+    __m128i m[4];
+    for (int k = 0; k < 4; ++k) {
+        __m128i v = simd::load(p + 16 * k);
+        __m128i s = _mm_add_epi16(_mm_and_si128(v, lo8), _mm_srli_epi16(v, 8));
+        s = _mm_add_epi32(_mm_and_si128(s, lo16), _mm_srli_epi32(s, 16));
+        m[k] = _mm_srli_epi32(s, 2);
+    }
+    return _mm_packus_epi16(_mm_packs_epi32(m[0], m[1]), _mm_packs_epi32(m[2], m[3]));
+}
+
+// 16 comparaisons par itération, regroupées en 16 bits par movemask
+template <int C>
+void thresholdSse2(const uint8_t* src, uint64_t* dst, size_t pixels, const Range& r) {
+    const __m128i lo = _mm_set1_epi8(static_cast<char>(r.lo));
+    const __m128i span = _mm_set1_epi8(static_cast<char>(r.span));
+    const __m128i inv = _mm_set1_epi8(r.invert ? -1 : 0);
+    const __m128i zero = _mm_setzero_si128();
+    size_t i = 0;
+    for (; i + 16 <= pixels; i += 16) {
+        __m128i d = _mm_sub_epi8(mean16<C>(src + i * C), lo);
+        __m128i inside = _mm_cmpeq_epi8(_mm_subs_epu8(d, span), zero);
+        uint64_t m = static_cast<uint16_t>(_mm_movemask_epi8(_mm_xor_si128(inside, inv)));
+        dst[i / 64] |= m << (i % 64);
+    }
+    thresholdFixed<C>(src, dst, i, pixels, r);
+}
+
+// Planaire : un registre par plan, somme en 16 bits puis réciproque (c <= 16)
+void thresholdPlanarSse2(const uint8_t* planes, size_t stride, int channels, uint64_t* dst,
+                         size_t pixels, const Range& r, size_t& done) {
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i lo = _mm_set1_epi8(static_cast<char>(r.lo));
+    const __m128i span = _mm_set1_epi8(static_cast<char>(r.span));
+    const __m128i inv = _mm_set1_epi8(r.invert ? -1 : 0);
+    // (sum * m) >> 16 == sum / c pour sum <= 255 * c, c <= 16
+    const __m128i m = _mm_set1_epi16(static_cast<short>(65536 / channels + 1));
+    size_t i = 0;
+    for (; i + 16 <= pixels; i += 16) {
+        __m128i mean;
+        if (channels == 1) {
+            mean = simd::load(planes + i);
+        } else {
+            __m128i slo = zero, shi = zero;
+            for (int c = 0; c < channels; ++c) {
+                __m128i v = simd::load(planes + c * stride + i);
+                slo = _mm_add_epi16(slo, _mm_unpacklo_epi8(v, zero));
+                shi = _mm_add_epi16(shi, _mm_unpackhi_epi8(v, zero));
+            }
+            mean = _mm_packus_epi16(_mm_mulhi_epu16(slo, m), _mm_mulhi_epu16(shi, m));
+        }
+        __m128i inside = _mm_cmpeq_epi8(_mm_subs_epu8(_mm_sub_epi8(mean, lo), span), zero);
+        uint64_t bits = static_cast<uint16_t>(_mm_movemask_epi8(_mm_xor_si128(inside, inv)));
+        dst[i / 64] |= bits << (i % 64);
+    }
+    done = i;
+}
+#endif
+
+// Table d'expansion : octet de bits -> 8 octets 0x00 / 0xFF
+struct ExpandTable {
+    uint64_t v[256];
+    ExpandTable() {
+        for (int b = 0; b < 256; ++b) {
+            v[b] = 0;
+            for (int k = 0; k < 8; ++k)
+                if (b & (1 << k)) v[b] |= uint64_t(0xFF) << (8 * k);
+        }
+    }
+};
+
+inline int popcount64(uint64_t w) {
+#if defined(__GNUC__) || defined(__clang__)
+    return __builtin_popcountll(w);
+#else
+    w = w - ((w >> 1) & 0x5555555555555555ULL);
+    w = (w & 0x3333333333333333ULL) + ((w >> 2) & 0x3333333333333333ULL);
+    w = (w + (w >> 4)) & 0x0F0F0F0F0F0F0F0FULL;
+    return static_cast<int>((w * 0x0101010101010101ULL) >> 56);
+#endif
+}
+
+} // namespace
+
+void thresholdScalar(const uint8_t* src, uint64_t* dst, size_t pixels, int channels,
+                     uint8_t t, Compare op) {
+    std::fill(dst, dst + (pixels + 63) / 64, uint64_t(0));
+    for (size_t i = 0; i < pixels; ++i, src += channels) {
+        uint32_t sum = 0;
+        for (int c = 0; c < channels; ++c) sum += src[c];
+        uint8_t intensity = static_cast<uint8_t>(sum / channels);
+        bool res = false;
+        switch (op) {
+            case Compare::Less:         res = intensity < t; break;
+            case Compare::LessEqual:    res = intensity <= t; break;
+            case Compare::Greater:      res = intensity > t; break;
+            case Compare::GreaterEqual: res = intensity >= t; break;
+            case Compare::Equal:        res = intensity == t; break;
+            case Compare::NotEqual:     res = intensity != t; break;
+        }
+        if (res) setBit(dst, i);
+    }
+}
+
+void threshold(const uint8_t* src, uint64_t* dst, size_t pixels, int channels,
+               uint8_t t, Compare op) {
+    std::fill(dst, dst + (pixels + 63) / 64, uint64_t(0));
+    if (pixels == 0) return;
+    const Range r = toRange(t, op);
+#ifdef IMAGE_HAVE_SSE2
+    switch (channels) {
+        case 1: thresholdSse2<1>(src, dst, pixels, r); return;
+        case 2: thresholdSse2<2>(src, dst, pixels, r); return;
+        case 3: thresholdSse2<3>(src, dst, pixels, r); return;
+        case 4: thresholdSse2<4>(src, dst, pixels, r); return;
+        default: break;
+    }
+#endif
+    thresholdDispatchScalar(src, dst, pixels, channels, r);
+}
+
+void thresholdPlanar(const uint8_t* planes, size_t planeStride, int channels, uint64_t* dst,
+                     size_t pixels, uint8_t t, Compare op) {
+    std::fill(dst, dst + (pixels + 63) / 64, uint64_t(0));
+    if (pixels == 0) return;
+    const Range r = toRange(t, op);
+    size_t i = 0;
+#ifdef IMAGE_HAVE_SSE2
+    if (channels <= 16) thresholdPlanarSse2(planes, planeStride, channels, dst, pixels, r, i);
+#endif
+    const bool exact = channels < 4104;
+    const uint64_t m = exact ? reciprocal(channels) : 0;
+    for (; i < pixels; ++i) {
+        uint64_t sum = 0;
+        for (int c = 0; c < channels; ++c) sum += planes[c * planeStride + i];
+        uint64_t mean = exact ? (sum * m) >> 32 : sum / channels;
+        if (test(static_cast<uint8_t>(mean), r)) setBit(dst, i);
+    }
+}
+
+void expandBits(const uint64_t* bits, uint8_t* dst, size_t pixels, uint8_t on, uint8_t off) {
+    static const ExpandTable table;
+    const uint64_t fill = off * 0x0101010101010101ULL;
+    const uint64_t flip = static_cast<uint8_t>(on ^ off) * 0x0101010101010101ULL;
+    size_t i = 0;
+    for (; i + 8 <= pixels; i += 8) {
+        uint8_t b = static_cast<uint8_t>(bits[i / 64] >> (i % 64));
+        uint64_t v = fill ^ (flip & table.v[b]);
+        std::memcpy(dst + i, &v, 8);
+    }
+    for (; i < pixels; ++i)
+        dst[i] = ((bits[i / 64] >> (i % 64)) & 1) ? on : off;
+}
+
+// === LAYOUT ===
+void deinterleave(const uint8_t* src, uint8_t* dst, size_t pixels, int channels) {
+    size_t i = 0;
+#ifdef IMAGE_HAVE_SSE2
+    const size_t n = pixels;
+    __m128i a, b, c, d;
+    switch (channels) {
+        case 2:
+            for (; i + 16 <= pixels; i += 16) {
+                simd::deinterleave2(src + i * 2, a, b);
+                simd::store(dst + i, a); simd::store(dst + n + i, b);
+            }
+            break;
+        case 3:
+            for (; i + 16 <= pixels; i += 16) {
+                simd::deinterleave3(src + i * 3, a, b, c);
+                simd::store(dst + i, a); simd::store(dst + n + i, b); simd::store(dst + 2 * n + i, c);
+            }
+            break;
+        case 4:
+            for (; i + 16 <= pixels; i += 16) {
+                simd::deinterleave4(src + i * 4, a, b, c, d);
+                simd::store(dst + i, a); simd::store(dst + n + i, b);
+                simd::store(dst + 2 * n + i, c); simd::store(dst + 3 * n + i, d);
+            }
+            break;
+        default:
+            break;
+    }
+#endif
+    for (; i < pixels; ++i)
+        for (int c = 0; c < channels; ++c)
+            dst[c * pixels + i] = src[i * channels + c];
+}
+
+void interleave(const uint8_t* src, uint8_t* dst, size_t pixels, int channels) {
+    size_t i = 0;
+#ifdef IMAGE_HAVE_SSE2
+    const size_t n = pixels;
+    switch (channels) {
+        case 2:
+            for (; i + 16 <= pixels; i += 16)
+                simd::interleave2(dst + i * 2, simd::load(src + i), simd::load(src + n + i));
+            break;
+        case 3:
+            for (; i + 16 <= pixels; i += 16)
+                simd::interleave3(dst + i * 3, simd::load(src + i), simd::load(src + n + i),
+                                  simd::load(src + 2 * n + i));
+            break;
+        case 4:
+            for (; i + 16 <= pixels; i += 16)
+                simd::interleave4(dst + i * 4, simd::load(src + i), simd::load(src + n + i),
+                                  simd::load(src + 2 * n + i), simd::load(src + 3 * n + i));
+            break;
+        default:
+            break;
+    }
+#endif
+    for (; i < pixels; ++i)
+        for (int c = 0; c < channels; ++c)
+            dst[i * channels + c] = src[c * pixels + i];
+}
+
+size_t popcount(const uint64_t* words, size_t count) {
+    size_t total = 0;
+    for (size_t i = 0; i < count; ++i) total += popcount64(words[i]);
+    return total;
+}
+
+} // namespace kernels
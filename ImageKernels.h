@@ -0,0 +1,254 @@
+#ifndef IMAGE_KERNELS_H
+#define IMAGE_KERNELS_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "ColorModel.h"
+#include "Kernel.h"
+#include "StructuringElement.h"
+
+// Noyaux bas niveau sur buffers bruts, utilisés par Image.
+// Chaque noyau accéléré a une version "Scalar" de référence (boucle naïve),
+// dont il doit reproduire le résultat au bit près.
+namespace kernels {
+
+enum class Compare : uint8_t { Less, LessEqual, Greater, GreaterEqual, Equal, NotEqual };
+
+// Seuillage de `pixels` pixels entrelacés à `channels` canaux, résultat en bits :
+// bit i de dst = (somme des canaux du pixel i / channels) op t.
+// dst reçoit (pixels + 63) / 64 mots, bits de bourrage à 0.
+void threshold(const uint8_t* src, uint64_t* dst, size_t pixels, int channels,
+               uint8_t t, Compare op);
+void thresholdScalar(const uint8_t* src, uint64_t* dst, size_t pixels, int channels,
+                     uint8_t t, Compare op);
+
+// Même seuillage sur une image planaire : le canal c du pixel i est planes[c * planeStride + i]
+void thresholdPlanar(const uint8_t* planes, size_t planeStride, int channels, uint64_t* dst,
+                     size_t pixels, uint8_t t, Compare op);
+
+// Expansion bits -> octets : dst[i] = bit i ? on : off
+void expandBits(const uint64_t* bits, uint8_t* dst, size_t pixels, uint8_t on, uint8_t off);
+
+// Nombre de bits à 1 dans `count` mots
+size_t popcount(const uint64_t* words, size_t count);
+
+// === LAYOUT ===
+// Entrelacé -> planaire : le plan c commence à dst + c * pixels (et inversement)
+void deinterleave(const uint8_t* src, uint8_t* dst, size_t pixels, int channels);
+void interleave(const uint8_t* src, uint8_t* dst, size_t pixels, int channels);
+
+// === CONVERSIONS DE MODÈLE (ColorConvert.cpp) ===
+// Arithmétique en virgule fixe (Q15 aller, Q14 retour), identique entre
+// les chemins SSE2 et les références scalaires.
+// src/dst entrelacés ; srcChannels/dstChannels indiquent la présence d'alpha
+// (3 = RGB, 4 = RGBA ; 1 = GRAY, 2 = GRAYA). Alpha recopié, ou 255 s'il est ajouté.
+
+void rgbToGray(const uint8_t* src, int srcChannels, uint8_t* dst, int dstChannels,
+               size_t pixels, LumaStandard standard);
+void rgbToGrayScalar(const uint8_t* src, int srcChannels, uint8_t* dst, int dstChannels,
+                     size_t pixels, LumaStandard standard);
+
+void rgbToYuv(const uint8_t* src, int srcChannels, uint8_t* dst, size_t pixels, LumaStandard standard);
+void rgbToYuvScalar(const uint8_t* src, int srcChannels, uint8_t* dst, size_t pixels, LumaStandard standard);
+void yuvToRgb(const uint8_t* src, uint8_t* dst, int dstChannels, size_t pixels, LumaStandard standard);
+void yuvToRgbScalar(const uint8_t* src, uint8_t* dst, int dstChannels, size_t pixels, LumaStandard standard);
+
+// HSV 8 bits : teinte 0..255 pour 0..360°, tables de division (pas de gather en SSE2)
+void rgbToHsv(const uint8_t* src, int srcChannels, uint8_t* dst, size_t pixels);
+void hsvToRgb(const uint8_t* src, uint8_t* dst, int dstChannels, size_t pixels);
+
+// GRAY(A) -> RGB(A) par réplication
+void grayToRgb(const uint8_t* src, int srcChannels, uint8_t* dst, int dstChannels, size_t pixels);
+// Ajout (255) ou suppression du canal alpha : 1 <-> 2 ou 3 <-> 4 canaux
+void convertAlpha(const uint8_t* src, int srcChannels, uint8_t* dst, int dstChannels, size_t pixels);
+
+// === VOISINAGES ===
+// Pixels entrelacés adressés par ligne : le canal c du pixel (x, y) est
+// data[y * stride + x * channels + c]. Une image planaire se traite comme
+// `channels` surfaces à un canal.
+template <typename T>
+struct BasicSurface {
+    T* data = nullptr;
+    int width = 0;
+    int height = 0;
+    int channels = 0;
+    size_t stride = 0;
+
+    T* row(int y) const { return data + static_cast<size_t>(y) * stride; }
+};
+using Surface = BasicSurface<uint8_t>;
+using ConstSurface = BasicSurface<const uint8_t>;
+
+// Indice lu pour la position i (éventuellement hors de [0, n)) ; -1 pour Border::Zero hors de l'image
+int borderIndex(int i, int n, Border border);
+// Ligne élargie de r pixels de chaque côté selon border : out reçoit (width + 2r) * channels octets
+void padRow(const uint8_t* src, int width, int channels, int r, Border border, uint8_t* out);
+
+// === CONVOLUTION (Convolution.cpp) ===
+// Arithmétique en virgule fixe : poids quantifiés sur 16 bits, sommes sur
+// 32 bits, arrondi au plus proche puis saturation à [0, 255]. Le séparable
+// passe par un intermédiaire 16 bits (passe horizontale puis verticale).
+// src et dst : mêmes dimensions, buffers distincts. Les versions rapides
+// traitent des bandes de lignes en parallèle (parallel::forRange).
+// std::invalid_argument si les poids sont trop grands pour le 8 bits.
+
+// Noyau horizontal h (hw poids) puis vertical v (vh poids), tailles impaires
+void convolveSeparable(const ConstSurface& src, const Surface& dst, const float* h, int hw,
+                       const float* v, int vh, Border border);
+void convolveSeparableScalar(const ConstSurface& src, const Surface& dst, const float* h, int hw,
+                             const float* v, int vh, Border border);
+// false si le passage par l'intermédiaire 16 bits perdrait trop de précision
+// (somme des |h| au-delà de 128) : utiliser convolve2D
+bool separableFits(const float* h, int hw);
+
+void convolve2D(const ConstSurface& src, const Surface& dst, const Kernel& kernel, Border border);
+void convolve2DScalar(const ConstSurface& src, const Surface& dst, const Kernel& kernel, Border border);
+
+// === FLOU PAR SOMMES GLISSANTES (Blur.cpp) ===
+// Moyennes sur des fenêtres de 2r+1 pixels, en place : (somme + n/2) / n,
+// arrondi à chaque passe. Coût par pixel indépendant du rayon. radii donne
+// les passes successives (plusieurs passes : approximation gaussienne) ;
+// rayon 0 = passe sautée. Lignes ou blocs de colonnes répartis entre threads.
+void boxBlurRows(const Surface& s, const int* radii, int passes, Border border);
+void boxBlurColumns(const Surface& s, const int* radii, int passes, Border border);
+// Références : fenêtre entièrement sommée pour chaque pixel
+void boxBlurRowsScalar(const Surface& s, const int* radii, int passes, Border border);
+void boxBlurColumnsScalar(const Surface& s, const int* radii, int passes, Border border);
+
+// Rayons de `passes` flous moyens dont la succession approche une gaussienne
+// d'écart type sigma (largeurs impaires consécutives, variance totale ≈ sigma²)
+void gaussianBoxRadii(double sigma, int passes, int* radii);
+
+// === FILTRES DE RANG (Rank.cpp) ===
+// dst reçoit la k-ième plus petite valeur (0 <= k < (2r+1)²) de la fenêtre
+// (2r+1) x (2r+1) centrée, canal par canal ; Border::Zero compte des 0.
+// src et dst : mêmes dimensions, buffers distincts. Réseaux de tri SSE2
+// (16 échantillons à la fois) jusqu'à r = 2, histogrammes glissants au-delà
+// (coût par pixel indépendant de r) ; bandes ou tuiles en parallèle.
+// std::invalid_argument si r > maxRankRadius ((2r+1)² tient dans un int).
+constexpr int maxRankRadius = 16383;
+void rankFilter(const ConstSurface& src, const Surface& dst, int radius, int k, Border border);
+// Référence : fenêtre recopiée puis std::nth_element pour chaque échantillon
+void rankFilterScalar(const ConstSurface& src, const Surface& dst, int radius, int k, Border border);
+
+// === MORPHOLOGIE (Morphology.cpp) ===
+// dst(x, y) = minimum ou maximum de src(x + dx, y + dy) sur les points actifs
+// de l'élément (centre en (0, 0)), canal par canal ; Border::Zero lit des 0.
+// src et dst : mêmes dimensions, buffers distincts. Rectangle : van Herk /
+// Gil-Werman ligne puis colonne, trois comparaisons par échantillon quel que
+// soit le rayon. Autre forme : segments horizontaux, un passage vHGW par
+// longueur de segment distincte. Bandes de lignes en parallèle.
+enum class Extremum : uint8_t { Min, Max };
+void windowExtremum(const ConstSurface& src, const Surface& dst, const StructuringElement& se, Extremum ext,
+                    Border border);
+void windowExtremumScalar(const ConstSurface& src, const Surface& dst, const StructuringElement& se, Extremum ext,
+                          Border border);
+
+// Même calcul sur des masques 1 bit (format de Mask, bourrage à 0) : OU de
+// src(x + dx, y + dy), 0 hors du masque ; 64 pixels par opération, décalages
+// de mots pour les segments horizontaux, vHGW vertical pour un rectangle.
+void windowOrBits(const uint64_t* src, uint64_t* dst, int width, int height, int wordsPerRow,
+                  const StructuringElement& se);
+void windowOrBitsScalar(const uint64_t* src, uint64_t* dst, int width, int height, int wordsPerRow,
+                        const StructuringElement& se);
+
+// === RÉÉCHANTILLONNAGE (Resize.cpp) ===
+// Poids d'une dimension : la sortie i lit `taps` entrées consécutives à partir
+// de start[i]. Les poids hors de [0, n) sont repliés sur le bord ; poids Q14
+// de somme 16384, taps pair (poids nuls en complément, lus dans [0, n + 1]).
+struct ResampleTable {
+    int taps = 0;
+    std::vector<int> start;
+    std::vector<int16_t> weights;  // taps poids par sortie
+};
+ResampleTable resampleTable(int srcSize, int dstSize, ResizeFilter filter);
+
+// src -> dst, tailles quelconques (au moins 1), mêmes canaux. Passe horizontale
+// vers un intermédiaire 16 bits (6 bits de fraction) puis verticale, arrondi
+// et saturation à la fin : SSE2 (pmaddwd), bandes de lignes de sortie en
+// parallèle. Nearest : copie par index ; Area par un facteur 2^k (k <= 4) :
+// sommes de blocs, même résultat que les tables.
+void resize(const ConstSurface& src, const Surface& dst, ResizeFilter filter);
+// Référence : mêmes tables, boucles naïves sur l'image entière
+void resizeScalar(const ConstSurface& src, const Surface& dst, ResizeFilter filter);
+
+// === PYRAMIDES (Pyramid.cpp) ===
+// Réductions par 2 successives : levels[k] mesure ceil(w / 2) x ceil(h / 2) du
+// niveau précédent (levels[0] : réduction de src), dimensions fixées par
+// l'appelant. Box : moyenne 2x2 arrondie, dernière ligne / colonne répétée si
+// impaire. Gaussian : binomial 5x5 (1 4 6 4 1)² / 256 en miroir, échantillons
+// pairs conservés.
+enum class PyramidKind : uint8_t { Box, Gaussian };
+// Un seul passage sur src : chaque ligne produite alimente aussitôt le niveau
+// suivant (anneau de 2 ou 5 lignes 16 bits par niveau), qui ne relit que des
+// lignes encore en cache. laplacian (Gaussian, count surfaces de la taille du
+// niveau au-dessus) : G_k - expand(G_k+1) + 128 saturé, calculé à la volée.
+void pyramid(const ConstSurface& src, const Surface* levels, int count, PyramidKind kind,
+             const Surface* laplacian = nullptr);
+// Référence : chaque niveau calculé naïvement depuis le précédent complet
+void pyramidScalar(const ConstSurface& src, const Surface* levels, int count, PyramidKind kind,
+                   const Surface* laplacian = nullptr);
+// Reconstruction d'un niveau : dst = detail - 128 + expand(coarse), saturé
+void expandAdd(const ConstSurface& coarse, const ConstSurface& detail, const Surface& dst);
+
+// === ORIENTATION (Orientation.cpp) ===
+// Transpose, Rotate90, Transverse et Rotate270 échangent largeur et hauteur
+inline bool swapsAxes(Orientation o) { return o >= Orientation::Transpose; }
+// dst aux dimensions de l'image orientée. Quarts de tour par blocs transposés
+// en SSE2 (16 x 16 octets, 8 x 8 pixels de 2 octets, 4 x 4 de 4 octets, trois
+// plans de 16 x 16 pour 3 canaux ; tuiles scalaires au-delà), miroirs par
+// inversion de 16 octets ou 16 pixels ; bandes de lignes de dst en parallèle.
+void orient(const ConstSurface& src, const Surface& dst, Orientation o);
+// Référence : un pixel à la fois
+void orientScalar(const ConstSurface& src, const Surface& dst, Orientation o);
+// Sans copie de la surface : miroirs et demi-tour sur toute surface, quarts de
+// tour sur une surface carrée seulement (transposition par échange de blocs
+// puis miroir)
+void orientInPlace(const Surface& s, Orientation o);
+
+// === DÉFORMATIONS (Warp.cpp) ===
+// Matrice sortie -> entrée quantifiée : chaque ligne r donne un numérateur
+// entier q[r] · (x, y, 1), exact sur toute la sortie (|.| < 2^52), à l'échelle
+// 2^shift[r] propre à la ligne. Position d'échantillonnage en 1/256 de pixel :
+// décalage de X, Y (affine) ou X / W, Y / W en double (perspective, W <= 0 :
+// hors champ). Les deux versions de warp font les mêmes calculs entiers, la
+// rapide par incréments le long des lignes.
+struct WarpMap {
+    int64_t q[3][3];
+    int shift[3];
+    double scale[2];  // perspective : 2^(shift[2] - shift[r] + 8)
+    bool affine;
+};
+// inverse : matrice 3x3 ligne par ligne ; std::invalid_argument si une
+// coordonnée dépasse la plage représentable sur cette sortie
+WarpMap warpMap(const double* inverse, int dstWidth, int dstHeight);
+// Tuiles de 64 x 32 pixels de dst, bandes en parallèle ; Border::Zero : noir
+void warp(const ConstSurface& src, const Surface& dst, const WarpMap& map, Interpolation interp, Border border);
+// Référence : numérateurs recalculés par produit en chaque pixel, ligne par ligne
+void warpScalar(const ConstSurface& src, const Surface& dst, const WarpMap& map, Interpolation interp, Border border);
+
+// === COMPOSITION (Composite.cpp) ===
+// Porter-Duff en place, dst = src op dst, surfaces entrelacées de même taille,
+// alpha non prémultiplié en dernier canal. src : 2 ou 4 canaux ; dst : autant,
+// ou un de moins (opaque, alpha résultant ignoré). Avec les facteurs entiers
+// fs, fd de l'opérateur (0..255) : ps = fs·αs, pd = fd·αd, D = ps + pd,
+// couleur = (ps·cs + pd·cd + D / 2) / D (inchangée si D = 0, pixel transparent),
+// alpha = (D + 127) / 255.
+void composite(const ConstSurface& src, const Surface& dst, Composite op);
+void compositeScalar(const ConstSurface& src, const Surface& dst, Composite op);
+
+// === COMBINAISONS LINÉAIRES (Blend.cpp) ===
+// dst = round(Σ weights[k]·src[k] + offset) saturé à [0, 255], octet par octet,
+// en un passage. Poids int16 et décalage sur une même base 2^shift (la plus
+// fine possible, somme des poids conservée), accumulation int32 et un seul
+// arrondi final. Les n sources ont les canaux de dst et peuvent être plus
+// petites : elles valent 0 au-delà de leurs bords (règle des opérateurs +, -, ^).
+// std::invalid_argument si un poids n'est pas fini ou trop grand pour le 8 bits.
+void linearCombination(const ConstSurface* src, const double* weights, int n, double offset, const Surface& dst);
+void linearCombinationScalar(const ConstSurface* src, const double* weights, int n, double offset,
+                             const Surface& dst);
+
+} // namespace kernels
+
+#endif
@@ -0,0 +1,95 @@
+#ifndef IMAGE_SIMD_H
+#define IMAGE_SIMD_H
+
+#include <cstdint>
+
+// Aides SSE2 internes aux noyaux vectorisés (non exposées par Image.h).
+// Sans SSE2 (ex. ARM), les noyaux retombent sur des boucles scalaires
+// écrites pour être vectorisées automatiquement par le compilateur.
+// -DIMAGE_NO_SIMD force ces boucles scalaires (comparaison, débogage).
+
+#if (defined(__SSE2__) || defined(_M_X64)) && !defined(IMAGE_NO_SIMD)
+#define IMAGE_HAVE_SSE2 1
+#include <emmintrin.h>
+
+namespace simd {
+
+inline __m128i load(const uint8_t* p) { return _mm_loadu_si128(reinterpret_cast<const __m128i*>(p)); }
+inline void store(uint8_t* p, __m128i v) { _mm_storeu_si128(reinterpret_cast<__m128i*>(p), v); }
+
+// Désentrelace 48 octets RGBRGB... en trois registres R, G, B (16 pixels).
+// Quatre tours de unpack, sans pshufb (SSSE3 non garanti sur x86-64 de base).
+inline void deinterleave3(const uint8_t* p, __m128i& a, __m128i& b, __m128i& c) {
+    __m128i t00 = load(p), t01 = load(p + 16), t02 = load(p + 32);
+
+    __m128i t10 = _mm_unpacklo_epi8(t00, _mm_unpackhi_epi64(t01, t01));
+    __m128i t11 = _mm_unpacklo_epi8(_mm_unpackhi_epi64(t00, t00), t02);
+    __m128i t12 = _mm_unpacklo_epi8(t01, _mm_unpackhi_epi64(t02, t02));
+
+    __m128i t20 = _mm_unpacklo_epi8(t10, _mm_unpackhi_epi64(t11, t11));
+    __m128i t21 = _mm_unpacklo_epi8(_mm_unpackhi_epi64(t10, t10), t12);
+    __m128i t22 = _mm_unpacklo_epi8(t11, _mm_unpackhi_epi64(t12, t12));
+
+    __m128i t30 = _mm_unpacklo_epi8(t20, _mm_unpackhi_epi64(t21, t21));
+    __m128i t31 = _mm_unpacklo_epi8(_mm_unpackhi_epi64(t20, t20), t22);
+    __m128i t32 = _mm_unpacklo_epi8(t21, _mm_unpackhi_epi64(t22, t22));
+
+    a = _mm_unpacklo_epi8(t30, _mm_unpackhi_epi64(t31, t31));
+    b = _mm_unpacklo_epi8(_mm_unpackhi_epi64(t30, t30), t32);
+    c = _mm_unpacklo_epi8(t31, _mm_unpackhi_epi64(t32, t32));
+}
+
+// Inverse de deinterleave3 : chaque tour défait un tour d'unpack en séparant
+// octets pairs/impairs (masque, décalage) puis en les recompactant (packus).
+inline void interleave3(uint8_t* p, __m128i a, __m128i b, __m128i c) {
+    const __m128i lo8 = _mm_set1_epi16(0x00FF);
+    for (int round = 0; round < 4; ++round) {
+        __m128i x0 = _mm_packus_epi16(_mm_and_si128(a, lo8), _mm_and_si128(b, lo8));
+        __m128i x1 = _mm_packus_epi16(_mm_and_si128(c, lo8), _mm_srli_epi16(a, 8));
+        __m128i x2 = _mm_packus_epi16(_mm_srli_epi16(b, 8), _mm_srli_epi16(c, 8));
+        a = x0; b = x1; c = x2;
+    }
+    store(p, a); store(p + 16, b); store(p + 32, c);
+}
+
+// 64 octets RGBARGBA... -> quatre registres (16 pixels), par masques et décalages 32 bits
+inline void deinterleave4(const uint8_t* p, __m128i& a, __m128i& b, __m128i& c, __m128i& d) {
+    const __m128i lo = _mm_set1_epi32(0xFF);
+    __m128i v[4], ch[4][4];
+    for (int k = 0; k < 4; ++k) {
+        v[k] = load(p + 16 * k);
+        ch[0][k] = _mm_and_si128(v[k], lo);
+        ch[1][k] = _mm_and_si128(_mm_srli_epi32(v[k], 8), lo);
+        ch[2][k] = _mm_and_si128(_mm_srli_epi32(v[k], 16), lo);
+        ch[3][k] = _mm_srli_epi32(v[k], 24);
+    }
+    __m128i* out[4] = {&a, &b, &c, &d};
+    for (int i = 0; i < 4; ++i)
+        *out[i] = _mm_packus_epi16(_mm_packs_epi32(ch[i][0], ch[i][1]), _mm_packs_epi32(ch[i][2], ch[i][3]));
+}
+
+inline void interleave4(uint8_t* p, __m128i a, __m128i b, __m128i c, __m128i d) {
+    __m128i ab0 = _mm_unpacklo_epi8(a, b), ab1 = _mm_unpackhi_epi8(a, b);
+    __m128i cd0 = _mm_unpacklo_epi8(c, d), cd1 = _mm_unpackhi_epi8(c, d);
+    store(p, _mm_unpacklo_epi16(ab0, cd0));
+    store(p + 16, _mm_unpackhi_epi16(ab0, cd0));
+    store(p + 32, _mm_unpacklo_epi16(ab1, cd1));
+    store(p + 48, _mm_unpackhi_epi16(ab1, cd1));
+}
+
+inline void deinterleave2(const uint8_t* p, __m128i& a, __m128i& b) {
+    const __m128i lo8 = _mm_set1_epi16(0x00FF);
+    __m128i v0 = load(p), v1 = load(p + 16);
+    a = _mm_packus_epi16(_mm_and_si128(v0, lo8), _mm_and_si128(v1, lo8));
+    b = _mm_packus_epi16(_mm_srli_epi16(v0, 8), _mm_srli_epi16(v1, 8));
+}
+
+inline void interleave2(uint8_t* p, __m128i a, __m128i b) {
+    store(p, _mm_unpacklo_epi8(a, b));
+    store(p + 16, _mm_unpackhi_epi8(a, b));
+}
+
+} // namespace simd
+#endif
+
+#endif
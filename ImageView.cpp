@@ -0,0 +1,130 @@
+#include "Image.h"
+#include "ImageKernels.h"
+#include "Instrumentation.h"
+#include "Trace.h"
+#include <algorithm>
+#include <cstring>
+#include <functional>
+
+// === VUES ===
+ImageView::ImageView(const Image& img)
+    : origin(img.getData()), width(img.getWidth()), height(img.getHeight()), channels(img.getChannels()),
+      model(img.getModel()), layout(img.getLayout()),
+      stride(static_cast<size_t>(width) * (layout == Layout::Interleaved ? channels : 1)),
+      planeStride(static_cast<size_t>(width) * height) {}
+
+int ImageView::getWidth() const { return width; }
+int ImageView::getHeight() const { return height; }
+int ImageView::getChannels() const { return channels; }
+ColorModel ImageView::getModel() const { return model; }
+Layout ImageView::getLayout() const { return layout; }
+size_t ImageView::getStride() const { return stride; }
+
+const uint8_t* ImageView::row(int y, int c) const {
+    return origin + static_cast<size_t>(y) * stride + (layout == Layout::Planar ? c * planeStride : 0);
+}
+
+const uint8_t& ImageView::at(int x, int y, int c) const {
+    if (x < 0 || x >= width || y < 0 || y >= height || c < 0 || c >= channels)
+        throw std::out_of_range("Pixel coordinates out of bounds");
+    return layout == Layout::Planar ? row(y, c)[x] : row(y)[static_cast<size_t>(x) * channels + c];
+}
+
+ImageView ImageView::crop(int x, int y, int w, int h) const {
+    if (w <= 0 || h <= 0) throw std::invalid_argument("crop: dimensions must be positive");
+    if (x < 0 || y < 0 || x > width - w || y > height - h) throw std::out_of_range("crop: rectangle out of bounds");
+    ImageView v = *this;
+    v.origin = row(y) + static_cast<size_t>(x) * (layout == Layout::Interleaved ? channels : 1);
+    v.width = w;
+    v.height = h;
+    return v;
+}
+
+Image::Image(const ImageView& view)
+    : width(view.width), height(view.height), channels(view.channels), model(view.model), layout(view.layout) {
+    IMAGE_TRACE_SCOPE("from_view", width, height, channels);
+    const size_t rowBytes = static_cast<size_t>(width) * (layout == Layout::Interleaved ? channels : 1);
+    const int planes = layout == Layout::Planar ? channels : 1;
+    data.resize(rowBytes * height * planes);
+    IMAGE_INSTR_DUP(data.size());
+    uint8_t* out = data.data();
+    for (int c = 0; c < planes; ++c)
+        for (int y = 0; y < height; ++y, out += rowBytes) std::memcpy(out, view.row(y, c), rowBytes);
+}
+
+// === RECTANGLES ===
+namespace {
+
+// Rectangle couvert par une vue de w x h posée en (x, y) sur une image W x H
+struct Overlap {
+    int x0, y0, x1, y1;
+    bool empty() const { return x0 >= x1 || y0 >= y1; }
+};
+
+Overlap overlap(int x, int y, int w, int h, int W, int H) {
+    return {std::max(x, 0), std::max(y, 0), static_cast<int>(std::min<long long>(W, static_cast<long long>(x) + w)),
+            static_cast<int>(std::min<long long>(H, static_cast<long long>(y) + h))};
+}
+
+// La vue lit-elle le buffer de img (paste / composite d'une partie de soi-même) ?
+bool aliases(const ImageView& v, const Image& img) {
+    const uint8_t* p = v.row(0);
+    const uint8_t* begin = img.getData();
+    const uint8_t* end = begin + static_cast<size_t>(img.getWidth()) * img.getHeight() * img.getChannels();
+    return std::less_equal<const uint8_t*>()(begin, p) && std::less<const uint8_t*>()(p, end);
+}
+
+} // namespace
+
+ImageView Image::crop(int x, int y, int w, int h) const { return ImageView(*this).crop(x, y, w, h); }
+
+Image& Image::paste(const ImageView& src, int x, int y) {
+    if (src.channels != channels || src.model != model) throw std::invalid_argument("Incompatible channels or model");
+    const Overlap o = overlap(x, y, src.width, src.height, width, height);
+    if (o.empty()) return *this;
+    const ImageView part = src.crop(o.x0 - x, o.y0 - y, o.x1 - o.x0, o.y1 - o.y0);
+    // Recouvrement possible avec soi-même, ou autre layout : passage par une copie
+    if (aliases(part, *this)) return paste(Image(part), o.x0, o.y0);
+    if (part.layout != layout) return paste(Image(part).toLayout(layout), o.x0, o.y0);
+
+    IMAGE_INSTR_SCOPE(Composite, static_cast<size_t>(part.width) * part.height * channels);
+    IMAGE_TRACE_SCOPE("paste", part.width, part.height, channels);
+    const int planes = layout == Layout::Planar ? channels : 1;
+    const size_t pixelBytes = layout == Layout::Interleaved ? channels : 1;
+    const size_t rowBytes = part.width * pixelBytes, dstStride = static_cast<size_t>(width) * pixelBytes;
+    for (int c = 0; c < planes; ++c) {
+        uint8_t* out = data.data() + static_cast<size_t>(c) * width * height + o.y0 * dstStride + o.x0 * pixelBytes;
+        for (int r = 0; r < part.height; ++r, out += dstStride) std::memcpy(out, part.row(r, c), rowBytes);
+    }
+    return *this;
+}
+
+Image& Image::composite(const ImageView& src, int x, int y, Composite op) {
+    const bool alpha = src.model == ColorModel::RGBA || src.model == ColorModel::GRAYA;
+    const bool opaque = (src.model == ColorModel::RGBA && model == ColorModel::RGB) ||
+                        (src.model == ColorModel::GRAYA && model == ColorModel::GRAY);
+    if (!alpha || (src.model != model && !opaque))
+        throw std::invalid_argument("composite: source needs alpha and a matching model");
+    const Overlap o = overlap(x, y, src.width, src.height, width, height);
+    if (o.empty()) return *this;
+    const int w = o.x1 - o.x0, h = o.y1 - o.y0;
+    const ImageView part = src.crop(o.x0 - x, o.y0 - y, w, h);
+    // Noyau sur pixels entrelacés : copies pour une source qui recouvre *this
+    // ou planaire, et zone de *this passée en entrelacé le temps du mélange
+    if (aliases(part, *this)) return composite(Image(part), o.x0, o.y0, op);
+    if (part.layout != Layout::Interleaved) return composite(Image(part).toLayout(Layout::Interleaved), o.x0, o.y0, op);
+    if (layout != Layout::Interleaved) {
+        Image area = Image(crop(o.x0, o.y0, w, h)).toLayout(Layout::Interleaved);
+        area.composite(part, 0, 0, op);
+        return paste(area.toLayout(layout), o.x0, o.y0);
+    }
+
+    IMAGE_INSTR_SCOPE(Composite, static_cast<size_t>(w) * h * (part.channels + channels));
+    IMAGE_TRACE_SCOPE("composite", w, h, channels);
+    const kernels::ConstSurface s{part.origin, w, h, part.channels, part.stride};
+    const size_t dstStride = static_cast<size_t>(width) * channels;
+    const kernels::Surface d{data.data() + o.y0 * dstStride + static_cast<size_t>(o.x0) * channels, w, h, channels,
+                             dstStride};
+    kernels::composite(s, d, op);
+    return *this;
+}
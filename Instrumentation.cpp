@@ -0,0 +1,162 @@
+#include "Instrumentation.h"
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+
+namespace instr {
+
+namespace {
+
+// Compteurs atomiques (relaxed) : les opérateurs peuvent tourner sur plusieurs threads
+struct Counters {
+    std::atomic<uint64_t> calls{0};
+    std::atomic<uint64_t> bytes{0};
+    std::atomic<uint64_t> nanoseconds{0};
+    std::atomic<uint64_t> allocations{0};
+    std::atomic<uint64_t> allocatedBytes{0};
+    std::atomic<uint64_t> copies{0};
+    std::atomic<uint64_t> copiedBytes{0};
+};
+
+constexpr size_t opCount = static_cast<size_t>(Op::Count);
+std::array<Counters, opCount> counters;
+
+// Opérateur le plus interne en cours sur ce thread
+thread_local Op current = Op::Other;
+
+Counters& at(Op op) { return counters[static_cast<size_t>(op)]; }
+
+void add(std::atomic<uint64_t>& c, uint64_t v) { c.fetch_add(v, std::memory_order_relaxed); }
+
+uint64_t now() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+               std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// IMAGE_INSTR_OUT=fichier.json : écrit les compteurs à la fin du programme
+struct DumpAtExit {
+    ~DumpAtExit() {
+        if (!enabled) return;
+        if (const char* path = std::getenv("IMAGE_INSTR_OUT")) dumpJson(path);
+    }
+} dumpAtExit;
+
+} // namespace
+
+const char* name(Op op) {
+    switch (op) {
+        case Op::Other:     return "other";
+        case Op::Load:      return "load";
+        case Op::Save:      return "save";
+        case Op::Decode:    return "decode";
+        case Op::Encode:    return "encode";
+        case Op::Add:       return "add";
+        case Op::Sub:       return "sub";
+        case Op::Diff:      return "diff";
+        case Op::Mul:       return "mul";
+        case Op::Div:       return "div";
+        case Op::Invert:    return "invert";
+        case Op::Threshold: return "threshold";
+        case Op::FromMask:  return "from_mask";
+        case Op::Convert:   return "convert";
+        case Op::ToLayout:  return "to_layout";
+        case Op::Enlarge:   return "enlarge";
+        case Op::Convolve:  return "convolve";
+        case Op::Blur:      return "blur";
+        case Op::Rank:      return "rank";
+        case Op::Morphology: return "morphology";
+        case Op::Resize:    return "resize";
+        case Op::Pyramid:   return "pyramid";
+        case Op::Orient:    return "orient";
+        case Op::Warp:      return "warp";
+        case Op::Composite: return "composite";
+        case Op::Blend:     return "blend";
+        default:            return "unknown";
+    }
+}
+
+Stats stats(Op op) {
+    const Counters& c = at(op);
+    Stats s;
+    s.calls = c.calls.load(std::memory_order_relaxed);
+    s.bytes = c.bytes.load(std::memory_order_relaxed);
+    s.nanoseconds = c.nanoseconds.load(std::memory_order_relaxed);
+    s.allocations = c.allocations.load(std::memory_order_relaxed);
+    s.allocatedBytes = c.allocatedBytes.load(std::memory_order_relaxed);
+    s.copies = c.copies.load(std::memory_order_relaxed);
+    s.copiedBytes = c.copiedBytes.load(std::memory_order_relaxed);
+    return s;
+}
+
+void reset() {
+    for (Counters& c : counters) {
+        c.calls = 0;
+        c.bytes = 0;
+        c.nanoseconds = 0;
+        c.allocations = 0;
+        c.allocatedBytes = 0;
+        c.copies = 0;
+        c.copiedBytes = 0;
+    }
+}
+
+std::string toJson() {
+    std::ostringstream os;
+    os << "{\n  \"enabled\": " << (enabled ? "true" : "false") << ",\n  \"operators\": [";
+    bool first = true;
+    for (size_t i = 0; i < opCount; ++i) {
+        const Op op = static_cast<Op>(i);
+        const Stats s = stats(op);
+        if (s.calls == 0 && s.allocations == 0 && s.copies == 0) continue;
+        os << (first ? "\n" : ",\n")
+           << "    {\"name\": \"" << name(op) << "\", \"calls\": " << s.calls << ", \"bytes\": " << s.bytes
+           << ", \"time_ns\": " << s.nanoseconds << ", \"allocations\": " << s.allocations
+           << ", \"allocated_bytes\": " << s.allocatedBytes << ", \"copies\": " << s.copies
+           << ", \"copied_bytes\": " << s.copiedBytes << "}";
+        first = false;
+    }
+    os << (first ? "]\n}\n" : "\n  ]\n}\n");
+    return os.str();
+}
+
+bool dumpJson(const char* filename) {
+    std::ofstream out(filename);
+    if (!out) return false;
+    out << toJson();
+    return static_cast<bool>(out);
+}
+
+// === ENREGISTREMENT ===
+void allocation(size_t bytes) {
+    Counters& c = at(current);
+    add(c.allocations, 1);
+    add(c.allocatedBytes, bytes);
+}
+
+void copy(size_t bytes) {
+    Counters& c = at(current);
+    add(c.copies, 1);
+    add(c.copiedBytes, bytes);
+}
+
+void addBytes(size_t bytes) { add(at(current).bytes, bytes); }
+
+Scope::Scope(Op o, size_t bytes) : op(o), parent(current), active(current != o) {
+    if (!active) return;
+    current = op;
+    Counters& c = at(op);
+    add(c.calls, 1);
+    add(c.bytes, bytes);
+    start = now();
+}
+
+Scope::~Scope() {
+    if (!active) return;
+    add(at(op).nanoseconds, now() - start);
+    current = parent;
+}
+
+} // namespace instr
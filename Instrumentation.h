@@ -0,0 +1,114 @@
+#ifndef INSTRUMENTATION_H
+#define INSTRUMENTATION_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+// Compteurs par opérateur d'Image : appels, octets traités, temps, allocations
+// de buffers de pixels et copies (y compris celles cachées dans enlargeTo,
+// l'alignement des opérandes ou la copie de *this des opérateurs non mutants).
+//
+// Activé à la compilation par IMAGE_INSTRUMENTATION (option CMake du même nom).
+// Sans lui, les macros IMAGE_INSTR_* ne génèrent aucun code ; l'API reste
+// disponible et renvoie des compteurs nuls.
+namespace instr {
+
+#ifdef IMAGE_INSTRUMENTATION
+constexpr bool enabled = true;
+#else
+constexpr bool enabled = false;
+#endif
+
+enum class Op : uint8_t {
+    Other,      // hors de tout opérateur (constructeurs appelés par l'utilisateur...)
+    Load,
+    Save,
+    Decode,     // depuis un buffer en mémoire
+    Encode,     // vers un buffer en mémoire
+    Add,
+    Sub,
+    Diff,
+    Mul,
+    Div,
+    Invert,
+    Threshold,
+    FromMask,   // Image(const Mask&)
+    Convert,
+    ToLayout,
+    Enlarge,    // agrandissement avec padding avant une opération image-image
+    Convolve,
+    Blur,       // boxBlur, gaussianBlur
+    Rank,       // median, rankFilter
+    Morphology, // erode, dilate, open, close
+    Resize,
+    Pyramid,    // mipmaps, pyramides gaussienne et laplacienne
+    Orient,     // rotations, transposition, miroirs
+    Warp,       // déformations affines et perspectives
+    Composite,  // paste, composite (Porter-Duff)
+    Blend,      // addWeighted, linearCombination
+    Count
+};
+
+const char* name(Op op);
+
+struct Stats {
+    uint64_t calls = 0;
+    uint64_t bytes = 0;           // octets de pixels lus
+    uint64_t nanoseconds = 0;     // temps inclusif (comprend les opérations imbriquées)
+    uint64_t allocations = 0;     // buffers de pixels alloués
+    uint64_t allocatedBytes = 0;
+    uint64_t copies = 0;          // copies de buffers de pixels
+    uint64_t copiedBytes = 0;
+};
+
+Stats stats(Op op);
+void reset();
+
+// {"enabled": ..., "operators": [{"name": "add", "calls": ..., ...}, ...]}
+// (opérateurs sans activité omis)
+std::string toJson();
+bool dumpJson(const char* filename);
+
+// === ENREGISTREMENT (utilisé par Image via les macros) ===
+// Allocations, copies et octets sont attribués à l'opérateur le plus interne
+// en cours sur le thread ; Other s'il n'y en a pas.
+void allocation(size_t bytes);
+void copy(size_t bytes);
+void addBytes(size_t bytes);
+
+// Mesure d'un opérateur. Une portée imbriquée dans une portée du même
+// opérateur (operator+ qui appelle operator+=, récursion de convertTo...)
+// ne compte ni appel ni temps.
+class Scope {
+public:
+    Scope(Op op, size_t bytes);
+    ~Scope();
+    Scope(const Scope&) = delete;
+    Scope& operator=(const Scope&) = delete;
+
+private:
+    Op op;
+    Op parent;
+    bool active;
+    uint64_t start = 0;
+};
+
+} // namespace instr
+
+#ifdef IMAGE_INSTRUMENTATION
+#define IMAGE_INSTR_SCOPE(op, bytes) instr::Scope instrScope_(instr::Op::op, (bytes))
+#define IMAGE_INSTR_ALLOC(bytes) instr::allocation(bytes)
+#define IMAGE_INSTR_COPY(bytes) instr::copy(bytes)
+// Nouveau buffer rempli par copie (copie d'une Image, assign depuis un buffer)
+#define IMAGE_INSTR_DUP(bytes) (instr::allocation(bytes), instr::copy(bytes))
+#define IMAGE_INSTR_BYTES(bytes) instr::addBytes(bytes)
+#else
+#define IMAGE_INSTR_SCOPE(op, bytes) ((void)0)
+#define IMAGE_INSTR_ALLOC(bytes) ((void)0)
+#define IMAGE_INSTR_COPY(bytes) ((void)0)
+#define IMAGE_INSTR_DUP(bytes) ((void)0)
+#define IMAGE_INSTR_BYTES(bytes) ((void)0)
+#endif
+
+#endif
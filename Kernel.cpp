@@ -0,0 +1,108 @@
+#include "Kernel.h"
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include <string>
+
+Kernel::Kernel() = default;
+
+Kernel::Kernel(int w, int h, std::vector<float> k) : width(w), height(h), weights(std::move(k)) {
+    if (w <= 0 || h <= 0 || w % 2 == 0 || h % 2 == 0)
+        throw std::invalid_argument("Kernel dimensions must be odd: " + std::to_string(w) + "x" + std::to_string(h));
+    if (weights.size() != static_cast<size_t>(w) * h)
+        throw std::invalid_argument("Kernel expects " + std::to_string(w * h) + " weights");
+}
+
+Kernel Kernel::separable(const std::vector<float>& horizontal, const std::vector<float>& vertical) {
+    const size_t w = horizontal.size(), h = vertical.size();
+    if (w % 2 == 0 || h % 2 == 0)
+        throw std::invalid_argument("Kernel dimensions must be odd: " + std::to_string(w) + "x" + std::to_string(h));
+    Kernel k;
+    k.width = static_cast<int>(w);
+    k.height = static_cast<int>(h);
+    k.horizontal = horizontal;
+    k.vertical = vertical;
+    return k;
+}
+
+Kernel Kernel::box(int radius) {
+    if (radius < 0 || radius > maxRadius) throw std::invalid_argument("Kernel::box: radius out of [0, 65536]");
+    const int n = 2 * radius + 1;
+    return separable(std::vector<float>(n, 1.0f / n), std::vector<float>(n, 1.0f));
+}
+
+Kernel Kernel::gaussian(double sigma, int radius) {
+    // Borne vérifiée avant la conversion en int du rayon
+    if (!(sigma > 0 && sigma <= maxRadius / 3.0))
+        throw std::invalid_argument("Kernel::gaussian: sigma out of ]0, " + std::to_string(maxRadius / 3) + "]");
+    if (radius < 0) radius = static_cast<int>(std::ceil(3 * sigma));
+    if (radius > maxRadius) throw std::invalid_argument("Kernel::gaussian: radius above 65536");
+    std::vector<float> g(2 * radius + 1);
+    double sum = 0;
+    for (int i = -radius; i <= radius; ++i) sum += std::exp(-i * i / (2 * sigma * sigma));
+    for (int i = -radius; i <= radius; ++i)
+        g[i + radius] = static_cast<float>(std::exp(-i * i / (2 * sigma * sigma)) / sum);
+    return separable(g, g);
+}
+
+Kernel Kernel::sharpen(double amount) {
+    const float a = static_cast<float>(amount);
+    return Kernel(3, 3, {0, -a, 0, -a, 1 + 4 * a, -a, 0, -a, 0});
+}
+
+Kernel Kernel::sobelX() { return Kernel(3, 3, {-1, 0, 1, -2, 0, 2, -1, 0, 1}); }
+Kernel Kernel::sobelY() { return Kernel(3, 3, {-1, -2, -1, 0, 0, 0, 1, 2, 1}); }
+Kernel Kernel::laplacian() { return Kernel(3, 3, {0, 1, 0, 1, -4, 1, 0, 1, 0}); }
+
+int Kernel::getWidth() const { return width; }
+int Kernel::getHeight() const { return height; }
+std::vector<float> Kernel::getWeights() const {
+    if (horizontal.empty()) return weights;
+    std::vector<float> k;
+    k.reserve(static_cast<size_t>(width) * height);
+    for (float v : vertical)
+        for (float h : horizontal) k.push_back(h * v);
+    return k;
+}
+
+float Kernel::operator()(int x, int y) const {
+    return horizontal.empty() ? weights[static_cast<size_t>(y) * width + x] : horizontal[x] * vertical[y];
+}
+
+bool Kernel::separate(std::vector<float>& h, std::vector<float>& v) const {
+    if (!horizontal.empty()) {
+        // Facteurs connus, rééquilibrés : max|h| == max|v|
+        float mh = 0, mv = 0;
+        for (float x : horizontal) mh = std::max(mh, std::fabs(x));
+        for (float y : vertical) mv = std::max(mv, std::fabs(y));
+        if (mh == 0 || mv == 0) return false;
+        const double s = std::sqrt(static_cast<double>(mh) / mv);
+        h.resize(width);
+        v.resize(height);
+        for (int x = 0; x < width; ++x) h[x] = static_cast<float>(horizontal[x] / s);
+        for (int y = 0; y < height; ++y) v[y] = static_cast<float>(vertical[y] * s);
+        return true;
+    }
+    if (weights.empty()) return false;
+    // Pivot : le poids de plus grande valeur absolue ; sa ligne et sa colonne
+    // donnent les facteurs, le reste du noyau doit être leur produit
+    size_t pivot = 0;
+    for (size_t i = 1; i < weights.size(); ++i)
+        if (std::fabs(weights[i]) > std::fabs(weights[pivot])) pivot = i;
+    const double p = weights[pivot];
+    if (p == 0) return false;
+    const int px = static_cast<int>(pivot % width), py = static_cast<int>(pivot / width);
+    const double tolerance = 1e-6 * std::fabs(p);
+    for (int y = 0; y < height; ++y)
+        for (int x = 0; x < width; ++x)
+            if (std::fabs((*this)(px, y) * static_cast<double>((*this)(x, py)) / p - (*this)(x, y)) > tolerance)
+                return false;
+
+    // k(x, y) = row[x] * col[y] / p, réparti à parts égales : max|h| == max|v|
+    const double s = std::sqrt(std::fabs(p));
+    h.resize(width);
+    v.resize(height);
+    for (int x = 0; x < width; ++x) h[x] = static_cast<float>((*this)(x, py) / s);
+    for (int y = 0; y < height; ++y) v[y] = static_cast<float>((*this)(px, y) / (p / s));
+    return true;
+}
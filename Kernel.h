@@ -0,0 +1,99 @@
+#ifndef KERNEL_H
+#define KERNEL_H
+
+#include <cstdint>
+#include <vector>
+
+// Traitement des pixels hors de l'image par les opérations de voisinage
+enum class Border : uint8_t {
+    Zero,       // 0 hors de l'image, comme le padding de enlargeTo
+    Replicate,  // aaa|abcd|ddd
+    Reflect     // cb|abcd|cb (miroir sans répéter le pixel du bord)
+};
+
+// Filtres de Image::resize. En réduction, le support des filtres continus est
+// élargi du facteur de réduction (anticrénelage).
+enum class ResizeFilter : uint8_t {
+    Nearest,   // pixel le plus proche, sans calcul
+    Bilinear,  // triangle, rayon 1
+    Bicubic,   // Keys (a = -0.5), rayon 2
+    Lanczos3,  // sinc fenêtré, rayon 3
+    Area       // moyenne des pixels couverts, au prorata (vignettes)
+};
+
+// Échantillonnage de Image::warp entre les pixels
+enum class Interpolation : uint8_t {
+    Nearest,   // pixel le plus proche
+    Bilinear,  // 2 x 2 pixels
+    Bicubic    // 4 x 4 pixels, Keys (a = -0.5)
+};
+
+// Opérateurs de Porter-Duff de Image::composite : résultat = Fs·src + Fd·dst
+// en prémultiplié (αs, αd : alphas source et destination)
+enum class Composite : uint8_t {
+    Over,      // Fs = 1, Fd = 1 - αs (superposition, filigrane)
+    In,        // Fs = αd, Fd = 0
+    Out,       // Fs = 1 - αd, Fd = 0
+    Atop,      // Fs = αd, Fd = 1 - αs
+    Xor,       // Fs = 1 - αd, Fd = 1 - αs
+    DestOver,  // Fs = 1 - αd, Fd = 1
+    DestIn,    // Fs = 0, Fd = αs
+    DestOut,   // Fs = 0, Fd = 1 - αs
+    DestAtop   // Fs = 1 - αd, Fd = αs
+};
+
+// Orientations exactes d'une image, numérotées comme le tag EXIF 0x0112 :
+// transformation qui redresse l'image stockée pour l'affichage.
+enum class Orientation : uint8_t {
+    Normal = 1,
+    FlipHorizontal,  // miroir gauche / droite
+    Rotate180,
+    FlipVertical,    // miroir haut / bas
+    Transpose,       // (x, y) -> (y, x)
+    Rotate90,        // quart de tour horaire
+    Transverse,      // symétrie par l'antidiagonale
+    Rotate270        // quart de tour antihoraire
+};
+
+// Noyau de convolution 2D, dimensions impaires, ancré en son centre.
+// Poids flottants ; Image::convolve les passe en virgule fixe pour le 8 bits.
+// Un noyau séparable ne garde que ses deux facteurs 1D.
+class Kernel {
+private:
+    int width = 0;
+    int height = 0;
+    std::vector<float> weights;     // ligne par ligne (vide si séparable)
+    std::vector<float> horizontal;  // facteurs de separable()
+    std::vector<float> vertical;
+
+public:
+    Kernel();
+    // std::invalid_argument si une dimension est paire ou si weights n'a pas w * h éléments
+    Kernel(int w, int h, std::vector<float> weights);
+
+    // Produit extérieur : k(x, y) = horizontal[x] * vertical[y], facteurs gardés tels quels
+    static Kernel separable(const std::vector<float>& horizontal, const std::vector<float>& vertical);
+
+    // Noyaux usuels (normalisés sauf sobel et laplacian). Rayons <= maxRadius et
+    // sigma <= maxRadius / 3, sinon std::invalid_argument.
+    static constexpr int maxRadius = 65536;
+    static Kernel box(int radius);
+    static Kernel gaussian(double sigma, int radius = -1);  // rayon par défaut : ceil(3 sigma)
+    static Kernel sharpen(double amount = 1.0);             // identité + amount * laplacien (3x3)
+    static Kernel sobelX();
+    static Kernel sobelY();
+    static Kernel laplacian();
+
+    int getWidth() const;
+    int getHeight() const;
+    // Poids ligne par ligne (produit des facteurs pour un noyau séparable)
+    std::vector<float> getWeights() const;
+    float operator()(int x, int y) const;
+
+    // Décomposition en horizontal[x] * vertical[y] si le noyau est de rang 1
+    // (tolérance relative 1e-6, facteurs de separable() repris directement) ;
+    // les deux facteurs ont le même poids maximal.
+    bool separate(std::vector<float>& horizontal, std::vector<float>& vertical) const;
+};
+
+#endif
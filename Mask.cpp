@@ -0,0 +1,138 @@
+#include "Mask.h"
+#include "Image.h"
+#include "ImageKernels.h"
+
+size_t Mask::wordIndex(int x, int y) const {
+    if (x < 0 || x >= width || y < 0 || y >= height)
+        throw std::out_of_range("Mask coordinates out of bounds");
+    return static_cast<size_t>(y) * wordsPerRow + x / 64;
+}
+
+// Bits valides du dernier mot de chaque ligne
+uint64_t Mask::tailMask() const {
+    int r = width % 64;
+    return r == 0 ? ~uint64_t(0) : (uint64_t(1) << r) - 1;
+}
+
+void Mask::clearPadding() {
+    if (wordsPerRow == 0) return;
+    const uint64_t tail = tailMask();
+    for (int y = 0; y < height; ++y)
+        bits[static_cast<size_t>(y) * wordsPerRow + wordsPerRow - 1] &= tail;
+}
+
+void Mask::checkSameSize(const Mask& other) const {
+    if (width != other.width || height != other.height)
+        throw std::invalid_argument("Mask size mismatch");
+}
+
+Mask::Mask() = default;
+
+Mask::Mask(int w, int h, bool value) : width(w), height(h), wordsPerRow((w + 63) / 64) {
+    if (w < 0 || h < 0) throw std::invalid_argument("Invalid dimensions");
+    bits.assign(static_cast<size_t>(wordsPerRow) * h, value ? ~uint64_t(0) : 0);
+    clearPadding();
+}
+
+// Accès
+int Mask::getWidth() const { return width; }
+int Mask::getHeight() const { return height; }
+int Mask::getWordsPerRow() const { return wordsPerRow; }
+
+bool Mask::get(int x, int y) const { return (bits[wordIndex(x, y)] >> (x % 64)) & 1; }
+bool Mask::operator()(int x, int y) const { return get(x, y); }
+
+void Mask::set(int x, int y, bool value) {
+    uint64_t& w = bits[wordIndex(x, y)];
+    uint64_t b = uint64_t(1) << (x % 64);
+    w = value ? (w | b) : (w & ~b);
+}
+
+uint64_t* Mask::row(int y) { return bits.data() + static_cast<size_t>(y) * wordsPerRow; }
+const uint64_t* Mask::row(int y) const { return bits.data() + static_cast<size_t>(y) * wordsPerRow; }
+
+// === STATISTIQUES ===
+size_t Mask::count() const { return kernels::popcount(bits.data(), bits.size()); }
+size_t Mask::countRow(int y) const {
+    if (y < 0 || y >= height) throw std::out_of_range("Mask row out of bounds");
+    return kernels::popcount(row(y), wordsPerRow);
+}
+
+double Mask::coverage() const {
+    size_t total = static_cast<size_t>(width) * height;
+    return total == 0 ? 0.0 : static_cast<double>(count()) / total;
+}
+
+bool Mask::any() const {
+    for (uint64_t w : bits) if (w) return true;
+    return false;
+}
+
+bool Mask::all() const { return count() == static_cast<size_t>(width) * height; }
+
+// === OPÉRATIONS BIT À BIT ===
+// Le bourrage reste à 0 pour &, | et ^ ; seul ~ doit le nettoyer.
+Mask Mask::operator&(const Mask& other) const { Mask res = *this; res &= other; return res; }
+Mask& Mask::operator&=(const Mask& other) {
+    checkSameSize(other);
+    for (size_t i = 0; i < bits.size(); ++i) bits[i] &= other.bits[i];
+    return *this;
+}
+
+Mask Mask::operator|(const Mask& other) const { Mask res = *this; res |= other; return res; }
+Mask& Mask::operator|=(const Mask& other) {
+    checkSameSize(other);
+    for (size_t i = 0; i < bits.size(); ++i) bits[i] |= other.bits[i];
+    return *this;
+}
+
+Mask Mask::operator^(const Mask& other) const { Mask res = *this; res ^= other; return res; }
+Mask& Mask::operator^=(const Mask& other) {
+    checkSameSize(other);
+    for (size_t i = 0; i < bits.size(); ++i) bits[i] ^= other.bits[i];
+    return *this;
+}
+
+Mask Mask::operator~() const {
+    Mask res = *this;
+    for (uint64_t& w : res.bits) w = ~w;
+    res.clearPadding();
+    return res;
+}
+
+// === MORPHOLOGIE ===
+// Un seul noyau (OU sur l'élément) : erode passe par la dualité
+// erode(M) = ~(OU de ~M sur l'élément), l'extérieur de ~M valant 0
+Mask Mask::dilate(const StructuringElement& se) const {
+    if (se.getWidth() == 0) throw std::invalid_argument("Empty structuring element");
+    Mask res(width, height);
+    kernels::windowOrBits(bits.data(), res.bits.data(), width, height, wordsPerRow, se.reflected());
+    return res;
+}
+
+Mask Mask::erode(const StructuringElement& se) const {
+    if (se.getWidth() == 0) throw std::invalid_argument("Empty structuring element");
+    const Mask inverse = ~*this;
+    Mask res(width, height);
+    kernels::windowOrBits(inverse.bits.data(), res.bits.data(), width, height, wordsPerRow, se);
+    return ~res;
+}
+
+Mask Mask::open(const StructuringElement& se) const { return erode(se).dilate(se); }
+Mask Mask::close(const StructuringElement& se) const { return dilate(se).erode(se); }
+
+bool Mask::operator==(const Mask& other) const {
+    return width == other.width && height == other.height && bits == other.bits;
+}
+bool Mask::operator!=(const Mask& other) const { return !(*this == other); }
+
+// === CONVERSION / SAUVEGARDE ===
+Image Mask::toImage(uint8_t on, uint8_t off) const { return Image(*this, on, off); }
+
+bool Mask::save(const char* filename) const { return toImage().save(filename); }
+
+// Affichage
+std::ostream& operator<<(std::ostream& os, const Mask& mask) {
+    os << mask.width << "x" << mask.height << " (MASK, " << mask.count() << " on)";
+    return os;
+}
@@ -0,0 +1,84 @@
+#ifndef MASK_H
+#define MASK_H
+
+#include <vector>
+#include <cstdint>
+#include <iostream>
+#include <stdexcept>
+#include "StructuringElement.h"
+
+class Image;
+
+// Masque binaire 1 bit par pixel (résultat des seuillages).
+// Chaque ligne occupe `wordsPerRow` mots de 64 bits ; le bit x de la ligne est
+// le bit (x % 64) du mot x / 64. Les bits de bourrage en fin de ligne sont
+// toujours à 0, ce qui permet popcount et opérations bit à bit mot par mot.
+class Mask {
+private:
+    int width = 0;
+    int height = 0;
+    int wordsPerRow = 0;
+    std::vector<uint64_t> bits;
+
+    size_t wordIndex(int x, int y) const;
+    uint64_t tailMask() const;
+    void clearPadding();
+    void checkSameSize(const Mask& other) const;
+
+public:
+    Mask();
+    Mask(int w, int h, bool value = false);
+
+    // Règle des 5
+    ~Mask() = default;
+    Mask(const Mask&) = default;
+    Mask& operator=(const Mask&) = default;
+    Mask(Mask&&) noexcept = default;
+    Mask& operator=(Mask&&) noexcept = default;
+
+    int getWidth() const;
+    int getHeight() const;
+    int getWordsPerRow() const;
+
+    bool get(int x, int y) const;
+    void set(int x, int y, bool value);
+    bool operator()(int x, int y) const;
+
+    // Accès brut aux mots d'une ligne (bourrage à 0 à préserver)
+    uint64_t* row(int y);
+    const uint64_t* row(int y) const;
+
+    // Statistiques (popcount)
+    size_t count() const;
+    size_t countRow(int y) const;
+    double coverage() const;  // proportion de pixels à 1
+    bool any() const;
+    bool all() const;
+
+    // Combinaisons bit à bit (tailles identiques exigées)
+    Mask operator&(const Mask& other) const;
+    Mask& operator&=(const Mask& other);
+    Mask operator|(const Mask& other) const;
+    Mask& operator|=(const Mask& other);
+    Mask operator^(const Mask& other) const;
+    Mask& operator^=(const Mask& other);
+    Mask operator~() const;
+
+    // Morphologie binaire, bit-parallèle (64 pixels par opération), threads du
+    // pool ; l'extérieur du masque est ignoré (ni 0 pour erode, ni 1 pour dilate)
+    Mask erode(const StructuringElement& se) const;
+    Mask dilate(const StructuringElement& se) const;
+    Mask open(const StructuringElement& se) const;   // dilate(erode) : retire les points isolés
+    Mask close(const StructuringElement& se) const;  // erode(dilate) : bouche les trous
+
+    bool operator==(const Mask& other) const;
+    bool operator!=(const Mask& other) const;
+
+    // Expansion en image GRAY 8 bits (on/off par défaut 255/0)
+    Image toImage(uint8_t on = 255, uint8_t off = 0) const;
+    bool save(const char* filename) const;
+
+    friend std::ostream& operator<<(std::ostream& os, const Mask& mask);
+};
+
+#endif
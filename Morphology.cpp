@@ -0,0 +1,315 @@
+#include "ImageKernels.h"
+#include "ImageSimd.h"
+#include "Parallel.h"
+#include <algorithm>
+#include <cstring>
+#include <map>
+#include <vector>
+
+namespace kernels {
+
+namespace {
+
+// === COMBINAISONS ===
+struct MinOp {
+    static constexpr uint8_t neutral = 255;
+    static uint8_t apply(uint8_t a, uint8_t b) { return std::min(a, b); }
+#ifdef IMAGE_HAVE_SSE2
+    static __m128i apply(__m128i a, __m128i b) { return _mm_min_epu8(a, b); }
+#endif
+};
+
+struct MaxOp {
+    static constexpr uint8_t neutral = 0;
+    static uint8_t apply(uint8_t a, uint8_t b) { return std::max(a, b); }
+#ifdef IMAGE_HAVE_SSE2
+    static __m128i apply(__m128i a, __m128i b) { return _mm_max_epu8(a, b); }
+#endif
+};
+
+// out[i] = op(a[i], b[i]) ; out peut être a ou b
+template <typename Op>
+void combine(const uint8_t* a, const uint8_t* b, uint8_t* out, size_t n) {
+    size_t i = 0;
+#ifdef IMAGE_HAVE_SSE2
+    for (; i + 16 <= n; i += 16) simd::store(out + i, Op::apply(simd::load(a + i), simd::load(b + i)));
+#endif
+    for (; i < n; ++i) out[i] = Op::apply(a[i], b[i]);
+}
+
+struct OrOp {
+    static void combine(const uint64_t* a, const uint64_t* b, uint64_t* out, size_t n) {
+        for (size_t i = 0; i < n; ++i) out[i] = a[i] | b[i];
+    }
+};
+
+template <typename Op>
+struct ByteOp {
+    static void combine(const uint8_t* a, const uint8_t* b, uint8_t* out, size_t n) { kernels::combine<Op>(a, b, out, n); }
+};
+
+// === VAN HERK / GIL-WERMAN ===
+// n lignes de len éléments (line[i]) : out[i] = op de line[i .. i + L - 1]
+// pour i dans [0, n - L]. Découpage en blocs de L lignes : g cumule depuis
+// le début du bloc, h depuis sa fin, et une fenêtre à cheval sur deux blocs
+// vaut op(h[i], g[i + L - 1]). Trois combinaisons par élément, quel que soit L.
+template <typename T, typename Combine>
+void vhgwLines(const T* const* line, int n, size_t len, int L, T* const* out, std::vector<T>& g, std::vector<T>& h) {
+    g.resize(static_cast<size_t>(n) * len);
+    h.resize(static_cast<size_t>(n) * len);
+    for (int i = 0; i < n; ++i) {
+        T* gi = g.data() + static_cast<size_t>(i) * len;
+        if (i % L == 0) std::copy(line[i], line[i] + len, gi);
+        else Combine::combine(gi - len, line[i], gi, len);
+    }
+    for (int i = n - 1; i >= 0; --i) {
+        T* hi = h.data() + static_cast<size_t>(i) * len;
+        if (i % L == L - 1 || i == n - 1) std::copy(line[i], line[i] + len, hi);
+        else Combine::combine(hi + len, line[i], hi, len);
+    }
+    for (int i = 0; i + L <= n; ++i)
+        Combine::combine(h.data() + static_cast<size_t>(i) * len, g.data() + static_cast<size_t>(i + L - 1) * len, out[i],
+                         len);
+}
+
+// Même calcul le long d'une ligne élargie de n pixels entrelacés :
+// out[x] = op de p[x .. x + L - 1], x dans [0, n - L]
+template <typename Op>
+void vhgwRow(const uint8_t* p, int n, int C, int L, uint8_t* out, std::vector<uint8_t>& g, std::vector<uint8_t>& h) {
+    const size_t N = static_cast<size_t>(n) * C;
+    g.resize(N);
+    h.resize(N);
+    const size_t step = static_cast<size_t>(L) * C;
+    for (size_t b0 = 0; b0 < N; b0 += step) {
+        const size_t b1 = std::min(N, b0 + step);
+        if (C == 1) {
+            // Cumul gardé en registre (sinon chaque pas relit l'écriture précédente)
+            uint8_t acc = p[b0];
+            for (size_t i = b0; i < b1; ++i) g[i] = acc = Op::apply(acc, p[i]);
+            acc = p[b1 - 1];
+            for (size_t i = b1; i-- > b0;) h[i] = acc = Op::apply(acc, p[i]);
+        } else {
+            std::copy(p + b0, p + b0 + C, g.data() + b0);
+            for (size_t i = b0 + C; i < b1; ++i) g[i] = Op::apply(g[i - C], p[i]);
+            std::copy(p + b1 - C, p + b1, h.data() + b1 - C);
+            for (size_t i = b1 - C; i-- > b0;) h[i] = Op::apply(h[i + C], p[i]);
+        }
+    }
+    combine<Op>(h.data(), g.data() + static_cast<size_t>(L - 1) * C, out, static_cast<size_t>(n - L + 1) * C);
+}
+
+// === RECTANGLE : DEUX PASSES 1D ===
+template <typename Op>
+void extremumRect(const ConstSurface& src, const Surface& dst, int rx, int ry, Border border) {
+    const int W = src.width, H = src.height, C = src.channels;
+    const size_t samples = static_cast<size_t>(W) * C;
+
+    parallel::forRange(0, H, 16, [&](size_t first, size_t last) {
+        std::vector<uint8_t> pad(static_cast<size_t>(W + 2 * rx) * C), g, h;
+        for (size_t y = first; y < last; ++y) {
+            padRow(src.row(static_cast<int>(y)), W, C, rx, border, pad.data());
+            vhgwRow<Op>(pad.data(), W + 2 * rx, C, 2 * rx + 1, dst.row(static_cast<int>(y)), g, h);
+        }
+    });
+    if (ry == 0) return;
+
+    // Colonnes en place par blocs de 128 échantillons : g et h d'un bloc en cache L2
+    const size_t block = 128;
+    parallel::forRange(0, (samples + block - 1) / block, 1, [&](size_t first, size_t last) {
+        std::vector<uint8_t> orig(static_cast<size_t>(H) * block), zeros(block, 0), g, h;
+        std::vector<const uint8_t*> in(H + 2 * ry);
+        std::vector<uint8_t*> out(H);
+        for (size_t b = first; b < last; ++b) {
+            const size_t s0 = b * block, bw = std::min(samples, s0 + block) - s0;
+            for (int y = 0; y < H; ++y) {
+                std::memcpy(orig.data() + static_cast<size_t>(y) * bw, dst.row(y) + s0, bw);
+                out[y] = dst.row(y) + s0;
+            }
+            for (int i = 0; i < H + 2 * ry; ++i) {
+                const int yy = borderIndex(i - ry, H, border);
+                in[i] = yy < 0 ? zeros.data() : orig.data() + static_cast<size_t>(yy) * bw;
+            }
+            vhgwLines<uint8_t, ByteOp<Op>>(in.data(), H + 2 * ry, bw, 2 * ry + 1, out.data(), g, h);
+        }
+    });
+}
+
+// === FORME QUELCONQUE : SEGMENTS HORIZONTAUX ===
+// Pour chaque longueur de segment distincte, extremum horizontal glissant
+// (vHGW) des lignes sources d'une bande, puis combinaison des lignes décalées
+// de chaque segment de cette longueur.
+template <typename Op>
+void extremumRuns(const ConstSurface& src, const Surface& dst, const StructuringElement& se, Border border) {
+    const int W = src.width, H = src.height, C = src.channels;
+    const int rx = se.getWidth() / 2, ry = se.getHeight() / 2;
+    const size_t samples = static_cast<size_t>(W) * C;
+    std::map<int, std::vector<StructuringElement::Run>> byLength;
+    for (const auto& run : se.runs()) byLength[run.length].push_back(run);
+
+    // Bandes de 64 lignes : les 2 ry lignes de marge recalculées par bande restent marginales
+    parallel::forRange(0, H, 64, [&](size_t first, size_t last) {
+        const int y0 = static_cast<int>(first), y1 = static_cast<int>(last), rows = y1 - y0 + 2 * ry;
+        const size_t padded = static_cast<size_t>(W + 2 * rx) * C;
+        std::vector<uint8_t> pad(padded), lines(static_cast<size_t>(rows) * padded), g, h;
+        std::vector<int> source(rows);
+        for (int i = 0; i < rows; ++i) source[i] = borderIndex(y0 - ry + i, H, border);
+        for (int y = y0; y < y1; ++y) std::memset(dst.row(y), Op::neutral, samples);
+
+        for (const auto& [L, runs] : byLength) {
+            // lines[i] : extremum de la ligne y0 - ry + i sur [x, x + L - 1] (x élargi)
+            for (int i = 0; i < rows; ++i) {
+                uint8_t* line = lines.data() + static_cast<size_t>(i) * padded;
+                if (source[i] < 0) {
+                    std::memset(line, 0, padded);
+                    continue;
+                }
+                padRow(src.row(source[i]), W, C, rx, border, pad.data());
+                vhgwRow<Op>(pad.data(), W + 2 * rx, C, L, line, g, h);
+            }
+            for (int y = y0; y < y1; ++y)
+                for (const auto& run : runs) {
+                    const uint8_t* line = lines.data() + static_cast<size_t>(y - y0 + ry + run.dy) * padded;
+                    combine<Op>(dst.row(y), line + static_cast<size_t>(rx + run.dx) * C, dst.row(y), samples);
+                }
+        }
+    });
+}
+
+template <typename Op>
+void extremum(const ConstSurface& src, const Surface& dst, const StructuringElement& se, Border border) {
+    if (se.isRectangle()) extremumRect<Op>(src, dst, se.getWidth() / 2, se.getHeight() / 2, border);
+    else extremumRuns<Op>(src, dst, se, border);
+}
+
+// === MASQUES 1 BIT ===
+// out(x) = in(x + k) pour out de outWords mots, 0 hors de [0, 64 * inWords)
+void shiftRow(const uint64_t* in, int inWords, uint64_t* out, int outWords, int k) {
+    const int q = k >= 0 ? k / 64 : -((-k + 63) / 64), s = k - 64 * q;  // k = 64q + s, 0 <= s < 64
+    auto word = [&](int i) -> uint64_t { return i >= 0 && i < inWords ? in[i] : 0; };
+    for (int i = 0; i < outWords; ++i) {
+        const uint64_t lo = word(i + q), hi = word(i + q + 1);
+        out[i] = s == 0 ? lo : (lo >> s) | (hi << (64 - s));
+    }
+}
+
+// OU glissant sur L bits d'une ligne de `words` mots, par doublements (log2 L
+// décalages de ligne, 64 pixels par opération). out a pad mots de marge de
+// chaque côté : out(x) = OU de in(x - 64 * pad .. x - 64 * pad + L - 1), ce
+// qui garde les fenêtres commençant avant le bord gauche (64 * pad >= L - 1).
+void runOr(const uint64_t* in, int words, int pad, uint64_t* out, int L, std::vector<uint64_t>& tmp) {
+    const int n = words + 2 * pad;
+    tmp.resize(n);
+    std::fill(out, out + n, 0);
+    std::copy(in, in + words, out + pad);
+    for (int span = 1; span < L;) {
+        const int step = std::min(span, L - span);
+        shiftRow(out, n, tmp.data(), n, step);
+        OrOp::combine(out, tmp.data(), out, n);
+        span += step;
+    }
+}
+
+} // namespace
+
+void windowExtremum(const ConstSurface& src, const Surface& dst, const StructuringElement& se, Extremum ext,
+                    Border border) {
+    if (ext == Extremum::Min) extremum<MinOp>(src, dst, se, border);
+    else extremum<MaxOp>(src, dst, se, border);
+}
+
+void windowExtremumScalar(const ConstSurface& src, const Surface& dst, const StructuringElement& se, Extremum ext,
+                          Border border) {
+    const int W = src.width, H = src.height, C = src.channels;
+    const int rx = se.getWidth() / 2, ry = se.getHeight() / 2;
+    for (int y = 0; y < H; ++y)
+        for (int x = 0; x < W; ++x)
+            for (int c = 0; c < C; ++c) {
+                int v = ext == Extremum::Min ? 255 : 0;
+                for (int j = -ry; j <= ry; ++j)
+                    for (int i = -rx; i <= rx; ++i) {
+                        if (!se(i + rx, j + ry)) continue;
+                        const int yy = borderIndex(y + j, H, border), xx = borderIndex(x + i, W, border);
+                        const int s = yy < 0 || xx < 0 ? 0 : src.row(yy)[static_cast<size_t>(xx) * C + c];
+                        v = ext == Extremum::Min ? std::min(v, s) : std::max(v, s);
+                    }
+                dst.row(y)[static_cast<size_t>(x) * C + c] = static_cast<uint8_t>(v);
+            }
+}
+
+void windowOrBits(const uint64_t* src, uint64_t* dst, int width, int height, int wordsPerRow,
+                  const StructuringElement& se) {
+    const int W = wordsPerRow, ry = se.getHeight() / 2, pad = (se.getWidth() + 62) / 64;
+    const size_t words = static_cast<size_t>(W), padded = words + 2 * pad;
+    const uint64_t tail = width % 64 == 0 ? ~uint64_t(0) : (uint64_t(1) << (width % 64)) - 1;
+    std::map<int, std::vector<StructuringElement::Run>> byLength;
+    for (const auto& run : se.runs()) byLength[run.length].push_back(run);
+
+    if (se.isRectangle()) {
+        // Segments horizontaux ligne par ligne, puis vHGW vertical sur les mots
+        const int L = se.getWidth(), rx = L / 2;
+        std::vector<uint64_t> rows(static_cast<size_t>(height) * W);
+        parallel::forRange(0, height, 64, [&](size_t first, size_t last) {
+            std::vector<uint64_t> tmp, run(padded);
+            for (size_t y = first; y < last; ++y) {
+                runOr(src + y * words, W, pad, run.data(), L, tmp);
+                shiftRow(run.data(), static_cast<int>(padded), rows.data() + y * words, W, 64 * pad - rx);
+            }
+        });
+        const size_t block = 32;
+        parallel::forRange(0, (words + block - 1) / block, 1, [&](size_t first, size_t last) {
+            std::vector<uint64_t> zeros(block, 0), g, h;
+            std::vector<const uint64_t*> in(height + 2 * ry);
+            std::vector<uint64_t*> out(height);
+            for (size_t b = first; b < last; ++b) {
+                const size_t w0 = b * block, bw = std::min(words, w0 + block) - w0;
+                for (int i = 0; i < height + 2 * ry; ++i) {
+                    const int yy = i - ry;
+                    in[i] = yy < 0 || yy >= height ? zeros.data() : rows.data() + yy * words + w0;
+                }
+                for (int y = 0; y < height; ++y) out[y] = dst + y * words + w0;
+                vhgwLines<uint64_t, OrOp>(in.data(), height + 2 * ry, bw, 2 * ry + 1, out.data(), g, h);
+            }
+        });
+    } else {
+        parallel::forRange(0, height, 64, [&](size_t first, size_t last) {
+            const int y0 = static_cast<int>(first), y1 = static_cast<int>(last), rows = y1 - y0 + 2 * ry;
+            std::vector<uint64_t> lines(static_cast<size_t>(rows) * padded), shifted(W), tmp;
+            std::fill(dst + y0 * words, dst + y1 * words, 0);
+            for (const auto& [L, runs] : byLength) {
+                for (int i = 0; i < rows; ++i) {
+                    const int yy = y0 - ry + i;
+                    if (yy >= 0 && yy < height) runOr(src + yy * words, W, pad, lines.data() + i * padded, L, tmp);
+                }
+                for (int y = y0; y < y1; ++y)
+                    for (const auto& run : runs) {
+                        const int yy = y + run.dy;
+                        if (yy < 0 || yy >= height) continue;
+                        shiftRow(lines.data() + (yy - y0 + ry) * padded, static_cast<int>(padded), shifted.data(), W,
+                                 64 * pad + run.dx);
+                        OrOp::combine(dst + y * words, shifted.data(), dst + y * words, words);
+                    }
+            }
+        });
+    }
+    // Les décalages vers la droite ont pu déborder dans le bourrage
+    if (W > 0)
+        for (int y = 0; y < height; ++y) dst[y * words + W - 1] &= tail;
+}
+
+void windowOrBitsScalar(const uint64_t* src, uint64_t* dst, int width, int height, int wordsPerRow,
+                        const StructuringElement& se) {
+    const int rx = se.getWidth() / 2, ry = se.getHeight() / 2;
+    auto bit = [&](int x, int y) { return (src[static_cast<size_t>(y) * wordsPerRow + x / 64] >> (x % 64)) & 1; };
+    std::fill(dst, dst + static_cast<size_t>(height) * wordsPerRow, 0);
+    for (int y = 0; y < height; ++y)
+        for (int x = 0; x < width; ++x) {
+            bool on = false;
+            for (int j = -ry; j <= ry && !on; ++j)
+                for (int i = -rx; i <= rx && !on; ++i)
+                    on = se(i + rx, j + ry) && y + j >= 0 && y + j < height && x + i >= 0 && x + i < width &&
+                         bit(x + i, y + j);
+            if (on) dst[static_cast<size_t>(y) * wordsPerRow + x / 64] |= uint64_t(1) << (x % 64);
+        }
+}
+
+} // namespace kernels
@@ -0,0 +1,328 @@
+#include "ImageKernels.h"
+#include "ImageSimd.h"
+#include "Parallel.h"
+#include <algorithm>
+#include <cstring>
+#include <vector>
+
+namespace kernels {
+
+namespace {
+
+// Quart de tour : dst(x, y) = src(sx(y), sy(x)), avec sx(y) = y ou W - 1 - y
+// (reverseX) et sy(x) = x ou H - 1 - x (reverseY)
+struct QuarterTurn {
+    bool reverseX;
+    bool reverseY;
+};
+
+QuarterTurn quarterTurn(Orientation o) {
+    switch (o) {
+        case Orientation::Transpose:  return {false, false};
+        case Orientation::Rotate90:   return {false, true};
+        case Orientation::Transverse: return {true, true};
+        default:                      return {true, false};  // Rotate270
+    }
+}
+
+// Pixel source de dst(x, y), toutes orientations
+void sourceOf(Orientation o, int x, int y, int W, int H, int& sx, int& sy) {
+    switch (o) {
+        case Orientation::Normal:         sx = x, sy = y; break;
+        case Orientation::FlipHorizontal: sx = W - 1 - x, sy = y; break;
+        case Orientation::Rotate180:      sx = W - 1 - x, sy = H - 1 - y; break;
+        case Orientation::FlipVertical:   sx = x, sy = H - 1 - y; break;
+        case Orientation::Transpose:      sx = y, sy = x; break;
+        case Orientation::Rotate90:       sx = y, sy = H - 1 - x; break;
+        case Orientation::Transverse:     sx = W - 1 - y, sy = H - 1 - x; break;
+        default:                          sx = W - 1 - y, sy = x; break;  // Rotate270
+    }
+}
+
+template <int C>
+inline void copyPixel(uint8_t* d, const uint8_t* s, int channels) {
+    if (C) for (int c = 0; c < C; ++c) d[c] = s[c];
+    else std::memcpy(d, s, channels);
+}
+
+// === QUARTS DE TOUR ===
+// Rectangle [x0, x1) x [y0, y1) de dst, un pixel à la fois : colonne par
+// colonne, la ligne source sy(x) est lue de façon contiguë
+template <int C>
+void turnRect(const ConstSurface& src, const Surface& dst, QuarterTurn q, int x0, int x1, int y0, int y1) {
+    const size_t ch = C ? C : src.channels;
+    for (int x = x0; x < x1; ++x) {
+        const uint8_t* row = src.row(q.reverseY ? src.height - 1 - x : x);
+        for (int y = y0; y < y1; ++y)
+            copyPixel<C>(dst.row(y) + x * ch, row + (q.reverseX ? src.width - 1 - y : y) * ch, src.channels);
+    }
+}
+
+// Tuiles de 16 x 16 pixels, sans SSE2 ou au-delà de 4 canaux
+template <int C>
+void turnTiled(const ConstSurface& src, const Surface& dst, QuarterTurn q) {
+    constexpr int T = 16;
+    const size_t bands = (dst.height + T - 1) / T;
+    parallel::forRange(0, bands, 4, [&](size_t first, size_t last) {
+        const int y0 = static_cast<int>(first) * T, y1 = std::min(dst.height, static_cast<int>(last) * T);
+        for (int x = 0; x < dst.width; x += T)
+            for (int y = y0; y < y1; y += T)
+                turnRect<C>(src, dst, q, x, std::min(dst.width, x + T), y, std::min(y1, y + T));
+    });
+}
+
+#ifdef IMAGE_HAVE_SSE2
+template <int E> __m128i unpackLo(__m128i a, __m128i b);
+template <int E> __m128i unpackHi(__m128i a, __m128i b);
+template <> inline __m128i unpackLo<1>(__m128i a, __m128i b) { return _mm_unpacklo_epi8(a, b); }
+template <> inline __m128i unpackHi<1>(__m128i a, __m128i b) { return _mm_unpackhi_epi8(a, b); }
+template <> inline __m128i unpackLo<2>(__m128i a, __m128i b) { return _mm_unpacklo_epi16(a, b); }
+template <> inline __m128i unpackHi<2>(__m128i a, __m128i b) { return _mm_unpackhi_epi16(a, b); }
+template <> inline __m128i unpackLo<4>(__m128i a, __m128i b) { return _mm_unpacklo_epi32(a, b); }
+template <> inline __m128i unpackHi<4>(__m128i a, __m128i b) { return _mm_unpackhi_epi32(a, b); }
+
+// Transposition d'un bloc de N = 16 / E lignes de N éléments de E octets :
+// log2(N) entrelacements de la moitié haute avec la moitié basse
+template <int E>
+inline void transposeBlock(__m128i* r) {
+    constexpr int N = 16 / E;
+    __m128i t[N];
+    for (int round = 1; round < N; round *= 2) {
+        for (int i = 0; i < N / 2; ++i) {
+            t[2 * i] = unpackLo<E>(r[i], r[i + N / 2]);
+            t[2 * i + 1] = unpackHi<E>(r[i], r[i + N / 2]);
+        }
+        std::copy(t, t + N, r);
+    }
+}
+
+// Bloc de N x N pixels de C = 1 à 4 canaux en registres : une ligne de 16
+// octets pour C = 1, 2, 4 ; trois plans de 16 pixels (deinterleave3) pour C = 3
+template <int C>
+struct Block {
+    static constexpr int P = C == 3 ? 3 : 1, E = C == 3 ? 1 : C, N = 16 / E;
+    __m128i v[P][N];
+
+    void load(const uint8_t* p, int i) {
+        if constexpr (C == 3) simd::deinterleave3(p, v[0][i], v[1][i], v[2][i]);
+        else v[0][i] = simd::load(p);
+    }
+    void store(uint8_t* p, int j) const {
+        if constexpr (C == 3) simd::interleave3(p, v[0][j], v[1][j], v[2][j]);
+        else simd::store(p, v[0][j]);
+    }
+    void transpose() {
+        for (int k = 0; k < P; ++k) transposeBlock<E>(v[k]);
+    }
+};
+
+// Bandes de 4 blocs de dst, soit 4 blocs contigus par ligne source lue ;
+// bords par turnRect
+template <int C>
+void turnBlocks(const ConstSurface& src, const Surface& dst, QuarterTurn q) {
+    constexpr int N = Block<C>::N, B = 4 * N;
+    const int fullX = dst.width / N * N;
+    const size_t bands = (dst.height + B - 1) / B;
+    parallel::forRange(0, bands, 1, [&](size_t first, size_t last) {
+        Block<C> r;
+        for (size_t band = first; band < last; ++band) {
+            const int y0 = static_cast<int>(band) * B, y1 = std::min(dst.height, y0 + B);
+            const int fullY = y0 + (y1 - y0) / N * N;
+            for (int x = 0; x < fullX; x += N)
+                for (int y = y0; y < fullY; y += N) {
+                    // Colonnes sources [c0, c0 + N) : dst(., y + j) lit c0 + j, ou c0 + N - 1 - j
+                    const int c0 = q.reverseX ? src.width - y - N : y;
+                    for (int i = 0; i < N; ++i) r.load(src.row(q.reverseY ? src.height - 1 - x - i : x + i) + c0 * C, i);
+                    r.transpose();
+                    for (int j = 0; j < N; ++j) r.store(dst.row(q.reverseX ? y + N - 1 - j : y + j) + x * C, j);
+                }
+            turnRect<C>(src, dst, q, fullX, dst.width, y0, y1);
+            turnRect<C>(src, dst, q, 0, fullX, fullY, y1);
+        }
+    });
+}
+
+// Inversion des éléments de E octets d'un vecteur
+template <int E>
+inline __m128i reverse16(__m128i v) {
+    v = _mm_shuffle_epi32(v, _MM_SHUFFLE(0, 1, 2, 3));
+    if (E <= 2) v = _mm_shufflehi_epi16(_mm_shufflelo_epi16(v, _MM_SHUFFLE(2, 3, 0, 1)), _MM_SHUFFLE(2, 3, 0, 1));
+    if (E == 1) v = _mm_or_si128(_mm_slli_epi16(v, 8), _mm_srli_epi16(v, 8));
+    return v;
+}
+#endif
+
+// === MIROIRS ===
+// out[x] = in[w - 1 - x] ; in et out distincts
+template <int C>
+void reverseRow(const uint8_t* in, uint8_t* out, int w, int channels) {
+    const size_t ch = C ? C : channels;
+    int x = 0;
+#ifdef IMAGE_HAVE_SSE2
+    if constexpr (C == 3) {
+        __m128i r, g, b;
+        for (; x + 16 <= w; x += 16) {
+            simd::deinterleave3(in + (w - x - 16) * ch, r, g, b);
+            simd::interleave3(out + x * ch, reverse16<1>(r), reverse16<1>(g), reverse16<1>(b));
+        }
+    } else if constexpr (C != 0) {
+        constexpr int N = 16 / C;
+        for (; x + N <= w; x += N) simd::store(out + x * ch, reverse16<C>(simd::load(in + (w - x - N) * ch)));
+    }
+#endif
+    for (; x < w; ++x) copyPixel<C>(out + x * ch, in + (w - 1 - x) * ch, channels);
+}
+
+template <int C>
+void flip(const ConstSurface& src, const Surface& dst, Orientation o) {
+    const bool reverse = o != Orientation::FlipVertical;
+    const bool upsideDown = o != Orientation::FlipHorizontal;
+    const size_t n = static_cast<size_t>(src.width) * src.channels;
+    parallel::forRange(0, dst.height, 64, [&](size_t first, size_t last) {
+        for (size_t y = first; y < last; ++y) {
+            const uint8_t* in = src.row(upsideDown ? src.height - 1 - static_cast<int>(y) : static_cast<int>(y));
+            uint8_t* out = dst.row(static_cast<int>(y));
+            if (reverse) reverseRow<C>(in, out, src.width, src.channels);
+            else std::memcpy(out, in, n);
+        }
+    });
+}
+
+// === EN PLACE ===
+template <int C>
+void transposeSquare(const Surface& s) {
+    const int n = s.width;
+    const size_t ch = C ? C : s.channels;
+    int full = 0;
+#ifdef IMAGE_HAVE_SSE2
+    if constexpr (C >= 1 && C <= 4) {
+        // Blocs (i, j) et (j, i) transposés et échangés ; bloc diagonal transposé sur place
+        constexpr int N = Block<C>::N;
+        full = n / N * N;
+        const size_t blocks = full / N;
+        parallel::forRange(0, blocks, 1, [&](size_t first, size_t last) {
+            Block<C> a, b;
+            for (size_t bi = first; bi < last; ++bi) {
+                const int i = static_cast<int>(bi) * N;
+                for (int j = i; j < full; j += N) {
+                    for (int k = 0; k < N; ++k) {
+                        a.load(s.row(i + k) + j * C, k);
+                        b.load(s.row(j + k) + i * C, k);
+                    }
+                    a.transpose();
+                    b.transpose();
+                    for (int k = 0; k < N; ++k) {
+                        a.store(s.row(j + k) + i * C, k);
+                        if (j != i) b.store(s.row(i + k) + j * C, k);
+                    }
+                }
+            }
+        });
+    }
+#endif
+    // Paires restantes : au moins une coordonnée hors des blocs complets
+    uint8_t tmp[64];
+    for (int x = full; x < n; ++x)
+        for (int y = 0; y < x; ++y) {
+            uint8_t* p = s.row(y) + x * ch;
+            uint8_t* q = s.row(x) + y * ch;
+            for (size_t c = 0; c < ch; c += sizeof tmp) {
+                const size_t k = std::min(sizeof tmp, ch - c);
+                std::memcpy(tmp, p + c, k);
+                std::memcpy(p + c, q + c, k);
+                std::memcpy(q + c, tmp, k);
+            }
+        }
+}
+
+template <int C>
+void flipInPlace(const Surface& s, Orientation o) {
+    const size_t n = static_cast<size_t>(s.width) * s.channels;
+    if (o == Orientation::FlipVertical) {
+        parallel::forRange(0, s.height / 2, 64, [&](size_t first, size_t last) {
+            for (size_t y = first; y < last; ++y)
+                std::swap_ranges(s.row(static_cast<int>(y)), s.row(static_cast<int>(y)) + n,
+                                 s.row(s.height - 1 - static_cast<int>(y)));
+        });
+        return;
+    }
+    // Miroir : chaque ligne passe par une copie ; demi-tour : les lignes y et
+    // H - 1 - y sont inversées l'une dans l'autre
+    const bool upsideDown = o == Orientation::Rotate180;
+    const size_t rows = upsideDown ? (s.height + 1) / 2 : s.height;
+    parallel::forRange(0, rows, 64, [&](size_t first, size_t last) {
+        std::vector<uint8_t> a(n), b(n);
+        for (size_t yy = first; yy < last; ++yy) {
+            const int y = static_cast<int>(yy), other = upsideDown ? s.height - 1 - y : y;
+            std::memcpy(a.data(), s.row(y), n);
+            if (other != y) {
+                std::memcpy(b.data(), s.row(other), n);
+                reverseRow<C>(b.data(), s.row(y), s.width, s.channels);
+            }
+            reverseRow<C>(a.data(), s.row(other), s.width, s.channels);
+        }
+    });
+}
+
+template <int C>
+void orientC(const ConstSurface& src, const Surface& dst, Orientation o) {
+    if (!swapsAxes(o)) return flip<C>(src, dst, o);
+#ifdef IMAGE_HAVE_SSE2
+    if constexpr (C != 0) return turnBlocks<C>(src, dst, quarterTurn(o));
+#endif
+    turnTiled<C>(src, dst, quarterTurn(o));
+}
+
+template <int C>
+void orientInPlaceC(const Surface& s, Orientation o) {
+    if (!swapsAxes(o)) return flipInPlace<C>(s, o);
+    // Quart de tour = transposition suivie d'un miroir (surface carrée)
+    transposeSquare<C>(s);
+    switch (o) {
+        case Orientation::Rotate90:   flipInPlace<C>(s, Orientation::FlipHorizontal); break;
+        case Orientation::Rotate270:  flipInPlace<C>(s, Orientation::FlipVertical); break;
+        case Orientation::Transverse: flipInPlace<C>(s, Orientation::Rotate180); break;
+        default: break;
+    }
+}
+
+} // namespace
+
+void orient(const ConstSurface& src, const Surface& dst, Orientation o) {
+    if (o == Orientation::Normal) {
+        const size_t n = static_cast<size_t>(src.width) * src.channels;
+        for (int y = 0; y < src.height; ++y) std::memcpy(dst.row(y), src.row(y), n);
+        return;
+    }
+    switch (src.channels) {
+        case 1: orientC<1>(src, dst, o); break;
+        case 2: orientC<2>(src, dst, o); break;
+        case 3: orientC<3>(src, dst, o); break;
+        case 4: orientC<4>(src, dst, o); break;
+        default: orientC<0>(src, dst, o); break;
+    }
+}
+
+void orientScalar(const ConstSurface& src, const Surface& dst, Orientation o) {
+    const int C = src.channels;
+    for (int y = 0; y < dst.height; ++y)
+        for (int x = 0; x < dst.width; ++x) {
+            int sx, sy;
+            sourceOf(o, x, y, src.width, src.height, sx, sy);
+            for (int c = 0; c < C; ++c)
+                dst.row(y)[static_cast<size_t>(x) * C + c] = src.row(sy)[static_cast<size_t>(sx) * C + c];
+        }
+}
+
+void orientInPlace(const Surface& s, Orientation o) {
+    if (o == Orientation::Normal) return;
+    switch (s.channels) {
+        case 1: orientInPlaceC<1>(s, o); break;
+        case 2: orientInPlaceC<2>(s, o); break;
+        case 3: orientInPlaceC<3>(s, o); break;
+        case 4: orientInPlaceC<4>(s, o); break;
+        default: orientInPlaceC<0>(s, o); break;
+    }
+}
+
+} // namespace kernels
@@ -0,0 +1,158 @@
+#include "Parallel.h"
+#include "Trace.h"
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstdlib>
+#include <deque>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace parallel {
+
+namespace {
+
+// Un appel à forRange : les tranches sont prises par indice atomique
+struct Job {
+    const std::function<void(size_t, size_t)>* body;
+    size_t begin;
+    size_t end;
+    size_t grain;
+    std::atomic<size_t> next;
+    std::atomic<size_t> pending;  // tranches non terminées
+    std::mutex lock;
+    std::condition_variable finished;
+    std::exception_ptr error;
+
+    Job(const std::function<void(size_t, size_t)>& b, size_t first, size_t last, size_t g)
+        : body(&b), begin(first), end(last), grain(g), next(first), pending((last - first + g - 1) / g) {}
+
+    // Exécute une tranche ; false s'il n'en reste plus
+    bool runOne() {
+        const size_t b = next.fetch_add(grain);
+        if (b >= end) return false;
+        try {
+            (*body)(b, std::min(b + grain, end));
+        } catch (...) {
+            std::lock_guard<std::mutex> g(lock);
+            if (!error) error = std::current_exception();
+        }
+        if (pending.fetch_sub(1) == 1) {
+            std::lock_guard<std::mutex> g(lock);
+            finished.notify_all();
+        }
+        return true;
+    }
+};
+
+thread_local bool insidePool = false;
+
+class Pool {
+public:
+    explicit Pool(int threads) {
+        for (int i = 1; i < threads; ++i) workers.emplace_back([this, i] { work(i); });
+    }
+
+    ~Pool() {
+        {
+            std::lock_guard<std::mutex> g(lock);
+            stopping = true;
+        }
+        wake.notify_all();
+        for (std::thread& t : workers) t.join();
+    }
+
+    int size() const { return static_cast<int>(workers.size()) + 1; }
+
+    void run(const std::shared_ptr<Job>& job) {
+        {
+            std::lock_guard<std::mutex> g(lock);
+            jobs.push_back(job);
+        }
+        wake.notify_all();
+        while (job->runOne()) {}
+        remove(job);
+        std::unique_lock<std::mutex> g(job->lock);
+        job->finished.wait(g, [&] { return job->pending.load() == 0; });
+    }
+
+private:
+    std::vector<std::thread> workers;
+    std::mutex lock;
+    std::condition_variable wake;
+    std::deque<std::shared_ptr<Job>> jobs;
+    bool stopping = false;
+
+    void remove(const std::shared_ptr<Job>& job) {
+        std::lock_guard<std::mutex> g(lock);
+        auto it = std::find(jobs.begin(), jobs.end(), job);
+        if (it != jobs.end()) jobs.erase(it);
+    }
+
+    void work(int id) {
+        insidePool = true;
+        if (trace::enabled()) trace::setThreadName(("pool " + std::to_string(id)).c_str());
+        for (;;) {
+            std::shared_ptr<Job> job;
+            {
+                std::unique_lock<std::mutex> g(lock);
+                wake.wait(g, [&] { return stopping || !jobs.empty(); });
+                if (stopping) return;
+                job = jobs.front();
+            }
+            while (job->runOne()) {}
+            remove(job);
+        }
+    }
+};
+
+std::mutex poolLock;
+std::unique_ptr<Pool> pool;
+int requested = 0;  // 0 : IMAGE_THREADS ou nombre de cœurs
+
+int defaultThreads() {
+    if (const char* env = std::getenv("IMAGE_THREADS")) {
+        const int n = std::atoi(env);
+        if (n > 0) return n;
+    }
+    return std::max(1u, std::thread::hardware_concurrency());
+}
+
+Pool& instance() {
+    std::lock_guard<std::mutex> g(poolLock);
+    if (!pool) pool = std::make_unique<Pool>(requested > 0 ? requested : defaultThreads());
+    return *pool;
+}
+
+} // namespace
+
+int threadCount() { return insidePool ? 1 : instance().size(); }
+
+void setThreadCount(int n) {
+    std::lock_guard<std::mutex> g(poolLock);
+    requested = std::max(1, n);
+    pool.reset();
+}
+
+void forRange(size_t begin, size_t end, size_t grain, const std::function<void(size_t, size_t)>& body) {
+    if (begin >= end) return;
+    grain = std::max<size_t>(grain, 1);
+    if (insidePool || end - begin <= grain) {
+        for (size_t b = begin; b < end; b += grain) body(b, std::min(b + grain, end));
+        return;
+    }
+    Pool& p = instance();
+    if (p.size() == 1) {
+        for (size_t b = begin; b < end; b += grain) body(b, std::min(b + grain, end));
+        return;
+    }
+    auto job = std::make_shared<Job>(body, begin, end, grain);
+    p.run(job);
+    if (job->error) std::rethrow_exception(job->error);
+}
+
+} // namespace parallel
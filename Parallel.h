@@ -0,0 +1,26 @@
+#ifndef PARALLEL_H
+#define PARALLEL_H
+
+#include <cstddef>
+#include <functional>
+
+// Pool de threads partagé par les opérations de voisinage (convolution, flous...).
+// Créé au premier usage ; taille : variable d'environnement IMAGE_THREADS, sinon
+// le nombre de cœurs. Plusieurs threads peuvent soumettre du travail en même
+// temps (workers de imgopd) ; un appel imbriqué depuis un thread du pool
+// s'exécute sur place, sans nouvelle répartition.
+namespace parallel {
+
+// Nombre de threads utilisés (appelant compris) ; 1 = séquentiel
+int threadCount();
+// Change la taille du pool (à appeler hors de tout forRange en cours)
+void setThreadCount(int n);
+
+// Exécute body(b, e) sur des tranches [b, e) de [begin, end) d'au plus `grain`
+// éléments, réparties entre les threads ; l'appelant participe et attend la fin.
+// La première exception levée par body est relancée dans l'appelant.
+void forRange(size_t begin, size_t end, size_t grain, const std::function<void(size_t, size_t)>& body);
+
+} // namespace parallel
+
+#endif
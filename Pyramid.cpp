@@ -0,0 +1,427 @@
+#include "ImageKernels.h"
+#include "ImageSimd.h"
+#include <algorithm>
+#include <memory>
+#include <vector>
+
+namespace kernels {
+
+namespace {
+
+constexpr int binomial[5] = {1, 4, 6, 4, 1};
+
+inline uint8_t clampByte(int v) { return static_cast<uint8_t>(std::min(255, std::max(0, v))); }
+
+// Agrandissement par 2 (pyrUp) le long d'un axe : la position 2i vaut
+// (g[i-1] + 6 g[i] + g[i+1]) / 8, la position 2i+1 (4 g[i] + 4 g[i+1]) / 8,
+// indices en miroir. Renvoie le nombre de poids (2 ou 3) et les remplit.
+int expandTaps(int y, int n, int* index, int* weight) {
+    const int i = y / 2;
+    if (y % 2 == 0) {
+        index[0] = borderIndex(i - 1, n, Border::Reflect), weight[0] = 1;
+        index[1] = borderIndex(i, n, Border::Reflect), weight[1] = 6;
+        index[2] = borderIndex(i + 1, n, Border::Reflect), weight[2] = 1;
+        return 3;
+    }
+    index[0] = borderIndex(i, n, Border::Reflect), weight[0] = 4;
+    index[1] = borderIndex(i + 1, n, Border::Reflect), weight[1] = 4;
+    return 2;
+}
+
+#ifdef IMAGE_HAVE_SSE2
+inline __m128i load8(const uint8_t* p) { return _mm_loadl_epi64(reinterpret_cast<const __m128i*>(p)); }
+#endif
+
+// === LIGNES ===
+// Les gabarits C = 1..4 fixent le nombre de canaux ; C = 0 le lit dans channels.
+
+// Box : somme des paires de pixels, le dernier doublé si w est impair
+template <int C>
+void boxRow(const uint8_t* p, int w, int channels, uint16_t* o) {
+    const size_t ch = C ? C : channels;
+    const int pairs = w / 2;
+    int x = 0;
+#ifdef IMAGE_HAVE_SSE2
+    if (C == 1) {
+        const __m128i low = _mm_set1_epi16(0x00FF);
+        for (; x + 8 <= pairs; x += 8) {
+            const __m128i v = simd::load(p + 2 * x);
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(o + x),
+                             _mm_add_epi16(_mm_and_si128(v, low), _mm_srli_epi16(v, 8)));
+        }
+    }
+    if (C == 4) {
+        // 4 pixels lus, 2 paires sommées
+        const __m128i zero = _mm_setzero_si128();
+        for (; x + 2 <= pairs; x += 2) {
+            const __m128i v = simd::load(p + 8 * x);
+            const __m128i lo = _mm_unpacklo_epi8(v, zero), hi = _mm_unpackhi_epi8(v, zero);
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(o + 4 * x),
+                             _mm_add_epi16(_mm_unpacklo_epi64(lo, hi), _mm_unpackhi_epi64(lo, hi)));
+        }
+    }
+    if (C == 2 || C == 3) {
+        // Un pixel par itération sur 4 mots : les mots en trop sont écrasés par
+        // le pixel suivant, d'où l'arrêt un pixel avant la fin
+        const __m128i zero = _mm_setzero_si128();
+        for (; x + 1 < pairs && (2 * x + 1) * ch + 8 <= static_cast<size_t>(w) * ch; ++x) {
+            const __m128i s = _mm_add_epi16(_mm_unpacklo_epi8(load8(p + 2 * x * ch), zero),
+                                            _mm_unpacklo_epi8(load8(p + (2 * x + 1) * ch), zero));
+            _mm_storel_epi64(reinterpret_cast<__m128i*>(o + x * ch), s);
+        }
+    }
+#endif
+    for (; x < pairs; ++x)
+        for (size_t c = 0; c < ch; ++c) o[x * ch + c] = static_cast<uint16_t>(p[2 * x * ch + c] + p[(2 * x + 1) * ch + c]);
+    if (w % 2)
+        for (size_t c = 0; c < ch; ++c) o[pairs * ch + c] = static_cast<uint16_t>(2 * p[(w - 1) * ch + c]);
+}
+
+// Gaussian : 1 4 6 4 1 centré sur les pixels pairs d'une ligne élargie de 2
+// pixels en miroir (q, w + 4 pixels), wn = ceil(w / 2) sorties
+template <int C>
+void binomialRow(const uint8_t* q, int wn, int channels, uint16_t* o) {
+    const size_t ch = C ? C : channels;
+    int x = 0;
+#ifdef IMAGE_HAVE_SSE2
+    if (C == 1) {
+        // Pixels pairs / impairs de trois lectures décalées de 2 : lue jusqu'à
+        // q[2x + 19] < 2 wn + 3 <= w + 4
+        const __m128i low = _mm_set1_epi16(0x00FF);
+        for (; x + 9 <= wn; x += 8) {
+            const __m128i a = simd::load(q + 2 * x), b = simd::load(q + 2 * x + 2), c = simd::load(q + 2 * x + 4);
+            const __m128i mid = _mm_and_si128(b, low);
+            __m128i s = _mm_add_epi16(_mm_and_si128(a, low), _mm_and_si128(c, low));
+            s = _mm_add_epi16(s, _mm_slli_epi16(_mm_add_epi16(_mm_add_epi16(_mm_srli_epi16(a, 8), _mm_srli_epi16(b, 8)), mid), 2));
+            s = _mm_add_epi16(s, _mm_add_epi16(mid, mid));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(o + x), s);
+        }
+    }
+    if (C >= 2) {
+        const __m128i zero = _mm_setzero_si128();
+        for (; x + 1 < wn && (2 * x + 4) * ch + 8 <= static_cast<size_t>(2 * wn + 3) * ch; ++x) {
+            const uint8_t* t = q + 2 * x * ch;
+            auto tap = [&](int k) { return _mm_unpacklo_epi8(load8(t + k * ch), zero); };
+            const __m128i mid = tap(2);
+            __m128i s = _mm_add_epi16(tap(0), tap(4));
+            s = _mm_add_epi16(s, _mm_slli_epi16(_mm_add_epi16(_mm_add_epi16(tap(1), tap(3)), mid), 2));
+            s = _mm_add_epi16(s, _mm_add_epi16(mid, mid));
+            _mm_storel_epi64(reinterpret_cast<__m128i*>(o + x * ch), s);
+        }
+    }
+#endif
+    for (; x < wn; ++x) {
+        const uint8_t* t = q + 2 * x * ch;
+        for (size_t c = 0; c < ch; ++c)
+            o[x * ch + c] = static_cast<uint16_t>(t[c] + t[4 * ch + c] + 4 * (t[ch + c] + t[3 * ch + c]) + 6 * t[2 * ch + c]);
+    }
+}
+
+// Agrandissement horizontal (somme des poids 8) d'une ligne élargie d'un pixel
+// en miroir (q, ceil(w / 2) + 2 pixels) vers w pixels
+template <int C>
+void expandRow(const uint8_t* q, int w, int channels, uint16_t* o) {
+    const size_t ch = C ? C : channels;
+    int i = 0;
+#ifdef IMAGE_HAVE_SSE2
+    if (C == 1) {
+        const __m128i zero = _mm_setzero_si128(), six = _mm_set1_epi16(6);
+        for (; 2 * i + 16 <= w; i += 8) {
+            auto load8 = [&](int k) {
+                return _mm_unpacklo_epi8(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(q + i + k)), zero);
+            };
+            const __m128i a = load8(0), b = load8(1), c = load8(2);
+            const __m128i even = _mm_add_epi16(_mm_add_epi16(a, c), _mm_mullo_epi16(b, six));
+            const __m128i odd = _mm_slli_epi16(_mm_add_epi16(b, c), 2);
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(o + 2 * i), _mm_unpacklo_epi16(even, odd));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(o + 2 * i + 8), _mm_unpackhi_epi16(even, odd));
+        }
+    }
+    if (C >= 2) {
+        // Paire de sorties par pixel de coarse sur 4 mots ; les mots en trop
+        // sont écrasés ensuite, d'où l'arrêt avant la dernière paire
+        const __m128i zero = _mm_setzero_si128(), six = _mm_set1_epi16(6);
+        const size_t end = static_cast<size_t>((w + 1) / 2) * ch;  // lecture jusqu'à q[(i + 2) ch + 7]
+        for (; 2 * i + 3 < w && i * ch + 8 <= end; ++i) {
+            const uint8_t* t = q + i * ch;
+            const __m128i a = _mm_unpacklo_epi8(load8(t), zero), b = _mm_unpacklo_epi8(load8(t + ch), zero),
+                          c = _mm_unpacklo_epi8(load8(t + 2 * ch), zero);
+            _mm_storel_epi64(reinterpret_cast<__m128i*>(o + 2 * i * ch), _mm_add_epi16(_mm_add_epi16(a, c), _mm_mullo_epi16(b, six)));
+            _mm_storel_epi64(reinterpret_cast<__m128i*>(o + (2 * i + 1) * ch), _mm_slli_epi16(_mm_add_epi16(b, c), 2));
+        }
+    }
+#endif
+    for (; 2 * i < w; ++i) {
+        const uint8_t* t = q + i * ch;
+        for (size_t c = 0; c < ch; ++c) o[2 * i * ch + c] = static_cast<uint16_t>(t[c] + 6 * t[ch + c] + t[2 * ch + c]);
+        if (2 * i + 1 < w)
+            for (size_t c = 0; c < ch; ++c) o[(2 * i + 1) * ch + c] = static_cast<uint16_t>(4 * (t[ch + c] + t[2 * ch + c]));
+    }
+}
+
+template <int C>
+struct BoxRow {
+    static void run(const uint8_t* p, int w, uint16_t* o, int channels) { boxRow<C>(p, w, channels, o); }
+};
+template <int C>
+struct BinomialRow {
+    static void run(const uint8_t* q, int wn, uint16_t* o, int channels) { binomialRow<C>(q, wn, channels, o); }
+};
+template <int C>
+struct ExpandRow {
+    static void run(const uint8_t* q, int w, uint16_t* o, int channels) { expandRow<C>(q, w, channels, o); }
+};
+
+template <template <int> class Row, typename... Args>
+void dispatch(int channels, Args... args) {
+    switch (channels) {
+        case 1: Row<1>::run(args..., channels); break;
+        case 2: Row<2>::run(args..., channels); break;
+        case 3: Row<3>::run(args..., channels); break;
+        case 4: Row<4>::run(args..., channels); break;
+        default: Row<0>::run(args..., channels); break;
+    }
+}
+
+// === AGRANDISSEMENT ===
+// Lignes de coarse agrandies à la largeur w, gardées dans 3 emplacements
+// (indice de ligne modulo 3) : une ligne de sortie lit au plus 3 lignes
+// consécutives de coarse, la suivante en partage 1 ou 2.
+class Expander {
+public:
+    Expander(const ConstSurface& coarse, int w)
+        : coarse(coarse), n(static_cast<size_t>(w) * coarse.channels),
+          wide(3 * n), pad(static_cast<size_t>(coarse.width + 2) * coarse.channels) {}
+
+    // out = base - expand + 128 (subtract) ou base + expand - 128, saturé ;
+    // expand = (somme des poids 64 + 32) >> 6, arrondi une seule fois
+    void combine(int y, const uint8_t* base, uint8_t* out, bool subtract) {
+        const uint16_t* r0 = row(borderIndex(y / 2, coarse.height, Border::Reflect));
+        const uint16_t* r1 = row(borderIndex(y / 2 + 1, coarse.height, Border::Reflect));
+        const uint16_t* rm = y % 2 ? nullptr : row(borderIndex(y / 2 - 1, coarse.height, Border::Reflect));
+        size_t i = 0;
+#ifdef IMAGE_HAVE_SSE2
+        const __m128i zero = _mm_setzero_si128(), six = _mm_set1_epi16(6), round = _mm_set1_epi16(32),
+                      bias = _mm_set1_epi16(128);
+        auto load = [&](const uint16_t* r) { return _mm_loadu_si128(reinterpret_cast<const __m128i*>(r + i)); };
+        for (; i + 8 <= n; i += 8) {
+            // Somme au plus 64 * 255 : tient sur 16 bits signés
+            const __m128i s = rm ? _mm_add_epi16(_mm_add_epi16(load(rm), load(r1)), _mm_mullo_epi16(load(r0), six))
+                                 : _mm_slli_epi16(_mm_add_epi16(load(r0), load(r1)), 2);
+            const __m128i e = _mm_srli_epi16(_mm_add_epi16(s, round), 6);
+            const __m128i b = _mm_unpacklo_epi8(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(base + i)), zero);
+            const __m128i v = subtract ? _mm_sub_epi16(_mm_add_epi16(b, bias), e) : _mm_sub_epi16(_mm_add_epi16(b, e), bias);
+            _mm_storel_epi64(reinterpret_cast<__m128i*>(out + i), _mm_packus_epi16(v, v));
+        }
+#endif
+        for (; i < n; ++i) {
+            const int e = ((rm ? rm[i] + 6 * r0[i] + r1[i] : 4 * (r0[i] + r1[i])) + 32) >> 6;
+            out[i] = clampByte(subtract ? base[i] - e + 128 : base[i] + e - 128);
+        }
+    }
+
+private:
+    const uint16_t* row(int j) {
+        uint16_t* o = wide.data() + static_cast<size_t>(j % 3) * n;
+        if (slot[j % 3] != j) {
+            padRow(coarse.row(j), coarse.width, coarse.channels, 1, Border::Reflect, pad.data());
+            dispatch<ExpandRow>(coarse.channels, static_cast<const uint8_t*>(pad.data()),
+                                static_cast<int>(n / coarse.channels), o);
+            slot[j % 3] = j;
+        }
+        return o;
+    }
+
+    ConstSurface coarse;
+    size_t n;
+    std::vector<uint16_t> wide;
+    std::vector<uint8_t> pad;
+    int slot[3] = {-1, -1, -1};
+};
+
+// === CASCADE ===
+// Les lignes du niveau k arrivent dans l'ordre ; chacune est réduite
+// horizontalement dans un anneau de 2 ou 5 lignes 16 bits, et dès que
+// l'anneau contient toutes les lignes d'une ligne du niveau k + 1, celle-ci est
+// calculée puis transmise au niveau suivant. Les lignes du laplacien L[k]
+// suivent celles de G[k + 1]. Aucun niveau n'est relu en entier : les lignes
+// lues sont les dernières écrites.
+class Cascade {
+public:
+    Cascade(const ConstSurface& src, const Surface* levels, int count, PyramidKind kind, const Surface* laplacian)
+        : kind(kind), ringRows(kind == PyramidKind::Box ? 2 : 5), out(levels, levels + count), state(count) {
+        g.push_back(src);
+        for (const Surface& s : out) g.push_back(ConstSurface{s.data, s.width, s.height, s.channels, s.stride});
+        for (int k = 0; k < count; ++k) {
+            State& s = state[k];
+            s.ring.resize(static_cast<size_t>(ringRows) * out[k].width * out[k].channels);
+            if (kind == PyramidKind::Gaussian) s.pad.resize(static_cast<size_t>(g[k].width + 4) * g[k].channels);
+            if (laplacian) {
+                s.laplacian = laplacian[k];
+                s.expander = std::make_unique<Expander>(g[k + 1], g[k].width);
+            }
+        }
+    }
+
+    void run() {
+        for (int y = 0; y < g[0].height; ++y) push(0, y);
+    }
+
+private:
+    struct State {
+        std::vector<uint16_t> ring;  // lignes du niveau k réduites horizontalement
+        std::vector<uint8_t> pad;    // ligne élargie de 2 pixels (Gaussian)
+        int produced = 0;            // lignes du niveau k + 1 écrites
+        Surface laplacian{};
+        std::unique_ptr<Expander> expander;
+        int laplacianDone = 0;
+    };
+
+    PyramidKind kind;
+    int ringRows;
+    std::vector<Surface> out;
+    std::vector<ConstSurface> g;  // g[0] = source, g[k] = levels[k - 1]
+    std::vector<State> state;
+
+    uint16_t* ringRow(int k, int y) {
+        return state[k].ring.data() + static_cast<size_t>(y % ringRows) * out[k].width * out[k].channels;
+    }
+
+    void push(int k, int r) {
+        // L[k - 1] : une ligne y attend les lignes y / 2 - 1 à y / 2 + 1 de G[k]
+        if (k > 0 && state[k - 1].expander) {
+            State& s = state[k - 1];
+            while (s.laplacianDone < g[k - 1].height && std::min(s.laplacianDone / 2 + 1, g[k].height - 1) <= r) {
+                const int y = s.laplacianDone++;
+                s.expander->combine(y, g[k - 1].row(y), s.laplacian.row(y), true);
+            }
+        }
+        if (k == static_cast<int>(out.size())) return;
+
+        State& s = state[k];
+        const int h = g[k].height, reach = kind == PyramidKind::Box ? 1 : 2;
+        reduceRow(k, r);
+        while (s.produced < g[k + 1].height && std::min(2 * s.produced + reach, h - 1) <= r) {
+            combineRows(k, s.produced);
+            push(k + 1, s.produced++);
+        }
+    }
+
+    // Ligne r du niveau k -> ligne 16 bits de largeur ceil(w / 2)
+    void reduceRow(int k, int r) {
+        const ConstSurface& in = g[k];
+        if (kind == PyramidKind::Box) {
+            dispatch<BoxRow>(in.channels, in.row(r), in.width, ringRow(k, r));
+            return;
+        }
+        uint8_t* pad = state[k].pad.data();
+        padRow(in.row(r), in.width, in.channels, 2, Border::Reflect, pad);
+        dispatch<BinomialRow>(in.channels, static_cast<const uint8_t*>(pad), out[k].width, ringRow(k, r));
+    }
+
+    // Ligne y du niveau k + 1 à partir de l'anneau du niveau k
+    void combineRows(int k, int y) {
+        const int h = g[k].height;
+        const size_t n = static_cast<size_t>(out[k].width) * out[k].channels;
+        uint8_t* o = out[k].row(y);
+        size_t i = 0;
+        if (kind == PyramidKind::Box) {
+            const uint16_t* a = ringRow(k, 2 * y);
+            const uint16_t* b = ringRow(k, std::min(2 * y + 1, h - 1));
+#ifdef IMAGE_HAVE_SSE2
+            const __m128i two = _mm_set1_epi16(2);
+            for (; i + 8 <= n; i += 8) {
+                const __m128i s = _mm_add_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i*>(a + i)),
+                                                _mm_loadu_si128(reinterpret_cast<const __m128i*>(b + i)));
+                const __m128i v = _mm_srli_epi16(_mm_add_epi16(s, two), 2);
+                _mm_storel_epi64(reinterpret_cast<__m128i*>(o + i), _mm_packus_epi16(v, v));
+            }
+#endif
+            for (; i < n; ++i) o[i] = static_cast<uint8_t>((a[i] + b[i] + 2) >> 2);
+            return;
+        }
+        const uint16_t* r[5];
+        for (int t = 0; t < 5; ++t) r[t] = ringRow(k, borderIndex(2 * y + t - 2, h, Border::Reflect));
+#ifdef IMAGE_HAVE_SSE2
+        // Somme au plus 255 * 256 + 128 : tient sur 16 bits non signés
+        const __m128i round = _mm_set1_epi16(128);
+        auto load = [&](int t) { return _mm_loadu_si128(reinterpret_cast<const __m128i*>(r[t] + i)); };
+        for (; i + 8 <= n; i += 8) {
+            const __m128i c = load(2);
+            __m128i s = _mm_add_epi16(load(0), load(4));
+            s = _mm_add_epi16(s, _mm_slli_epi16(_mm_add_epi16(_mm_add_epi16(load(1), load(3)), c), 2));
+            s = _mm_add_epi16(s, _mm_add_epi16(_mm_add_epi16(c, c), round));
+            const __m128i v = _mm_srli_epi16(s, 8);
+            _mm_storel_epi64(reinterpret_cast<__m128i*>(o + i), _mm_packus_epi16(v, v));
+        }
+#endif
+        for (; i < n; ++i) {
+            int s = 128;
+            for (int t = 0; t < 5; ++t) s += binomial[t] * r[t][i];
+            o[i] = static_cast<uint8_t>(s >> 8);
+        }
+    }
+};
+
+} // namespace
+
+void pyramid(const ConstSurface& src, const Surface* levels, int count, PyramidKind kind, const Surface* laplacian) {
+    if (count <= 0) return;
+    Cascade(src, levels, count, kind, laplacian).run();
+}
+
+void pyramidScalar(const ConstSurface& src, const Surface* levels, int count, PyramidKind kind,
+                   const Surface* laplacian) {
+    ConstSurface prev = src;
+    for (int k = 0; k < count; ++k) {
+        const Surface& next = levels[k];
+        const int C = prev.channels;
+        for (int y = 0; y < next.height; ++y)
+            for (int x = 0; x < next.width; ++x)
+                for (int c = 0; c < C; ++c) {
+                    auto at = [&](int xx, int yy) { return prev.row(yy)[static_cast<size_t>(xx) * C + c]; };
+                    int v;
+                    if (kind == PyramidKind::Box) {
+                        const int x1 = std::min(2 * x + 1, prev.width - 1), y1 = std::min(2 * y + 1, prev.height - 1);
+                        v = (at(2 * x, 2 * y) + at(x1, 2 * y) + at(2 * x, y1) + at(x1, y1) + 2) >> 2;
+                    } else {
+                        v = 128;
+                        for (int j = 0; j < 5; ++j)
+                            for (int i = 0; i < 5; ++i)
+                                v += binomial[i] * binomial[j] *
+                                     at(borderIndex(2 * x + i - 2, prev.width, Border::Reflect),
+                                        borderIndex(2 * y + j - 2, prev.height, Border::Reflect));
+                        v >>= 8;
+                    }
+                    next.row(y)[static_cast<size_t>(x) * C + c] = static_cast<uint8_t>(v);
+                }
+        const ConstSurface cur{next.data, next.width, next.height, next.channels, next.stride};
+        if (laplacian) {
+            // Agrandissement 2D direct : produit des poids 1D, une seule division par 64
+            const Surface& lap = laplacian[k];
+            int rx[3], wx[3], ry[3], wy[3];
+            for (int y = 0; y < prev.height; ++y) {
+                const int ny = expandTaps(y, cur.height, ry, wy);
+                for (int x = 0; x < prev.width; ++x) {
+                    const int nx = expandTaps(x, cur.width, rx, wx);
+                    for (int c = 0; c < C; ++c) {
+                        int e = 32;
+                        for (int j = 0; j < ny; ++j)
+                            for (int i = 0; i < nx; ++i)
+                                e += wy[j] * wx[i] * cur.row(ry[j])[static_cast<size_t>(rx[i]) * C + c];
+                        const int g = prev.row(y)[static_cast<size_t>(x) * C + c];
+                        lap.row(y)[static_cast<size_t>(x) * C + c] = clampByte(g - (e >> 6) + 128);
+                    }
+                }
+            }
+        }
+        prev = cur;
+    }
+}
+
+void expandAdd(const ConstSurface& coarse, const ConstSurface& detail, const Surface& dst) {
+    Expander expander(coarse, dst.width);
+    for (int y = 0; y < dst.height; ++y) expander.combine(y, detail.row(y), dst.row(y), false);
+}
+
+} // namespace kernels
@@ -0,0 +1,225 @@
+#include "ImageKernels.h"
+#include "ImageSimd.h"
+#include "Parallel.h"
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+namespace kernels {
+
+namespace {
+
+// === RÉSEAUX DE TRI (r <= 2) ===
+// Tri pair-impair de Batcher sur la puissance de 2 supérieure ; les
+// comparateurs qui touchent un indice >= n sont retirés (éléments virtuels
+// à +inf, déjà en place), puis ceux dont la sortie k ne dépend pas.
+using Network = std::vector<std::pair<int, int>>;
+
+Network selectionNetwork(int n, int k) {
+    int N = 1;
+    while (N < n) N <<= 1;
+    Network all;
+    for (int p = 1; p < N; p <<= 1)
+        for (int q = p; q >= 1; q >>= 1)
+            for (int j = q % p; j + q < N; j += 2 * q)
+                for (int i = 0; i < std::min(q, N - j - q); ++i)
+                    if ((i + j) / (2 * p) == (i + j + q) / (2 * p) && i + j + q < n) all.emplace_back(i + j, i + j + q);
+
+    std::vector<bool> needed(n, false);
+    needed[k] = true;
+    Network kept;
+    for (auto it = all.rbegin(); it != all.rend(); ++it)
+        if (needed[it->first] || needed[it->second]) {
+            needed[it->first] = needed[it->second] = true;
+            kept.push_back(*it);
+        }
+    std::reverse(kept.begin(), kept.end());
+    return kept;
+}
+
+void rankNetwork(const ConstSurface& src, const Surface& dst, int r, int k, Border border) {
+    const int W = src.width, H = src.height, C = src.channels, d = 2 * r + 1, n = d * d;
+    const Network net = selectionNetwork(n, k);
+    const size_t samples = static_cast<size_t>(W) * C;
+    const size_t padded = static_cast<size_t>(W + 2 * r) * C;
+    const std::vector<uint8_t> zero(padded, 0);
+
+    parallel::forRange(0, H, 32, [&](size_t first, size_t last) {
+        const int y0 = static_cast<int>(first), y1 = static_cast<int>(last);
+        std::vector<uint8_t> pad(static_cast<size_t>(y1 - y0 + 2 * r) * padded);
+        std::vector<const uint8_t*> prow(y1 - y0 + 2 * r, zero.data());
+        for (int i = 0; i < y1 - y0 + 2 * r; ++i) {
+            const int yy = borderIndex(y0 - r + i, H, border);
+            if (yy < 0) continue;
+            uint8_t* out = pad.data() + static_cast<size_t>(i) * padded;
+            padRow(src.row(yy), W, C, r, border, out);
+            prow[i] = out;
+        }
+        uint8_t win[25];
+        for (int y = y0; y < y1; ++y) {
+            const uint8_t* const* rows = prow.data() + (y - y0);
+            uint8_t* out = dst.row(y);
+            size_t s = 0;
+#ifdef IMAGE_HAVE_SSE2
+            __m128i v[25];
+            for (; s + 16 <= samples; s += 16) {
+                for (int j = 0; j < d; ++j)
+                    for (int i = 0; i < d; ++i) v[j * d + i] = simd::load(rows[j] + s + static_cast<size_t>(i) * C);
+                for (const auto& [a, b] : net) {
+                    const __m128i lo = _mm_min_epu8(v[a], v[b]);
+                    v[b] = _mm_max_epu8(v[a], v[b]);
+                    v[a] = lo;
+                }
+                simd::store(out + s, v[k]);
+            }
+#endif
+            for (; s < samples; ++s) {
+                for (int j = 0; j < d; ++j)
+                    for (int i = 0; i < d; ++i) win[j * d + i] = rows[j][s + static_cast<size_t>(i) * C];
+                for (const auto& [a, b] : net)
+                    if (win[a] > win[b]) std::swap(win[a], win[b]);
+                out[s] = win[k];
+            }
+        }
+    });
+}
+
+// === HISTOGRAMMES GLISSANTS (r > 2) ===
+// Perreault & Hébert : un histogramme par colonne (fenêtre verticale de 2r+1
+// lignes), mis à jour d'une ligne à l'autre par un retrait et un ajout ;
+// l'histogramme de la fenêtre glisse horizontalement par somme et différence
+// de deux histogrammes de colonne. Deux niveaux : les 16 classes grossières
+// suivent chaque pixel, les 16 classes fines d'une classe grossière ne sont
+// mises à jour que lorsque la k-ième valeur y tombe (rattrapage des colonnes
+// manquées, ou reconstruction si plus de 2r+1). Traitement par tuiles de
+// colonnes et bandes de lignes : histogrammes d'une tuile en cache L2.
+constexpr int tileWidth = 128;
+constexpr int bandHeight = 64;
+
+struct Histograms {
+    std::vector<uint16_t> fine;    // 256 classes par colonne
+    std::vector<uint16_t> coarse;  // 16 classes par colonne
+
+    void reset(size_t columns) {
+        fine.assign(columns * 256, 0);
+        coarse.assign(columns * 16, 0);
+    }
+    void add(size_t col, uint8_t v) { ++fine[col * 256 + v]; ++coarse[col * 16 + (v >> 4)]; }
+    void remove(size_t col, uint8_t v) { --fine[col * 256 + v]; --coarse[col * 16 + (v >> 4)]; }
+};
+
+inline void addHist(uint32_t* h, const uint16_t* a, const uint16_t* b, int bins) {
+    for (int i = 0; i < bins; ++i) h[i] = h[i] + a[i] - b[i];
+}
+
+// Histogramme de la fenêtre : colonnes [x, x + d) de la tuile. Une colonne
+// compte au plus 2r+1 échantillons (uint16_t), la fenêtre (2r+1)² : uint32_t
+struct Window {
+    const Histograms& cols;
+    int d;
+    uint32_t coarse[16];
+    uint32_t fine[256];
+    int valid[16];  // position x à laquelle chaque segment fin est à jour
+
+    Window(const Histograms& h, int diameter) : cols(h), d(diameter) {}
+
+    void start() {
+        std::memset(coarse, 0, sizeof(coarse));
+        for (int j = 0; j < d; ++j) addHist(coarse, &cols.coarse[j * 16], zero16, 16);
+        std::fill(valid, valid + 16, -1 - d);
+    }
+    void step(int x) { addHist(coarse, &cols.coarse[(x + d - 1) * 16], &cols.coarse[(x - 1) * 16], 16); }
+
+    uint8_t kth(int x, int k) {
+        uint32_t acc = 0;
+        int b = 0;
+        const uint32_t target = static_cast<uint32_t>(k);
+        while (acc + coarse[b] <= target) acc += coarse[b++];
+        uint32_t* f = fine + b * 16;
+        if (x - valid[b] > d) {
+            std::memset(f, 0, 16 * sizeof(uint32_t));
+            for (int j = x; j < x + d; ++j) addHist(f, &cols.fine[j * 256 + b * 16], zero16, 16);
+        } else {
+            for (int t = valid[b] + 1; t <= x; ++t)
+                addHist(f, &cols.fine[(t + d - 1) * 256 + b * 16], &cols.fine[(t - 1) * 256 + b * 16], 16);
+        }
+        valid[b] = x;
+        int v = 0;
+        while (acc + f[v] <= target) acc += f[v++];
+        return static_cast<uint8_t>(b * 16 + v);
+    }
+
+    static constexpr uint16_t zero16[16] = {};
+};
+
+void rankHistogram(const ConstSurface& src, const Surface& dst, int r, int k, Border border) {
+    const int W = src.width, H = src.height, C = src.channels, d = 2 * r + 1;
+    const int tiles = (W + tileWidth - 1) / tileWidth, bands = (H + bandHeight - 1) / bandHeight;
+
+    parallel::forRange(0, static_cast<size_t>(tiles) * bands, 1, [&](size_t first, size_t last) {
+        Histograms cols;
+        Window win(cols, d);
+        std::vector<int> sx;
+        for (size_t task = first; task < last; ++task) {
+            const int x0 = static_cast<int>(task % tiles) * tileWidth, x1 = std::min(W, x0 + tileWidth);
+            const int y0 = static_cast<int>(task / tiles) * bandHeight, y1 = std::min(H, y0 + bandHeight);
+            const int ncols = x1 - x0 + 2 * r;
+            sx.resize(ncols);
+            for (int j = 0; j < ncols; ++j) sx[j] = borderIndex(x0 - r + j, W, border);
+            auto value = [&](int yy, int j, int c) -> uint8_t {
+                return yy < 0 || sx[j] < 0 ? 0 : src.row(yy)[static_cast<size_t>(sx[j]) * C + c];
+            };
+
+            for (int c = 0; c < C; ++c) {
+                cols.reset(ncols);
+                for (int i = -r; i <= r; ++i) {
+                    const int yy = borderIndex(y0 + i, H, border);
+                    for (int j = 0; j < ncols; ++j) cols.add(j, value(yy, j, c));
+                }
+                for (int y = y0; y < y1; ++y) {
+                    uint8_t* out = dst.row(y) + static_cast<size_t>(x0) * C + c;
+                    win.start();
+                    for (int x = 0; x < x1 - x0; ++x, out += C) {
+                        if (x > 0) win.step(x);
+                        *out = win.kth(x, k);
+                    }
+                    if (y + 1 == y1) break;
+                    const int drop = borderIndex(y - r, H, border), take = borderIndex(y + r + 1, H, border);
+                    for (int j = 0; j < ncols; ++j) {
+                        cols.remove(j, value(drop, j, c));
+                        cols.add(j, value(take, j, c));
+                    }
+                }
+            }
+        }
+    });
+}
+
+} // namespace
+
+void rankFilter(const ConstSurface& src, const Surface& dst, int radius, int k, Border border) {
+    if (radius < 0 || radius > maxRankRadius) throw std::invalid_argument("rankFilter: radius out of [0, 16383]");
+    if (radius <= 2) rankNetwork(src, dst, radius, k, border);
+    else rankHistogram(src, dst, radius, k, border);
+}
+
+void rankFilterScalar(const ConstSurface& src, const Surface& dst, int radius, int k, Border border) {
+    const int W = src.width, H = src.height, C = src.channels;
+    std::vector<uint8_t> win;
+    for (int y = 0; y < H; ++y)
+        for (int x = 0; x < W; ++x)
+            for (int c = 0; c < C; ++c) {
+                win.clear();
+                for (int j = y - radius; j <= y + radius; ++j)
+                    for (int i = x - radius; i <= x + radius; ++i) {
+                        const int yy = borderIndex(j, H, border), xx = borderIndex(i, W, border);
+                        win.push_back(yy < 0 || xx < 0 ? 0 : src.row(yy)[static_cast<size_t>(xx) * C + c]);
+                    }
+                std::nth_element(win.begin(), win.begin() + k, win.end());
+                dst.row(y)[static_cast<size_t>(x) * C + c] = win[k];
+            }
+}
+
+} // namespace kernels
@@ -0,0 +1,334 @@
+#include "ImageKernels.h"
+#include "ImageSimd.h"
+#include "Parallel.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <vector>
+
+namespace kernels {
+
+namespace {
+
+constexpr int weightBits = 14;   // poids Q14
+constexpr int interShift = 8;    // u8 x Q14 -> intermédiaire Q6
+constexpr int finalShift = 20;   // Q6 x Q14 -> Q20 -> u8
+
+// === FILTRES ===
+double filterRadius(ResizeFilter filter) {
+    switch (filter) {
+        case ResizeFilter::Bilinear: return 1.0;
+        case ResizeFilter::Bicubic:  return 2.0;
+        case ResizeFilter::Lanczos3: return 3.0;
+        default:                     return 0.5;
+    }
+}
+
+double filterWeight(ResizeFilter filter, double x) {
+    const double pi = 3.14159265358979323846;
+    x = std::fabs(x);
+    switch (filter) {
+        case ResizeFilter::Bilinear: return std::max(0.0, 1.0 - x);
+        case ResizeFilter::Bicubic: {
+            const double a = -0.5;
+            if (x < 1) return ((a + 2) * x - (a + 3)) * x * x + 1;
+            if (x < 2) return ((a * x - 5 * a) * x + 8 * a) * x - 4 * a;
+            return 0;
+        }
+        case ResizeFilter::Lanczos3:
+            if (x == 0) return 1;
+            if (x < 3) return 3 * std::sin(pi * x) * std::sin(pi * x / 3) / (pi * pi * x * x);
+            return 0;
+        default: return x <= 0.5 ? 1 : 0;
+    }
+}
+
+// Entrée la plus proche du centre de la sortie i
+int nearestIndex(int i, int srcSize, int dstSize) {
+    return std::min(static_cast<int>((2 * static_cast<int64_t>(i) + 1) * srcSize / (2 * dstSize)), srcSize - 1);
+}
+
+// Facteur 2^k (k <= 4) entre src et dst, 0 sinon
+int boxFactor(int srcSize, int dstSize) {
+    if (srcSize % dstSize) return 0;
+    const int f = srcSize / dstSize;
+    return f <= 16 && (f & (f - 1)) == 0 ? f : 0;
+}
+
+#ifdef IMAGE_HAVE_SSE2
+inline __m128i load32(const uint8_t* p) {
+    int v;
+    std::memcpy(&v, p, 4);
+    return _mm_cvtsi32_si128(v);
+}
+
+inline __m128i weightPair(int16_t a, int16_t b) {
+    return _mm_set1_epi32(static_cast<int>(static_cast<uint16_t>(a) | (static_cast<uint32_t>(static_cast<uint16_t>(b)) << 16)));
+}
+#endif
+
+// Poids nuls ajoutés jusqu'à un multiple de `multiple` taps (lus dans la marge de la ligne)
+void widenTaps(ResampleTable& t, int multiple) {
+    const int taps = (t.taps + multiple - 1) / multiple * multiple;
+    if (taps == t.taps) return;
+    std::vector<int16_t> w(t.start.size() * taps, 0);
+    for (size_t i = 0; i < t.start.size(); ++i)
+        std::copy_n(t.weights.begin() + i * t.taps, t.taps, w.begin() + i * taps);
+    t.taps = taps;
+    t.weights = std::move(w);
+}
+
+inline int16_t clamp16(int v) { return static_cast<int16_t>(std::min(32767, std::max(-32768, v))); }
+
+// === PASSE HORIZONTALE ===
+// row : ligne source suivie d'au moins 16 octets nuls ; out : dw * C valeurs Q6
+// (plus une de marge pour C = 3). Pour C = 1, taps multiple de 8 (widenTaps).
+void horizontalRow(const uint8_t* row, int C, const ResampleTable& t, int dw, int16_t* out) {
+    const int taps = t.taps;
+    int x = 0;
+#ifdef IMAGE_HAVE_SSE2
+    const __m128i zero = _mm_setzero_si128(), round = _mm_set1_epi32(1 << (interShift - 1));
+    if (C == 3 || C == 4) {
+        // Deux pixels par pmaddwd : octets entrelacés (c0 a, c0 b, c1 a, c1 b...)
+        for (; x < dw; ++x) {
+            const uint8_t* p = row + static_cast<size_t>(t.start[x]) * C;
+            const int16_t* w = t.weights.data() + static_cast<size_t>(x) * taps;
+            __m128i acc = zero;
+            for (int k = 0; k < taps; k += 2, p += 2 * C) {
+                const __m128i v = _mm_unpacklo_epi8(_mm_unpacklo_epi8(load32(p), load32(p + C)), zero);
+                acc = _mm_add_epi32(acc, _mm_madd_epi16(v, weightPair(w[k], w[k + 1])));
+            }
+            acc = _mm_srai_epi32(_mm_add_epi32(acc, round), interShift);
+            _mm_storel_epi64(reinterpret_cast<__m128i*>(out + static_cast<size_t>(x) * C), _mm_packs_epi32(acc, acc));
+        }
+    } else if (C == 1) {
+        // Huit entrées consécutives par pmaddwd, somme des quatre voies à la fin
+        for (; x < dw; ++x) {
+            const uint8_t* p = row + t.start[x];
+            const int16_t* w = t.weights.data() + static_cast<size_t>(x) * taps;
+            __m128i acc = zero;
+            int k = 0;
+            for (; k + 8 <= taps; k += 8)
+                acc = _mm_add_epi32(acc, _mm_madd_epi16(_mm_unpacklo_epi8(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(p + k)), zero),
+                                                        _mm_loadu_si128(reinterpret_cast<const __m128i*>(w + k))));
+            acc = _mm_add_epi32(acc, _mm_shuffle_epi32(acc, _MM_SHUFFLE(1, 0, 3, 2)));
+            acc = _mm_add_epi32(acc, _mm_shuffle_epi32(acc, _MM_SHUFFLE(2, 3, 0, 1)));
+            int sum = _mm_cvtsi128_si32(acc);
+            for (; k < taps; ++k) sum += w[k] * p[k];
+            out[x] = clamp16((sum + (1 << (interShift - 1))) >> interShift);
+        }
+    }
+#endif
+    for (; x < dw; ++x) {
+        const uint8_t* p = row + static_cast<size_t>(t.start[x]) * C;
+        const int16_t* w = t.weights.data() + static_cast<size_t>(x) * taps;
+        for (int c = 0; c < C; ++c) {
+            int sum = 0;
+            for (int k = 0; k < taps; ++k) sum += w[k] * p[k * C + c];
+            out[static_cast<size_t>(x) * C + c] = clamp16((sum + (1 << (interShift - 1))) >> interShift);
+        }
+    }
+}
+
+// === PASSE VERTICALE ===
+void verticalRow(const int16_t* const* rows, const int16_t* w, int taps, uint8_t* out, size_t n) {
+    size_t i = 0;
+#ifdef IMAGE_HAVE_SSE2
+    const __m128i round = _mm_set1_epi32(1 << (finalShift - 1));
+    for (; i + 8 <= n; i += 8) {
+        __m128i lo = _mm_setzero_si128(), hi = lo;
+        for (int k = 0; k < taps; k += 2) {
+            const __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(rows[k] + i));
+            const __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(rows[k + 1] + i));
+            const __m128i wv = weightPair(w[k], w[k + 1]);
+            lo = _mm_add_epi32(lo, _mm_madd_epi16(_mm_unpacklo_epi16(a, b), wv));
+            hi = _mm_add_epi32(hi, _mm_madd_epi16(_mm_unpackhi_epi16(a, b), wv));
+        }
+        lo = _mm_srai_epi32(_mm_add_epi32(lo, round), finalShift);
+        hi = _mm_srai_epi32(_mm_add_epi32(hi, round), finalShift);
+        const __m128i v = _mm_packs_epi32(lo, hi);
+        _mm_storel_epi64(reinterpret_cast<__m128i*>(out + i), _mm_packus_epi16(v, v));
+    }
+#endif
+    for (; i < n; ++i) {
+        int sum = 0;
+        for (int k = 0; k < taps; ++k) sum += w[k] * rows[k][i];
+        out[i] = static_cast<uint8_t>(std::min(255, std::max(0, (sum + (1 << (finalShift - 1))) >> finalShift)));
+    }
+}
+
+// === CHEMINS DIRECTS ===
+void resizeNearest(const ConstSurface& src, const Surface& dst) {
+    const int C = src.channels;
+    std::vector<size_t> offset(dst.width);
+    for (int x = 0; x < dst.width; ++x) offset[x] = static_cast<size_t>(nearestIndex(x, src.width, dst.width)) * C;
+    parallel::forRange(0, dst.height, 64, [&](size_t first, size_t last) {
+        for (size_t y = first; y < last; ++y) {
+            const uint8_t* in = src.row(nearestIndex(static_cast<int>(y), src.height, dst.height));
+            uint8_t* out = dst.row(static_cast<int>(y));
+            for (int x = 0; x < dst.width; ++x, out += C) std::memcpy(out, in + offset[x], C);
+        }
+    });
+}
+
+// Area par fx x fy (puissances de 2, produit <= 256) : sommes de blocs sur
+// 16 bits, (somme + moitié) >> log2(fx * fy). Égal aux tables Q14 : poids
+// 2^14 / f exacts, intermédiaire Q6 sans arrondi pour f <= 64.
+void resizeBox(const ConstSurface& src, const Surface& dst, int fx, int fy) {
+    const int C = src.channels;
+    const size_t n = static_cast<size_t>(src.width) * C;
+    int shift = 0;
+    while ((1 << shift) < fx * fy) ++shift;
+    const uint32_t half = (1u << shift) >> 1;
+    parallel::forRange(0, dst.height, 16, [&](size_t first, size_t last) {
+        std::vector<uint16_t> acc(n);
+        for (size_t y = first; y < last; ++y) {
+            std::fill(acc.begin(), acc.end(), 0);
+            for (int r = 0; r < fy; ++r) {
+                const uint8_t* in = src.row(static_cast<int>(y) * fy + r);
+                size_t i = 0;
+#ifdef IMAGE_HAVE_SSE2
+                const __m128i zero = _mm_setzero_si128();
+                for (; i + 16 <= n; i += 16) {
+                    const __m128i v = simd::load(in + i);
+                    __m128i* a = reinterpret_cast<__m128i*>(acc.data() + i);
+                    _mm_storeu_si128(a, _mm_add_epi16(_mm_loadu_si128(a), _mm_unpacklo_epi8(v, zero)));
+                    _mm_storeu_si128(a + 1, _mm_add_epi16(_mm_loadu_si128(a + 1), _mm_unpackhi_epi8(v, zero)));
+                }
+#endif
+                for (; i < n; ++i) acc[i] = static_cast<uint16_t>(acc[i] + in[i]);
+            }
+            uint8_t* out = dst.row(static_cast<int>(y));
+            for (int x = 0; x < dst.width; ++x)
+                for (int c = 0; c < C; ++c) {
+                    uint32_t s = 0;
+                    for (int k = 0; k < fx; ++k) s += acc[(static_cast<size_t>(x) * fx + k) * C + c];
+                    out[static_cast<size_t>(x) * C + c] = static_cast<uint8_t>((s + half) >> shift);
+                }
+        }
+    });
+}
+
+} // namespace
+
+// === TABLES ===
+ResampleTable resampleTable(int srcSize, int dstSize, ResizeFilter filter) {
+    const double scale = static_cast<double>(srcSize) / dstSize;
+    const double fs = std::max(scale, 1.0);
+    const double support = filterRadius(filter) * fs;
+
+    // Poids flottants par sortie, déjà repliés sur [0, n) : fenêtre [lo[i], lo[i] + size)
+    std::vector<int> lo(dstSize);
+    std::vector<std::vector<double>> raw(dstSize);
+    for (int i = 0; i < dstSize; ++i) {
+        int a, b;  // entrées [a, b) touchées avant repli
+        std::vector<double> w;
+        if (filter == ResizeFilter::Nearest) {
+            a = nearestIndex(i, srcSize, dstSize);
+            b = a + 1;
+            w = {1.0};
+        } else if (filter == ResizeFilter::Area) {
+            const double x0 = i * scale, x1 = (i + 1) * scale;
+            a = static_cast<int>(std::floor(x0));
+            b = static_cast<int>(std::ceil(x1));
+            for (int j = a; j < b; ++j) w.push_back(std::min(x1, j + 1.0) - std::max(x0, static_cast<double>(j)));
+        } else {
+            const double center = (i + 0.5) * scale;
+            a = static_cast<int>(std::floor(center - support));
+            b = static_cast<int>(std::ceil(center + support)) + 1;
+            for (int j = a; j < b; ++j) w.push_back(filterWeight(filter, (j + 0.5 - center) / fs));
+        }
+        // Poids nuls aux extrémités retirés, puis repli sur le bord (réplication)
+        while (w.size() > 1 && w.back() == 0) { w.pop_back(); --b; }
+        while (w.size() > 1 && w.front() == 0) { w.erase(w.begin()); ++a; }
+        const int first = std::clamp(a, 0, srcSize - 1), lastIdx = std::clamp(b - 1, 0, srcSize - 1);
+        std::vector<double>& f = raw[i];
+        f.assign(lastIdx - first + 1, 0.0);
+        for (int j = a; j < b; ++j) f[std::clamp(j, 0, srcSize - 1) - first] += w[j - a];
+        lo[i] = first;
+    }
+
+    ResampleTable t;
+    for (const auto& f : raw) t.taps = std::max(t.taps, static_cast<int>(f.size()));
+    t.taps += t.taps % 2;
+    t.start.resize(dstSize);
+    t.weights.assign(static_cast<size_t>(dstSize) * t.taps, 0);
+    for (int i = 0; i < dstSize; ++i) {
+        const std::vector<double>& f = raw[i];
+        const int start = std::max(0, std::min(lo[i], srcSize - t.taps));
+        t.start[i] = start;
+        double total = 0;
+        for (double v : f) total += v;
+        // Q14 arrondi ; l'écart à 16384 va au plus grand poids (somme exacte)
+        int16_t* w = t.weights.data() + static_cast<size_t>(i) * t.taps + (lo[i] - start);
+        int sum = 0, big = 0;
+        for (size_t k = 0; k < f.size(); ++k) {
+            w[k] = static_cast<int16_t>(std::lround(f[k] / total * (1 << weightBits)));
+            sum += w[k];
+            if (std::abs(w[k]) > std::abs(w[big])) big = static_cast<int>(k);
+        }
+        w[big] = static_cast<int16_t>(w[big] + (1 << weightBits) - sum);
+    }
+    return t;
+}
+
+// === REDIMENSIONNEMENT ===
+void resize(const ConstSurface& src, const Surface& dst, ResizeFilter filter) {
+    if (filter == ResizeFilter::Nearest) return resizeNearest(src, dst);
+    const int fx = boxFactor(src.width, dst.width), fy = boxFactor(src.height, dst.height);
+    if (filter == ResizeFilter::Area && fx && fy) return resizeBox(src, dst, fx, fy);
+
+    const int W = src.width, H = src.height, C = src.channels;
+    ResampleTable tx = resampleTable(W, dst.width, filter);
+    const ResampleTable ty = resampleTable(H, dst.height, filter);
+    if (C == 1) widenTaps(tx, 8);
+    const size_t in = static_cast<size_t>(W) * C, out = static_cast<size_t>(dst.width) * C;
+
+    // Bande de lignes de sortie : passe horizontale des seules lignes sources
+    // qu'elle lit (intermédiaire local, en cache), puis passe verticale
+    parallel::forRange(0, dst.height, 16, [&](size_t first, size_t last) {
+        // start n'est pas forcément croissant (poids nuls retirés aux extrémités)
+        const auto [lo, hi] = std::minmax_element(ty.start.begin() + first, ty.start.begin() + last);
+        const int r0 = *lo, r1 = std::min(H, *hi + ty.taps);
+        std::vector<uint8_t> row(in + 16, 0);
+        std::vector<int16_t> inter(static_cast<size_t>(r1 - r0) * out + 8);
+        std::vector<const int16_t*> rows(ty.taps);
+        for (int r = r0; r < r1; ++r) {
+            std::memcpy(row.data(), src.row(r), in);
+            horizontalRow(row.data(), C, tx, dst.width, inter.data() + static_cast<size_t>(r - r0) * out);
+        }
+        for (size_t y = first; y < last; ++y) {
+            for (int k = 0; k < ty.taps; ++k)
+                rows[k] = inter.data() + static_cast<size_t>(std::min(ty.start[y] + k, r1 - 1) - r0) * out;
+            verticalRow(rows.data(), ty.weights.data() + y * ty.taps, ty.taps, dst.row(static_cast<int>(y)), out);
+        }
+    });
+}
+
+void resizeScalar(const ConstSurface& src, const Surface& dst, ResizeFilter filter) {
+    const int W = src.width, H = src.height, C = src.channels;
+    const ResampleTable tx = resampleTable(W, dst.width, filter), ty = resampleTable(H, dst.height, filter);
+    const size_t out = static_cast<size_t>(dst.width) * C;
+    std::vector<int16_t> inter(static_cast<size_t>(H) * out);
+    for (int y = 0; y < H; ++y)
+        for (int x = 0; x < dst.width; ++x)
+            for (int c = 0; c < C; ++c) {
+                int sum = 0;
+                for (int k = 0; k < tx.taps; ++k) {
+                    const int j = tx.start[x] + k;
+                    if (j < W) sum += tx.weights[static_cast<size_t>(x) * tx.taps + k] * src.row(y)[static_cast<size_t>(j) * C + c];
+                }
+                inter[y * out + static_cast<size_t>(x) * C + c] = clamp16((sum + (1 << (interShift - 1))) >> interShift);
+            }
+    for (int y = 0; y < dst.height; ++y)
+        for (size_t i = 0; i < out; ++i) {
+            int sum = 0;
+            for (int k = 0; k < ty.taps; ++k) {
+                const int j = ty.start[y] + k;
+                if (j < H) sum += ty.weights[static_cast<size_t>(y) * ty.taps + k] * inter[j * out + i];
+            }
+            dst.row(y)[i] = static_cast<uint8_t>(std::min(255, std::max(0, (sum + (1 << (finalShift - 1))) >> finalShift)));
+        }
+}
+
+} // namespace kernels
@@ -0,0 +1,70 @@
+#include "StructuringElement.h"
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+
+StructuringElement::StructuringElement() = default;
+
+StructuringElement::StructuringElement(int w, int h, std::vector<uint8_t> p) : width(w), height(h), points(std::move(p)) {
+    if (w <= 0 || h <= 0 || w % 2 == 0 || h % 2 == 0)
+        throw std::invalid_argument("Structuring element dimensions must be odd: " + std::to_string(w) + "x" +
+                                    std::to_string(h));
+    if (points.size() != static_cast<size_t>(w) * h)
+        throw std::invalid_argument("Structuring element expects " + std::to_string(w * h) + " points");
+    for (uint8_t& v : points) v = v != 0;
+    if (std::find(points.begin(), points.end(), 1) == points.end())
+        throw std::invalid_argument("Structuring element has no active point");
+}
+
+StructuringElement StructuringElement::rectangle(int w, int h) {
+    return StructuringElement(w, h, std::vector<uint8_t>(static_cast<size_t>(std::max(w, 0)) * std::max(h, 0), 1));
+}
+
+StructuringElement StructuringElement::square(int radius) {
+    if (radius < 0) throw std::invalid_argument("StructuringElement::square: negative radius");
+    return rectangle(2 * radius + 1, 2 * radius + 1);
+}
+
+StructuringElement StructuringElement::cross(int radius) {
+    if (radius < 0) throw std::invalid_argument("StructuringElement::cross: negative radius");
+    const int n = 2 * radius + 1;
+    std::vector<uint8_t> p(static_cast<size_t>(n) * n, 0);
+    for (int i = 0; i < n; ++i) p[static_cast<size_t>(radius) * n + i] = p[static_cast<size_t>(i) * n + radius] = 1;
+    return StructuringElement(n, n, std::move(p));
+}
+
+StructuringElement StructuringElement::disk(int radius) {
+    if (radius < 0) throw std::invalid_argument("StructuringElement::disk: negative radius");
+    const int n = 2 * radius + 1;
+    std::vector<uint8_t> p(static_cast<size_t>(n) * n);
+    for (int y = -radius; y <= radius; ++y)
+        for (int x = -radius; x <= radius; ++x)
+            p[static_cast<size_t>(y + radius) * n + x + radius] = x * x + y * y <= radius * radius;
+    return StructuringElement(n, n, std::move(p));
+}
+
+int StructuringElement::getWidth() const { return width; }
+int StructuringElement::getHeight() const { return height; }
+bool StructuringElement::operator()(int x, int y) const { return points[static_cast<size_t>(y) * width + x]; }
+
+bool StructuringElement::isRectangle() const {
+    return !points.empty() && std::find(points.begin(), points.end(), 0) == points.end();
+}
+
+StructuringElement StructuringElement::reflected() const {
+    StructuringElement r = *this;
+    std::reverse(r.points.begin(), r.points.end());
+    return r;
+}
+
+std::vector<StructuringElement::Run> StructuringElement::runs() const {
+    std::vector<Run> res;
+    for (int y = 0; y < height; ++y)
+        for (int x = 0; x < width; ++x) {
+            if (!(*this)(x, y)) continue;
+            const int start = x;
+            while (x + 1 < width && (*this)(x + 1, y)) ++x;
+            res.push_back({start - width / 2, y - height / 2, x - start + 1});
+        }
+    return res;
+}
@@ -0,0 +1,47 @@
+#ifndef STRUCTURING_ELEMENT_H
+#define STRUCTURING_ELEMENT_H
+
+#include <cstdint>
+#include <vector>
+
+// Élément structurant de la morphologie (erode, dilate, open, close) :
+// dimensions impaires, ancré en son centre, au moins un point actif.
+class StructuringElement {
+private:
+    int width = 0;
+    int height = 0;
+    std::vector<uint8_t> points;  // 0 ou 1, ligne par ligne
+
+public:
+    // Segment horizontal de points actifs, relatif au centre :
+    // (dx, dy) à (dx + length - 1, dy)
+    struct Run {
+        int dx;
+        int dy;
+        int length;
+    };
+
+    StructuringElement();
+    // std::invalid_argument si une dimension est paire, si points n'a pas
+    // w * h éléments ou s'il n'a aucun point actif
+    StructuringElement(int w, int h, std::vector<uint8_t> points);
+
+    // Formes usuelles
+    static StructuringElement rectangle(int w, int h);  // w, h impairs
+    static StructuringElement square(int radius);       // (2r+1) x (2r+1)
+    static StructuringElement cross(int radius);        // ligne et colonne centrales
+    static StructuringElement disk(int radius);         // x² + y² <= r²
+
+    int getWidth() const;
+    int getHeight() const;
+    bool operator()(int x, int y) const;
+
+    // Tous les points actifs : chemin séparable à coût constant
+    bool isRectangle() const;
+    // Symétrique par rapport au centre (dilatation : max de f(x - b))
+    StructuringElement reflected() const;
+    // Décomposition ligne par ligne, de haut en bas
+    std::vector<Run> runs() const;
+};
+
+#endif
@@ -0,0 +1,166 @@
+#include "Trace.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace trace {
+
+std::atomic<bool> recording{false};
+
+namespace {
+
+struct Event {
+    const char* name;
+    uint64_t ns;
+    int width, height, channels;
+    char phase;  // 'B' ou 'E'
+};
+
+// Un buffer par thread : l'ajout ne prend que le verrou du thread (jamais
+// disputé, sauf pendant stop()). Les buffers survivent à leur thread.
+struct ThreadBuffer {
+    std::mutex lock;
+    std::vector<Event> events;
+    uint32_t tid = 0;
+    std::string name;
+};
+
+struct Registry {
+    std::mutex lock;
+    std::vector<std::unique_ptr<ThreadBuffer>> threads;
+    std::string filename;
+    uint64_t origin = 0;
+    uint32_t nextTid = 1;
+};
+
+Registry& registry() {
+    static Registry r;
+    return r;
+}
+
+thread_local ThreadBuffer* local = nullptr;
+thread_local const char* current = nullptr;  // portée la plus interne du thread
+
+uint64_t now() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+               std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+ThreadBuffer& buffer() {
+    if (!local) {
+        Registry& r = registry();
+        std::lock_guard<std::mutex> guard(r.lock);
+        r.threads.push_back(std::make_unique<ThreadBuffer>());
+        local = r.threads.back().get();
+        local->tid = r.nextTid++;
+        local->name = "thread " + std::to_string(local->tid);
+        local->events.reserve(1024);
+    }
+    return *local;
+}
+
+void push(const Event& e) {
+    ThreadBuffer& b = buffer();
+    std::lock_guard<std::mutex> guard(b.lock);
+    b.events.push_back(e);
+}
+
+// Noms d'opérations : littéraux sans caractère à échapper, mais noms de threads libres
+std::string escape(const std::string& s) {
+    std::string out;
+    for (char c : s) {
+        if (c == '"' || c == '\\') out += '\\';
+        if (static_cast<unsigned char>(c) >= 0x20) out += c;
+    }
+    return out;
+}
+
+// IMAGE_TRACE=fichier.json : trace de tout le programme
+struct AutoTrace {
+    AutoTrace() {
+        registry();  // construit avant nous, donc détruit après
+        if (const char* path = std::getenv("IMAGE_TRACE")) {
+            if (*path && start(path)) setThreadName("main");
+        }
+    }
+    ~AutoTrace() {
+        if (enabled()) stop();
+    }
+} autoTrace;
+
+} // namespace
+
+bool start(const char* filename) {
+    Registry& r = registry();
+    std::lock_guard<std::mutex> guard(r.lock);
+    if (enabled()) return false;
+    for (auto& t : r.threads) {
+        std::lock_guard<std::mutex> g(t->lock);
+        t->events.clear();
+    }
+    r.filename = filename;
+    r.origin = now();
+    recording.store(true, std::memory_order_release);
+    return true;
+}
+
+bool stop() {
+    Registry& r = registry();
+    std::lock_guard<std::mutex> guard(r.lock);
+    if (!enabled()) return false;
+    recording.store(false, std::memory_order_release);
+
+    std::FILE* f = std::fopen(r.filename.c_str(), "w");
+    if (!f) return false;
+    std::fprintf(f, "{\"displayTimeUnit\": \"ms\", \"traceEvents\": [\n");
+    bool first = true;
+    for (auto& t : r.threads) {
+        std::lock_guard<std::mutex> g(t->lock);
+        std::fprintf(f, "%s{\"name\": \"thread_name\", \"ph\": \"M\", \"pid\": 1, \"tid\": %u, "
+                        "\"args\": {\"name\": \"%s\"}}",
+                     first ? "" : ",\n", t->tid, escape(t->name).c_str());
+        first = false;
+        for (const Event& e : t->events) {
+            const double ts = e.ns >= r.origin ? (e.ns - r.origin) / 1e3 : 0.0;  // µs
+            std::fprintf(f, ",\n{\"name\": \"%s\", \"cat\": \"image\", \"ph\": \"%c\", \"ts\": %.3f, "
+                            "\"pid\": 1, \"tid\": %u",
+                         e.name, e.phase, ts, t->tid);
+            // Dimensions inconnues au début d'un load : le visualiseur fusionne les args de B et E
+            if (e.width > 0)
+                std::fprintf(f, ", \"args\": {\"width\": %d, \"height\": %d, \"channels\": %d}",
+                             e.width, e.height, e.channels);
+            std::fputc('}', f);
+        }
+        t->events.clear();
+    }
+    std::fprintf(f, "\n]}\n");
+    return std::fclose(f) == 0;
+}
+
+void setThreadName(const char* name) {
+    ThreadBuffer& b = buffer();
+    std::lock_guard<std::mutex> guard(b.lock);
+    b.name = name;
+}
+
+void Scope::begin(const char* n, int w, int h, int c) {
+    if (current == n) return;
+    name = n;
+    parent = current;
+    current = n;
+    width = w;
+    height = h;
+    channels = c;
+    push({name, now(), width, height, channels, 'B'});
+}
+
+void Scope::end() {
+    push({name, now(), width, height, channels, 'E'});
+    current = parent;
+}
+
+} // namespace trace
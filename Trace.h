@@ -0,0 +1,60 @@
+#ifndef TRACE_H
+#define TRACE_H
+
+#include <atomic>
+#include <cstdint>
+
+// Trace d'exécution au format Chrome trace (chrome://tracing, ui.perfetto.dev) :
+// un événement de début et un de fin par opération, avec le thread et les
+// dimensions de l'image. Activée à l'exécution :
+//   - IMAGE_TRACE=trace.json dans l'environnement (écrit à la fin du programme)
+//   - ou trace::start("trace.json") ... trace::stop()
+// Inactive, une portée ne coûte qu'une lecture atomique.
+namespace trace {
+
+extern std::atomic<bool> recording;
+
+inline bool enabled() { return recording.load(std::memory_order_relaxed); }
+
+// Démarre l'enregistrement (efface les événements précédents) ; false si déjà actif
+bool start(const char* filename);
+// Arrête l'enregistrement et écrit le fichier ; false si inactif ou en cas d'erreur
+bool stop();
+
+// Nom affiché pour le thread appelant (métadonnée thread_name)
+void setThreadName(const char* name);
+
+// Portée d'une opération. `name` doit être une chaîne statique (littéral).
+// Une portée imbriquée directement dans une portée de même nom est ignorée
+// (operator+ qui appelle operator+=).
+class Scope {
+public:
+    Scope(const char* name, int width, int height, int channels) {
+        if (enabled()) begin(name, width, height, channels);
+    }
+    ~Scope() {
+        if (name) end();
+    }
+    Scope(const Scope&) = delete;
+    Scope& operator=(const Scope&) = delete;
+
+    // Dimensions connues seulement en cours d'opération (load)
+    void setSize(int w, int h, int c) { width = w; height = h; channels = c; }
+
+private:
+    const char* name = nullptr;
+    const char* parent = nullptr;
+    int width = 0;
+    int height = 0;
+    int channels = 0;
+
+    void begin(const char* n, int w, int h, int c);
+    void end();
+};
+
+} // namespace trace
+
+#define IMAGE_TRACE_SCOPE(name, w, h, c) trace::Scope traceScope_(name, (w), (h), (c))
+#define IMAGE_TRACE_SIZE(w, h, c) traceScope_.setSize((w), (h), (c))
+
+#endif
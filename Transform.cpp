@@ -0,0 +1,93 @@
+#include "Transform.h"
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include <utility>
+
+Transform::Transform() : m{1, 0, 0, 0, 1, 0, 0, 0, 1} {}
+
+Transform::Transform(const std::array<double, 9>& coefficients) : m(coefficients) {
+    for (double v : m)
+        if (!std::isfinite(v)) throw std::invalid_argument("Transform: non-finite coefficient");
+}
+
+Transform Transform::affine(double a, double b, double c, double d, double e, double f) {
+    return Transform({a, b, c, d, e, f, 0, 0, 1});
+}
+
+Transform Transform::translation(double tx, double ty) { return affine(1, 0, tx, 0, 1, ty); }
+
+Transform Transform::scaling(double sx, double sy) { return affine(sx, 0, 0, 0, sy, 0); }
+
+Transform Transform::rotation(double angle, double cx, double cy) {
+    const double c = std::cos(angle), s = std::sin(angle);
+    // Translation du centre à l'origine, rotation, retour
+    return affine(c, -s, cx - c * cx + s * cy, s, c, cy - s * cx - c * cy);
+}
+
+Transform Transform::perspective(const std::array<Point, 4>& from, const std::array<Point, 4>& to) {
+    // h (8 inconnues, h8 = 1) : X (h6 x + h7 y + 1) = h0 x + h1 y + h2, idem Y ;
+    // élimination de Gauss avec pivot partiel
+    double a[8][9];
+    double scale = 0;
+    for (int i = 0; i < 4; ++i) {
+        const double x = from[i].x, y = from[i].y, X = to[i].x, Y = to[i].y;
+        const double rx[9] = {x, y, 1, 0, 0, 0, -x * X, -y * X, X};
+        const double ry[9] = {0, 0, 0, x, y, 1, -x * Y, -y * Y, Y};
+        std::copy(rx, rx + 9, a[2 * i]);
+        std::copy(ry, ry + 9, a[2 * i + 1]);
+        for (int k = 0; k < 8; ++k) scale = std::max({scale, std::fabs(rx[k]), std::fabs(ry[k])});
+    }
+    for (int col = 0; col < 8; ++col) {
+        int pivot = col;
+        for (int r = col + 1; r < 8; ++r)
+            if (std::fabs(a[r][col]) > std::fabs(a[pivot][col])) pivot = r;
+        if (!(std::fabs(a[pivot][col]) > 1e-12 * scale))
+            throw std::invalid_argument("Transform::perspective: degenerate quadrilateral");
+        std::swap(a[pivot], a[col]);
+        for (int r = 0; r < 8; ++r) {
+            if (r == col) continue;
+            const double f = a[r][col] / a[col][col];
+            for (int k = col; k < 9; ++k) a[r][k] -= f * a[col][k];
+        }
+    }
+    std::array<double, 9> h;
+    for (int k = 0; k < 8; ++k) h[k] = a[k][8] / a[k][k];
+    h[8] = 1;
+    return Transform(h);
+}
+
+Transform Transform::operator*(const Transform& other) const {
+    std::array<double, 9> r{};
+    for (int i = 0; i < 3; ++i)
+        for (int j = 0; j < 3; ++j)
+            for (int k = 0; k < 3; ++k) r[3 * i + j] += m[3 * i + k] * other.m[3 * k + j];
+    return Transform(r);
+}
+
+Transform Transform::inverse() const {
+    // Comatrice transposée / déterminant
+    const std::array<double, 9> c = {
+        m[4] * m[8] - m[5] * m[7], m[2] * m[7] - m[1] * m[8], m[1] * m[5] - m[2] * m[4],
+        m[5] * m[6] - m[3] * m[8], m[0] * m[8] - m[2] * m[6], m[2] * m[3] - m[0] * m[5],
+        m[3] * m[7] - m[4] * m[6], m[1] * m[6] - m[0] * m[7], m[0] * m[4] - m[1] * m[3]};
+    const double det = m[0] * c[0] + m[1] * c[3] + m[2] * c[6];
+    double norm = 0;
+    for (double v : m) norm = std::max(norm, std::fabs(v));
+    if (!(std::fabs(det) > 1e-14 * norm * norm * norm)) throw std::invalid_argument("Transform: not invertible");
+    std::array<double, 9> r;
+    for (int i = 0; i < 9; ++i) r[i] = c[i] / det;
+    if (isAffine()) r[6] = r[7] = 0, r[8] = 1;
+    return Transform(r);
+}
+
+bool Transform::isAffine() const { return m[6] == 0 && m[7] == 0 && m[8] == 1; }
+
+Transform::Point Transform::apply(Point p) const {
+    const double w = m[6] * p.x + m[7] * p.y + m[8];
+    return {(m[0] * p.x + m[1] * p.y + m[2]) / w, (m[3] * p.x + m[4] * p.y + m[5]) / w};
+}
+
+double Transform::operator()(int row, int col) const { return m[3 * row + col]; }
+
+const std::array<double, 9>& Transform::coefficients() const { return m; }
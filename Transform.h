@@ -0,0 +1,43 @@
+#ifndef TRANSFORM_H
+#define TRANSFORM_H
+
+#include <array>
+
+// Transformation plane en coordonnées homogènes : (x', y', w') = M · (x, y, 1),
+// point image (x' / w', y' / w'). Affine si la dernière ligne vaut (0, 0, 1).
+// Repère image : x vers la droite, y vers le bas, pixel (i, j) centré en (i, j).
+class Transform {
+private:
+    std::array<double, 9> m;  // ligne par ligne
+
+public:
+    struct Point {
+        double x;
+        double y;
+    };
+
+    Transform();  // identité
+    explicit Transform(const std::array<double, 9>& coefficients);
+
+    // x' = a x + b y + c, y' = d x + e y + f
+    static Transform affine(double a, double b, double c, double d, double e, double f);
+    static Transform translation(double tx, double ty);
+    static Transform scaling(double sx, double sy);
+    // Angle en radians, sens horaire à l'écran (y vers le bas), autour de (cx, cy)
+    static Transform rotation(double angle, double cx = 0, double cy = 0);
+    // Homographie envoyant from[i] sur to[i] ; std::invalid_argument si trois
+    // points d'un même quadrilatère sont alignés
+    static Transform perspective(const std::array<Point, 4>& from, const std::array<Point, 4>& to);
+
+    // Composition : (a * b)(p) = a(b(p))
+    Transform operator*(const Transform& other) const;
+    // std::invalid_argument si la matrice n'est pas inversible
+    Transform inverse() const;
+
+    bool isAffine() const;
+    Point apply(Point p) const;
+    double operator()(int row, int col) const;
+    const std::array<double, 9>& coefficients() const;
+};
+
+#endif
@@ -0,0 +1,291 @@
+#include "ImageKernels.h"
+#include "Parallel.h"
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+namespace kernels {
+
+namespace {
+
+constexpr int fracBits = 8, fracOne = 1 << fracBits;  // positions en 1/256 de pixel
+constexpr int cubicBits = 11;                          // poids bicubiques Q11
+constexpr int64_t farAway = int64_t(1) << 40;          // position d'un point hors champ
+
+// Poids de Keys (a = -0.5) des pixels -1, 0, 1, 2 pour chaque fraction, de
+// somme exacte 2^11 (écart d'arrondi reporté sur le plus grand)
+struct CubicTable {
+    int16_t w[fracOne][4];
+};
+
+const CubicTable cubicTable = [] {
+    CubicTable t{};
+    auto keys = [](double x) {
+        const double a = -0.5;
+        x = std::fabs(x);
+        if (x < 1) return ((a + 2) * x - (a + 3)) * x * x + 1;
+        if (x < 2) return ((a * x - 5 * a) * x + 8 * a) * x - 4 * a;
+        return 0.0;
+    };
+    for (int f = 0; f < fracOne; ++f) {
+        const double d = static_cast<double>(f) / fracOne;
+        int sum = 0, largest = 0;
+        for (int k = 0; k < 4; ++k) {
+            t.w[f][k] = static_cast<int16_t>(std::lround(keys(d - (k - 1)) * (1 << cubicBits)));
+            sum += t.w[f][k];
+            if (t.w[f][k] > t.w[f][largest]) largest = k;
+        }
+        t.w[f][largest] = static_cast<int16_t>(t.w[f][largest] + (1 << cubicBits) - sum);
+    }
+    return t;
+}();
+
+// === POSITIONS ===
+struct Position {
+    int64_t x, y;  // 1/256 de pixel
+};
+
+inline int64_t toFixed(double v) {
+    return v < -farAway ? -farAway : v > farAway ? farAway : static_cast<int64_t>(std::floor(v));
+}
+
+// Numérateurs exacts -> position ; X / W en double (exact jusqu'à 2^53)
+template <bool Affine>
+inline Position position(const WarpMap& m, int64_t X, int64_t Y, int64_t W) {
+    if constexpr (Affine) return {X >> (m.shift[0] - fracBits), Y >> (m.shift[1] - fracBits)};
+    if (W <= 0) return {-farAway, -farAway};
+    const double w = static_cast<double>(W);
+    return {toFixed(static_cast<double>(X) / w * m.scale[0]), toFixed(static_cast<double>(Y) / w * m.scale[1])};
+}
+
+// Indice d'un pixel lu, -1 hors de l'image avec Border::Zero. Miroir par
+// période 2 (n - 1) : les positions lointaines ne bouclent pas.
+inline int tapIndex(int64_t i, int n, Border border) {
+    if (i >= 0 && i < n) return static_cast<int>(i);
+    switch (border) {
+        case Border::Zero:      return -1;
+        case Border::Replicate: return i < 0 ? 0 : n - 1;
+        default: {
+            if (n == 1) return 0;
+            const int64_t period = 2 * static_cast<int64_t>(n - 1);
+            const int64_t r = (i % period + period) % period;
+            return static_cast<int>(r < n ? r : period - r);
+        }
+    }
+}
+
+// === ÉCHANTILLONNAGE ===
+// Premier pixel lu, poids entiers et décalage final d'une interpolation
+template <Interpolation I>
+struct Taps {
+    static constexpr int count = I == Interpolation::Nearest ? 1 : I == Interpolation::Bilinear ? 2 : 4;
+    static constexpr int bits = I == Interpolation::Nearest ? 0 : I == Interpolation::Bilinear ? 2 * fracBits
+                                                                                                : 2 * cubicBits;
+    int64_t x0, y0;
+    int wx[count], wy[count];
+
+    explicit Taps(Position p) {
+        if constexpr (I == Interpolation::Nearest) {
+            x0 = (p.x + fracOne / 2) >> fracBits;
+            y0 = (p.y + fracOne / 2) >> fracBits;
+            wx[0] = wy[0] = 1;
+        } else if constexpr (I == Interpolation::Bilinear) {
+            x0 = p.x >> fracBits, y0 = p.y >> fracBits;
+            const int fx = static_cast<int>(p.x & (fracOne - 1)), fy = static_cast<int>(p.y & (fracOne - 1));
+            wx[0] = fracOne - fx, wx[1] = fx;
+            wy[0] = fracOne - fy, wy[1] = fy;
+        } else {
+            x0 = (p.x >> fracBits) - 1, y0 = (p.y >> fracBits) - 1;
+            const int16_t* cx = cubicTable.w[p.x & (fracOne - 1)];
+            const int16_t* cy = cubicTable.w[p.y & (fracOne - 1)];
+            for (int k = 0; k < 4; ++k) wx[k] = cx[k], wy[k] = cy[k];
+        }
+    }
+
+    static uint8_t finish(int sum) {
+        if constexpr (bits == 0) {
+            return static_cast<uint8_t>(sum);
+        } else {
+            const int v = (sum + (1 << (bits - 1))) >> bits;
+            return static_cast<uint8_t>(std::min(255, std::max(0, v)));
+        }
+    }
+};
+
+// Pixels lus hors de l'image : indices par tapIndex, 0 pour Border::Zero
+template <Interpolation I>
+void sampleBorder(const ConstSurface& s, const Taps<I>& t, Border border, uint8_t* out) {
+    constexpr int T = Taps<I>::count;
+    int ix[T], iy[T];
+    for (int k = 0; k < T; ++k) {
+        ix[k] = tapIndex(t.x0 + k, s.width, border);
+        iy[k] = tapIndex(t.y0 + k, s.height, border);
+    }
+    const int ch = s.channels;
+    for (int c = 0; c < ch; ++c) {
+        int sum = 0;
+        for (int j = 0; j < T; ++j) {
+            if (iy[j] < 0) continue;
+            const uint8_t* row = s.row(iy[j]);
+            int h = 0;
+            for (int i = 0; i < T; ++i)
+                if (ix[i] >= 0) h += t.wx[i] * row[static_cast<size_t>(ix[i]) * ch + c];
+            sum += t.wy[j] * h;
+        }
+        out[c] = Taps<I>::finish(sum);
+    }
+}
+
+// Tous les pixels lus dans l'image : accès direct
+template <int C, Interpolation I>
+inline void sampleInside(const ConstSurface& s, const Taps<I>& t, uint8_t* out) {
+    constexpr int T = Taps<I>::count;
+    const size_t ch = C ? C : s.channels;
+    const uint8_t* base = s.row(static_cast<int>(t.y0)) + static_cast<size_t>(t.x0) * ch;
+    if constexpr (I == Interpolation::Nearest) {
+        for (size_t c = 0; c < ch; ++c) out[c] = base[c];
+    } else {
+        for (size_t c = 0; c < ch; ++c) {
+            int sum = 0;
+            const uint8_t* row = base + c;
+            for (int j = 0; j < T; ++j, row += s.stride) {
+                int h = 0;
+                for (int i = 0; i < T; ++i) h += t.wx[i] * row[i * ch];
+                sum += t.wy[j] * h;
+            }
+            out[c] = Taps<I>::finish(sum);
+        }
+    }
+}
+
+// Pixels lus à au moins margin pixels des bords
+template <Interpolation I>
+inline bool inside(const ConstSurface& s, const Taps<I>& t, int margin) {
+    constexpr int T = Taps<I>::count;
+    return t.x0 >= margin && t.y0 >= margin && t.x0 <= s.width - T - margin && t.y0 <= s.height - T - margin;
+}
+
+// === TUILES ===
+// Segment de n pixels d'une ligne de dst, numérateurs du premier pixel en
+// entrée. Positions monotones le long du segment (exactement en affine, à
+// l'arrondi près en perspective avec W > 0) : si les deux extrémités lisent
+// dans l'image, avec une marge d'un pixel en perspective, tout le segment aussi.
+template <int C, Interpolation I, bool Affine>
+void warpSpan(const ConstSurface& s, const WarpMap& m, Border border, int64_t X, int64_t Y, int64_t W, int n,
+              uint8_t* out) {
+    const size_t ch = C ? C : s.channels;
+    const int64_t dX = m.q[0][0], dY = m.q[1][0], dW = m.q[2][0];
+    const int64_t lastW = W + dW * (n - 1);
+    const int margin = Affine ? 0 : 1;
+    if ((Affine || (W > 0 && lastW > 0)) && inside(s, Taps<I>(position<Affine>(m, X, Y, W)), margin) &&
+        inside(s, Taps<I>(position<Affine>(m, X + dX * (n - 1), Y + dY * (n - 1), lastW)), margin)) {
+        for (int x = 0; x < n; ++x, out += ch, X += dX, Y += dY, W += dW)
+            sampleInside<C, I>(s, Taps<I>(position<Affine>(m, X, Y, W)), out);
+        return;
+    }
+    for (int x = 0; x < n; ++x, out += ch, X += dX, Y += dY, W += dW) {
+        const Taps<I> t(position<Affine>(m, X, Y, W));
+        if (inside(s, t, 0)) sampleInside<C, I>(s, t, out);
+        else sampleBorder(s, t, border, out);
+    }
+}
+
+// Tuiles de 64 x 32 pixels de dst : la zone source lue par une tuile reste en
+// cache même quand une ligne de dst traverse l'image source en diagonale
+template <int C, Interpolation I, bool Affine>
+void warpTiles(const ConstSurface& src, const Surface& dst, const WarpMap& map, Border border) {
+    constexpr int TW = 64, TH = 32;
+    const size_t ch = C ? C : src.channels;
+    const size_t bands = (dst.height + TH - 1) / TH;
+    parallel::forRange(0, bands, 1, [&](size_t first, size_t last) {
+        // Copies locales : les écritures uint8_t de dst ne forcent pas à les relire
+        const ConstSurface s = src;
+        const WarpMap m = map;
+        for (size_t band = first; band < last; ++band) {
+            const int y0 = static_cast<int>(band) * TH, y1 = std::min(dst.height, y0 + TH);
+            for (int x0 = 0; x0 < dst.width; x0 += TW) {
+                const int n = std::min(dst.width - x0, TW);
+                // Numérateurs au début de chaque ligne de tuile, puis un incrément par pixel
+                for (int y = y0; y < y1; ++y)
+                    warpSpan<C, I, Affine>(s, m, border, m.q[0][0] * x0 + m.q[0][1] * y + m.q[0][2],
+                                           m.q[1][0] * x0 + m.q[1][1] * y + m.q[1][2],
+                                           m.q[2][0] * x0 + m.q[2][1] * y + m.q[2][2], n, dst.row(y) + x0 * ch);
+            }
+        }
+    });
+}
+
+template <Interpolation I, bool Affine>
+void warpChannels(const ConstSurface& src, const Surface& dst, const WarpMap& m, Border border) {
+    switch (src.channels) {
+        case 1: warpTiles<1, I, Affine>(src, dst, m, border); break;
+        case 2: warpTiles<2, I, Affine>(src, dst, m, border); break;
+        case 3: warpTiles<3, I, Affine>(src, dst, m, border); break;
+        case 4: warpTiles<4, I, Affine>(src, dst, m, border); break;
+        default: warpTiles<0, I, Affine>(src, dst, m, border); break;
+    }
+}
+
+template <Interpolation I>
+void warpDispatch(const ConstSurface& src, const Surface& dst, const WarpMap& m, Border border) {
+    if (m.affine) warpChannels<I, true>(src, dst, m, border);
+    else warpChannels<I, false>(src, dst, m, border);
+}
+
+template <Interpolation I>
+void warpReference(const ConstSurface& src, const Surface& dst, const WarpMap& m, Border border) {
+    for (int y = 0; y < dst.height; ++y)
+        for (int x = 0; x < dst.width; ++x) {
+            const int64_t X = m.q[0][0] * x + m.q[0][1] * y + m.q[0][2];
+            const int64_t Y = m.q[1][0] * x + m.q[1][1] * y + m.q[1][2];
+            const int64_t W = m.q[2][0] * x + m.q[2][1] * y + m.q[2][2];
+            const Position p = m.affine ? position<true>(m, X, Y, W) : position<false>(m, X, Y, W);
+            sampleBorder(src, Taps<I>(p), border, dst.row(y) + static_cast<size_t>(x) * dst.channels);
+        }
+}
+
+} // namespace
+
+WarpMap warpMap(const double* inverse, int dstWidth, int dstHeight) {
+    double a[9];
+    std::copy(inverse, inverse + 9, a);
+    // Coordonnées homogènes définies au signe près : W > 0 au centre de la sortie
+    if (a[6] * (dstWidth - 1) / 2 + a[7] * (dstHeight - 1) / 2 + a[8] < 0)
+        for (double& v : a) v = -v;
+
+    WarpMap m{};
+    m.affine = a[6] == 0 && a[7] == 0 && a[8] == 1;
+    for (int r = 0; r < 3; ++r) {
+        const double* row = a + 3 * r;
+        // |numérateur| <= bound * 2^shift + arrondis < 2^51 sur toute la sortie
+        const double bound = std::fabs(row[0]) * (dstWidth - 1) + std::fabs(row[1]) * (dstHeight - 1) +
+                             std::fabs(row[2]) + 1;
+        if (!std::isfinite(bound)) throw std::invalid_argument("warp: non-finite transform");
+        int e;
+        std::frexp(bound, &e);
+        m.shift[r] = 50 - e;
+        if (m.shift[r] < fracBits) throw std::invalid_argument("warp: coordinates out of range");
+        for (int c = 0; c < 3; ++c) m.q[r][c] = std::llround(std::ldexp(row[c], m.shift[r]));
+    }
+    if (!m.affine)
+        for (int r = 0; r < 2; ++r) m.scale[r] = std::ldexp(1.0, m.shift[2] - m.shift[r] + fracBits);
+    return m;
+}
+
+void warp(const ConstSurface& src, const Surface& dst, const WarpMap& map, Interpolation interp, Border border) {
+    switch (interp) {
+        case Interpolation::Nearest:  warpDispatch<Interpolation::Nearest>(src, dst, map, border); break;
+        case Interpolation::Bilinear: warpDispatch<Interpolation::Bilinear>(src, dst, map, border); break;
+        case Interpolation::Bicubic:  warpDispatch<Interpolation::Bicubic>(src, dst, map, border); break;
+    }
+}
+
+void warpScalar(const ConstSurface& src, const Surface& dst, const WarpMap& map, Interpolation interp, Border border) {
+    switch (interp) {
+        case Interpolation::Nearest:  warpReference<Interpolation::Nearest>(src, dst, map, border); break;
+        case Interpolation::Bilinear: warpReference<Interpolation::Bilinear>(src, dst, map, border); break;
+        case Interpolation::Bicubic:  warpReference<Interpolation::Bicubic>(src, dst, map, border); break;
+    }
+}
+
+} // namespace kernels
@@ -0,0 +1,8 @@
+// Implémentation de stb_image / stb_image_write dans sa propre unité de
+// compilation : Image.cpp n'inclut plus que les déclarations, et modifier
+// le code de Image ne recompile plus les décodeurs PNG/JPEG.
+#define STB_IMAGE_IMPLEMENTATION
+#include "stb_image.h"
+
+#define STB_IMAGE_WRITE_IMPLEMENTATION
+#include "stb_image_write.h"
@@ -0,0 +1,130 @@
+#include "PerfCounters.h"
+#include <cerrno>
+#include <cstring>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+const char* PerfCounters::name(Event e) {
+    switch (e) {
+        case Cycles:       return "cycles";
+        case Instructions: return "instructions";
+        case CacheMisses:  return "cache_misses";
+        case BranchMisses: return "branch_misses";
+        default:           return "unknown";
+    }
+}
+
+double PerfCounters::Sample::ipc() const {
+    if (!valid[Cycles] || !valid[Instructions] || value[Cycles] == 0) return 0.0;
+    return static_cast<double>(value[Instructions]) / value[Cycles];
+}
+
+double PerfCounters::Sample::bytesPerCycle(double bytes) const {
+    if (!valid[Cycles] || value[Cycles] == 0) return 0.0;
+    return bytes / value[Cycles];
+}
+
+PerfCounters::~PerfCounters() { close(); }
+
+void PerfCounters::close() {
+#ifdef __linux__
+    for (int& fd : fds) {
+        if (fd >= 0) ::close(fd);
+        fd = -1;
+    }
+#endif
+}
+
+#ifdef __linux__
+
+namespace {
+
+const uint64_t CONFIGS[PerfCounters::EventCount] = {
+    PERF_COUNT_HW_CPU_CYCLES,
+    PERF_COUNT_HW_INSTRUCTIONS,
+    PERF_COUNT_HW_CACHE_MISSES,     // dernier niveau de cache en général
+    PERF_COUNT_HW_BRANCH_MISSES,
+};
+
+int openEvent(uint64_t config, int groupFd) {
+    perf_event_attr attr;
+    std::memset(&attr, 0, sizeof(attr));
+    attr.size = sizeof(attr);
+    attr.type = PERF_TYPE_HARDWARE;
+    attr.config = config;
+    attr.disabled = groupFd < 0;  // le leader pilote le groupe
+    attr.exclude_kernel = 1;      // accessible avec perf_event_paranoid <= 2
+    attr.exclude_hv = 1;
+    attr.read_format = PERF_FORMAT_GROUP | PERF_FORMAT_ID | PERF_FORMAT_TOTAL_TIME_ENABLED |
+                       PERF_FORMAT_TOTAL_TIME_RUNNING;
+    return static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, groupFd, 0));
+}
+
+} // namespace
+
+bool PerfCounters::open() {
+    close();
+    for (int e = 0; e < EventCount; ++e) {
+        int fd = openEvent(CONFIGS[e], fds[Cycles]);
+        if (fd < 0) {
+            if (e == Cycles) {
+                const int err = errno;
+                lastError = std::string("perf_event_open: ") + std::strerror(err);
+                if (err == EACCES || err == EPERM) lastError += " (voir /proc/sys/kernel/perf_event_paranoid)";
+                else if (err == ENOENT || err == EOPNOTSUPP) lastError += " (pas de PMU exposée : VM ou conteneur ?)";
+                return false;
+            }
+            continue;  // compteur absent sur ce CPU : les autres restent utilisables
+        }
+        fds[e] = fd;
+        ioctl(fd, PERF_EVENT_IOC_ID, &ids[e]);
+    }
+    return true;
+}
+
+void PerfCounters::start() {
+    if (!isOpen()) return;
+    ioctl(fds[Cycles], PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+    ioctl(fds[Cycles], PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+}
+
+PerfCounters::Sample PerfCounters::stop() {
+    Sample s;
+    if (!isOpen()) return s;
+    ioctl(fds[Cycles], PERF_EVENT_IOC_DISABLE, PERF_IOC_FLAG_GROUP);
+
+    // nr, time_enabled, time_running, puis (valeur, id) par compteur
+    uint64_t buf[3 + 2 * EventCount] = {};
+    if (read(fds[Cycles], buf, sizeof(buf)) < static_cast<ssize_t>(3 * sizeof(uint64_t))) return s;
+    const uint64_t nr = buf[0], enabled = buf[1], running = buf[2];
+    if (running == 0) return s;  // groupe jamais ordonnancé sur la PMU
+    const double scale = static_cast<double>(enabled) / running;
+    for (uint64_t i = 0; i < nr && i < EventCount; ++i) {
+        const uint64_t value = buf[3 + 2 * i], id = buf[4 + 2 * i];
+        for (int e = 0; e < EventCount; ++e) {
+            if (fds[e] >= 0 && ids[e] == id) {
+                s.value[e] = static_cast<uint64_t>(value * scale);
+                s.valid[e] = true;
+            }
+        }
+    }
+    return s;
+}
+
+#else
+
+bool PerfCounters::open() {
+    lastError = "perf_event_open n'existe que sous Linux";
+    return false;
+}
+
+void PerfCounters::start() {}
+
+PerfCounters::Sample PerfCounters::stop() { return Sample(); }
+
+#endif
@@ -0,0 +1,50 @@
+#ifndef PERF_COUNTERS_H
+#define PERF_COUNTERS_H
+
+#include <cstdint>
+#include <string>
+
+// Compteurs matériels Linux (perf_event_open) pour bench_image : cycles,
+// instructions, défauts de cache et mauvaises prédictions de branchement,
+// en espace utilisateur pour le thread courant. Ouverts en un seul groupe
+// (lus ensemble, sans dérive entre compteurs) ; valeurs extrapolées si le
+// noyau multiplexe les compteurs.
+//
+// Sur les systèmes qui les refusent (autre OS, perf_event_paranoid, conteneur,
+// VM sans PMU virtualisée), open() renvoie false et error() explique pourquoi.
+class PerfCounters {
+public:
+    enum Event { Cycles, Instructions, CacheMisses, BranchMisses, EventCount };
+
+    struct Sample {
+        uint64_t value[EventCount] = {};
+        bool valid[EventCount] = {};  // compteur ouvert et effectivement compté
+
+        double ipc() const;
+        double bytesPerCycle(double bytes) const;
+    };
+
+    PerfCounters() = default;
+    ~PerfCounters();
+    PerfCounters(const PerfCounters&) = delete;
+    PerfCounters& operator=(const PerfCounters&) = delete;
+
+    // Ouvre les compteurs disponibles ; false si même les cycles sont inaccessibles
+    bool open();
+    bool isOpen() const { return fds[Cycles] >= 0; }
+    const std::string& error() const { return lastError; }
+
+    void start();
+    Sample stop();
+
+    static const char* name(Event e);
+
+private:
+    int fds[EventCount] = {-1, -1, -1, -1};
+    uint64_t ids[EventCount] = {};
+    std::string lastError;
+
+    void close();
+};
+
+#endif
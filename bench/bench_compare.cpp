@@ -0,0 +1,324 @@
+// Comparaison de deux résultats de bench_image (--json) : écart des médianes
+// par cas, test de Mann-Whitney sur les échantillons répétés, et code de sortie
+// non nul en cas de régression significative au-delà d'un seuil.
+//
+//   bench_compare base.json new.json [--threshold 5] [--alpha 0.05]
+//   bench_compare --base run1.json --base run2.json --new run3.json ...
+//
+// Code de sortie : 0 = pas de régression, 1 = régression(s), 2 = erreur.
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <map>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace {
+
+// === LECTEUR JSON MINIMAL (sous-ensemble produit par bench_image) ===
+struct Json {
+    enum Type { Null, Bool, Number, String, Array, Object } type = Null;
+    bool boolean = false;
+    double number = 0;
+    std::string str;
+    std::vector<Json> items;
+    std::map<std::string, Json> fields;
+
+    const Json* get(const std::string& key) const {
+        auto it = fields.find(key);
+        return it == fields.end() ? nullptr : &it->second;
+    }
+};
+
+class Parser {
+public:
+    explicit Parser(const std::string& text) : s(text) {}
+
+    Json parse() {
+        Json v = value();
+        skip();
+        if (pos != s.size()) fail("trailing characters");
+        return v;
+    }
+
+private:
+    const std::string& s;
+    size_t pos = 0;
+
+    [[noreturn]] void fail(const char* what) const {
+        throw std::runtime_error(std::string("JSON: ") + what + " at offset " + std::to_string(pos));
+    }
+
+    void skip() { while (pos < s.size() && std::isspace(static_cast<unsigned char>(s[pos]))) ++pos; }
+
+    bool consume(char c) {
+        skip();
+        if (pos < s.size() && s[pos] == c) { ++pos; return true; }
+        return false;
+    }
+
+    void expect(char c) { if (!consume(c)) fail("unexpected character"); }
+
+    std::string string() {
+        expect('"');
+        std::string out;
+        while (pos < s.size() && s[pos] != '"') {
+            if (s[pos] == '\\' && pos + 1 < s.size()) ++pos;
+            out += s[pos++];
+        }
+        if (pos >= s.size()) fail("unterminated string");
+        ++pos;
+        return out;
+    }
+
+    Json value() {
+        skip();
+        if (pos >= s.size()) fail("unexpected end");
+        Json v;
+        char c = s[pos];
+        if (c == '{') {
+            ++pos;
+            v.type = Json::Object;
+            if (consume('}')) return v;
+            do {
+                skip();
+                std::string key = string();
+                expect(':');
+                v.fields[key] = value();
+            } while (consume(','));
+            expect('}');
+        } else if (c == '[') {
+            ++pos;
+            v.type = Json::Array;
+            if (consume(']')) return v;
+            do v.items.push_back(value()); while (consume(','));
+            expect(']');
+        } else if (c == '"') {
+            v.type = Json::String;
+            v.str = string();
+        } else if (s.compare(pos, 4, "true") == 0 || s.compare(pos, 5, "false") == 0) {
+            v.type = Json::Bool;
+            v.boolean = s[pos] == 't';
+            pos += v.boolean ? 4 : 5;
+        } else if (s.compare(pos, 4, "null") == 0) {
+            pos += 4;
+        } else {
+            size_t used = 0;
+            v.type = Json::Number;
+            try { v.number = std::stod(s.substr(pos, 32), &used); } catch (...) { fail("bad number"); }
+            pos += used;
+        }
+        return v;
+    }
+};
+
+// === STATISTIQUES ===
+double median(std::vector<double> v) {
+    if (v.empty()) return 0;
+    std::sort(v.begin(), v.end());
+    size_t n = v.size();
+    return n % 2 ? v[n / 2] : 0.5 * (v[n / 2 - 1] + v[n / 2]);
+}
+
+double mad(const std::vector<double>& v) {
+    double m = median(v);
+    std::vector<double> d;
+    for (double x : v) d.push_back(std::fabs(x - m));
+    return median(d);
+}
+
+// Test bilatéral de Mann-Whitney : p-valeur que a et b viennent de la même loi.
+// Exact (dénombrement) sans ex-aequo pour de petits effectifs, approximation
+// normale avec correction des ex-aequo sinon.
+double mannWhitney(const std::vector<double>& a, const std::vector<double>& b) {
+    const size_t m = a.size(), n = b.size();
+    if (m == 0 || n == 0) return 1.0;
+
+    std::vector<std::pair<double, int>> all;
+    for (double x : a) all.push_back({x, 0});
+    for (double x : b) all.push_back({x, 1});
+    std::sort(all.begin(), all.end());
+
+    double rankA = 0, tieTerm = 0;
+    bool ties = false;
+    for (size_t i = 0; i < all.size();) {
+        size_t j = i;
+        while (j < all.size() && all[j].first == all[i].first) ++j;
+        double rank = 0.5 * (i + 1 + j);  // rang moyen du groupe
+        for (size_t k = i; k < j; ++k) if (all[k].second == 0) rankA += rank;
+        double t = static_cast<double>(j - i);
+        if (j - i > 1) { ties = true; tieTerm += t * t * t - t; }
+        i = j;
+    }
+    const double u = rankA - m * (m + 1) / 2.0;
+    const double mean = m * n / 2.0;
+
+    if (!ties && m <= 20 && n <= 20) {
+        // f[i][j][k] : nombre d'arrangements de i + j valeurs donnant U = k ; récurrence sur le max
+        const size_t maxU = m * n;
+        std::vector<std::vector<std::vector<double>>> f(m + 1, std::vector<std::vector<double>>(n + 1));
+        for (size_t i = 0; i <= m; ++i)
+            for (size_t j = 0; j <= n; ++j) {
+                f[i][j].assign(i * j + 1, 0.0);
+                if (i == 0 || j == 0) { f[i][j][0] = 1; continue; }
+                for (size_t k = 0; k <= i * j; ++k) {
+                    double v = k < f[i][j - 1].size() ? f[i][j - 1][k] : 0;
+                    if (k >= j && k - j < f[i - 1][j].size()) v += f[i - 1][j][k - j];
+                    f[i][j][k] = v;
+                }
+            }
+        double total = 0, tail = 0;
+        const double lo = std::min(u, maxU - u);
+        for (size_t k = 0; k <= maxU; ++k) {
+            total += f[m][n][k];
+            if (k <= lo) tail += f[m][n][k];
+        }
+        return std::min(1.0, 2.0 * tail / total);
+    }
+
+    const double N = static_cast<double>(m + n);
+    const double var = m * n / 12.0 * ((N + 1) - tieTerm / (N * (N - 1)));
+    if (var <= 0) return 1.0;
+    const double z = (std::fabs(u - mean) - 0.5) / std::sqrt(var);
+    return std::erfc(std::max(0.0, z) / std::sqrt(2.0));
+}
+
+// Plus petite p-valeur bilatérale que le test exact peut donner : 2 / C(m+n, m)
+// (séparation complète). 3 contre 3 : 0.1, jamais sous alpha = 0.05
+double minPValue(size_t m, size_t n) {
+    double arrangements = 1;
+    for (size_t i = 1; i <= std::min(m, n); ++i) arrangements = arrangements * (m + n - std::min(m, n) + i) / i;
+    return std::min(1.0, 2.0 / arrangements);
+}
+
+// === COMPARAISON ===
+struct Series {
+    std::vector<double> samples;
+};
+
+using Runs = std::map<std::string, Series>;
+
+void load(const std::string& path, Runs& runs) {
+    std::ifstream in(path);
+    if (!in) throw std::runtime_error("Cannot read " + path);
+    std::stringstream ss;
+    ss << in.rdbuf();
+    const std::string text = ss.str();
+    Json root = Parser(text).parse();
+    const Json* list = root.get("benchmarks");
+    if (!list || list->type != Json::Array) throw std::runtime_error(path + ": no 'benchmarks' array");
+    for (const Json& b : list->items) {
+        const Json* name = b.get("name");
+        if (!name) continue;
+        Series& s = runs[name->str];
+        const Json* samples = b.get("samples_ns");
+        if (samples && !samples->items.empty()) {
+            for (const Json& x : samples->items) s.samples.push_back(x.number);
+        } else if (const Json* med = b.get("median_ns")) {
+            s.samples.push_back(med->number);
+        }
+    }
+}
+
+struct Options {
+    std::vector<std::string> base, contender;
+    double threshold = 5.0;  // %
+    double alpha = 0.05;
+    std::string filter;
+    bool failOnMissing = false;
+};
+
+void usage() {
+    std::printf(
+        "Usage : bench_compare BASE.json NEW.json [options]\n"
+        "  --base FICHIER      résultat de référence (répétable : échantillons cumulés)\n"
+        "  --new FICHIER       résultat à évaluer (répétable)\n"
+        "  --threshold P       ralentissement toléré en %% de la médiane (défaut : 5)\n"
+        "  --alpha A           seuil de significativité du test (défaut : 0.05)\n"
+        "  --filter TEXTE      ne compare que les cas dont le nom contient TEXTE\n"
+        "  --fail-on-missing   échoue si un cas de la référence a disparu\n");
+}
+
+Options parse(int argc, char** argv) {
+    Options opt;
+    std::vector<std::string> positional;
+    for (int i = 1; i < argc; ++i) {
+        std::string a = argv[i];
+        auto next = [&]() -> std::string {
+            if (i + 1 >= argc) throw std::invalid_argument("Missing value for " + a);
+            return argv[++i];
+        };
+        if (a == "--base") opt.base.push_back(next());
+        else if (a == "--new") opt.contender.push_back(next());
+        else if (a == "--threshold") opt.threshold = std::stod(next());
+        else if (a == "--alpha") opt.alpha = std::stod(next());
+        else if (a == "--filter") opt.filter = next();
+        else if (a == "--fail-on-missing") opt.failOnMissing = true;
+        else if (a == "--help" || a == "-h") { usage(); std::exit(0); }
+        else if (!a.empty() && a[0] == '-') throw std::invalid_argument("Unknown option: " + a);
+        else positional.push_back(a);
+    }
+    if (positional.size() == 2) {
+        opt.base.push_back(positional[0]);
+        opt.contender.push_back(positional[1]);
+    } else if (!positional.empty()) {
+        throw std::invalid_argument("Expected BASE.json NEW.json");
+    }
+    if (opt.base.empty() || opt.contender.empty()) throw std::invalid_argument("Need a base and a new result");
+    return opt;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    try {
+        Options opt = parse(argc, argv);
+        Runs base, contender;
+        for (const std::string& p : opt.base) load(p, base);
+        for (const std::string& p : opt.contender) load(p, contender);
+
+        int regressions = 0, improvements = 0, missing = 0, compared = 0;
+        std::printf("%-36s %12s %12s %9s %8s  %s\n", "benchmark", "base (us)", "new (us)", "delta", "p", "verdict");
+        for (const auto& entry : base) {
+            const std::string& name = entry.first;
+            if (!opt.filter.empty() && name.find(opt.filter) == std::string::npos) continue;
+            auto it = contender.find(name);
+            if (it == contender.end()) {
+                ++missing;
+                std::printf("%-36s %12s %12s %9s %8s  %s\n", name.c_str(), "", "", "", "", "MISSING");
+                continue;
+            }
+            const std::vector<double>& a = entry.second.samples;
+            const std::vector<double>& b = it->second.samples;
+            const double ma = median(a), mb = median(b);
+            const double delta = ma > 0 ? 100.0 * (mb - ma) / ma : 0.0;
+            double p = mannWhitney(a, b);
+            // Test de rangs seulement s'il peut conclure (p minimale sous alpha,
+            // 4 échantillons par côté à 0.05) ; sinon l'écart doit dépasser la dispersion (3 MAD)
+            const bool ranked = minPValue(a.size(), b.size()) < opt.alpha;
+            bool significant = ranked ? p < opt.alpha : std::fabs(mb - ma) > 3.0 * 1.4826 * (mad(a) + mad(b));
+            const char* verdict = "~";
+            if (significant && delta > opt.threshold) { verdict = "REGRESSION"; ++regressions; }
+            else if (significant && delta < -opt.threshold) { verdict = "faster"; ++improvements; }
+            ++compared;
+            std::printf("%-36s %12.3f %12.3f %+8.1f%% %8.4f  %s\n", name.c_str(), ma / 1e3, mb / 1e3, delta, p,
+                        verdict);
+        }
+        for (const auto& entry : contender)
+            if (!base.count(entry.first) && (opt.filter.empty() || entry.first.find(opt.filter) != std::string::npos))
+                std::printf("%-36s %12s %12s %9s %8s  %s\n", entry.first.c_str(), "", "", "", "", "NEW");
+
+        std::printf("\n%d compared, %d regression(s), %d faster, %d missing (threshold %.1f%%, alpha %.3g)\n",
+                    compared, regressions, improvements, missing, opt.threshold, opt.alpha);
+        if (regressions > 0 || (opt.failOnMissing && missing > 0)) return 1;
+    } catch (const std::exception& e) {
+        std::fprintf(stderr, "bench_compare: %s\n", e.what());
+        usage();
+        return 2;
+    }
+    return 0;
+}
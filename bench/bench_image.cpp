@@ -0,0 +1,452 @@
+// Micro-benchmarks des opérateurs de Image : débit en Mo/s et Mpixel/s
+// pour chaque opérateur, plusieurs tailles (64x64 à 8K) et nombres de canaux,
+// plus load/save PNG. Sortie texte et JSON (--json) lisible par bench_compare.
+// --perf ajoute les compteurs matériels (IPC, octets par cycle, défauts de
+// cache et de prédiction) pour distinguer noyaux limités par le calcul, la
+// mémoire ou les branchements. Les compteurs ne suivent que le thread appelant :
+// avec --perf, le pool de parallel::forRange est ramené à un seul thread.
+#include "../Image.h"
+#include "../Parallel.h"
+#include "PerfCounters.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+struct Size {
+    const char* name;
+    int width;
+    int height;
+};
+
+const Size ALL_SIZES[] = {
+    {"64", 64, 64},        {"256", 256, 256},     {"1K", 1024, 1024},
+    {"FHD", 1920, 1080},   {"4K", 3840, 2160},    {"8K", 7680, 4320},
+};
+
+struct Options {
+    std::vector<Size> sizes;
+    std::vector<int> channels = {1, 3, 4};
+    std::vector<Layout> layouts = {Layout::Interleaved};
+    std::string filter;
+    std::string jsonPath;
+    int repetitions = 5;
+    double minTime = 0.02;  // secondes par répétition
+    bool list = false;
+    bool perf = false;
+};
+
+// Données partagées par les cas d'une configuration (taille, canaux, layout)
+struct Fixture {
+    Image a, b, padded;
+    std::vector<uint8_t> pixel;
+    Mask m1, m2;
+    std::string pngPath;
+};
+
+struct Case {
+    const char* name;
+    std::function<bool(const Fixture&)> applies;
+    std::function<void(Fixture&)> run;
+};
+
+// Empêche le compilateur d'éliminer un résultat inutilisé
+volatile uint64_t g_sink = 0;
+void consume(const Image& img) { g_sink = g_sink + (img.getWidth() ? img.getData()[0] : 0); }
+void consume(const Mask& m) { g_sink = g_sink + m.getWidth() + (m.getHeight() ? m.row(0)[0] : 0); }
+void consume(const std::vector<Image>& levels) { for (const Image& img : levels) consume(img); }
+
+void fillRandom(Image& img, uint32_t seed) {
+    uint8_t* p = img.getData();
+    size_t n = static_cast<size_t>(img.getWidth()) * img.getHeight() * img.getChannels();
+    uint32_t s = seed ? seed : 1;
+    for (size_t i = 0; i < n; ++i) {
+        s ^= s << 13; s ^= s >> 17; s ^= s << 5;
+        p[i] = static_cast<uint8_t>(s >> 24);
+    }
+}
+
+bool any(const Fixture&) { return true; }
+bool color(const Fixture& f) { return f.a.getChannels() == 3 || f.a.getChannels() == 4; }  // RGB, RGBA
+bool savable(const Fixture& f) { return f.a.getChannels() <= 4; }
+bool alpha(const Fixture& f) { return f.a.getChannels() == 2 || f.a.getChannels() == 4; }
+
+std::vector<Case> makeCases() {
+    return {
+        {"add_image",      any, [](Fixture& f) { consume(f.a + f.b); }},
+        {"add_image_pad",  any, [](Fixture& f) { consume(f.a + f.padded); }},
+        {"sub_image",      any, [](Fixture& f) { consume(f.a - f.b); }},
+        {"diff_image",     any, [](Fixture& f) { consume(f.a ^ f.b); }},
+        {"add_scalar",     any, [](Fixture& f) { consume(f.a + 60); }},
+        {"sub_scalar",     any, [](Fixture& f) { consume(f.a - 40); }},
+        {"diff_scalar",    any, [](Fixture& f) { consume(f.a ^ 128); }},
+        {"add_pixel",      any, [](Fixture& f) { consume(f.a + f.pixel); }},
+        {"sub_pixel",      any, [](Fixture& f) { consume(f.a - f.pixel); }},
+        {"diff_pixel",     any, [](Fixture& f) { consume(f.a ^ f.pixel); }},
+        {"blend_operators", any, [](Fixture& f) { consume(f.a * 0.5 + f.b * 0.5); }},
+        {"add_weighted",   any, [](Fixture& f) { consume(Image::addWeighted(f.a, 0.5, f.b, 0.5)); }},
+        {"add_weighted_pad", any, [](Fixture& f) { consume(Image::addWeighted(f.a, 0.7, f.padded, 0.3, 8)); }},
+        {"linear_combination_4", any, [](Fixture& f) {
+             consume(Image::linearCombination({f.a, f.b, f.a, f.b}, {0.4, 0.3, 0.2, 0.1})); }},
+        {"mul_scalar",     any, [](Fixture& f) { consume(f.a * 1.5); }},
+        {"div_scalar",     any, [](Fixture& f) { consume(f.a / 1.5); }},
+        {"invert",         any, [](Fixture& f) { consume(~f.a); }},
+        // +1 et -1 en alternance : f.a ne sature pas au fil des itérations
+        {"add_inplace",    any, [up = true](Fixture& f) mutable {
+            if (up) f.a += 1;
+            else f.a -= 1;
+            up = !up;
+            consume(f.a);
+        }},
+        {"threshold_lt",   any, [](Fixture& f) { consume(f.a < 120); }},
+        {"threshold_le",   any, [](Fixture& f) { consume(f.a <= 120); }},
+        {"threshold_gt",   any, [](Fixture& f) { consume(f.a > 120); }},
+        {"threshold_ge",   any, [](Fixture& f) { consume(f.a >= 120); }},
+        {"threshold_eq",   any, [](Fixture& f) { consume(f.a == 120); }},
+        {"threshold_ne",   any, [](Fixture& f) { consume(f.a != 120); }},
+        {"mask_and",       any, [](Fixture& f) { consume(f.m1 & f.m2); }},
+        {"mask_or",        any, [](Fixture& f) { consume(f.m1 | f.m2); }},
+        {"mask_not",       any, [](Fixture& f) { consume(~f.m1); }},
+        {"mask_count",     any, [](Fixture& f) { g_sink = g_sink + f.m1.count(); }},
+        {"mask_to_image",  any, [](Fixture& f) { consume(f.m1.toImage()); }},
+        {"to_gray",        color, [](Fixture& f) { consume(f.a.convertTo(ColorModel::GRAY)); }},
+        {"to_yuv",         color, [](Fixture& f) { consume(f.a.convertTo(ColorModel::YUV)); }},
+        {"to_hsv",         color, [](Fixture& f) { consume(f.a.convertTo(ColorModel::HSV)); }},
+        {"to_other_layout", any, [](Fixture& f) {
+             consume(f.a.toLayout(f.a.getLayout() == Layout::Planar ? Layout::Interleaved : Layout::Planar)); }},
+        {"gaussian_5x5",   any, [](Fixture& f) { consume(f.a.convolve(Kernel::gaussian(1.0, 2))); }},
+        {"gaussian_s3",    any, [](Fixture& f) { consume(f.a.convolve(Kernel::gaussian(3.0))); }},
+        {"sharpen_3x3",    any, [](Fixture& f) { consume(f.a.convolve(Kernel::sharpen())); }},
+        {"box_blur_r2",    any, [](Fixture& f) { consume(f.a.boxBlur(2)); }},
+        {"box_blur_r50",   any, [](Fixture& f) { consume(f.a.boxBlur(50)); }},
+        {"gaussian_blur_s20", any, [](Fixture& f) { consume(f.a.gaussianBlur(20)); }},
+        {"median_3x3",     any, [](Fixture& f) { consume(f.a.median(1)); }},
+        {"median_5x5",     any, [](Fixture& f) { consume(f.a.median(2)); }},
+        {"median_r15",     any, [](Fixture& f) { consume(f.a.median(15)); }},
+        {"erode_3x3",      any, [](Fixture& f) { consume(f.a.erode(StructuringElement::square(1))); }},
+        {"dilate_31x31",   any, [](Fixture& f) { consume(f.a.dilate(StructuringElement::square(15))); }},
+        {"open_disk5",     any, [](Fixture& f) { consume(f.a.open(StructuringElement::disk(5))); }},
+        {"mask_open_5x5",  any, [](Fixture& f) { consume(f.m1.open(StructuringElement::square(2))); }},
+        {"mask_close_disk5", any, [](Fixture& f) { consume(f.m1.close(StructuringElement::disk(5))); }},
+        {"resize_half_bilinear", any, [](Fixture& f) {
+             consume(f.a.resize(f.a.getWidth() / 2, f.a.getHeight() / 2)); }},
+        {"resize_up_lanczos", any, [](Fixture& f) {
+             consume(f.a.resize(f.a.getWidth() * 3 / 2, f.a.getHeight() * 3 / 2, ResizeFilter::Lanczos3)); }},
+        {"thumbnail_area_1_8", any, [](Fixture& f) {
+             consume(f.a.resize(f.a.getWidth() / 8, f.a.getHeight() / 8, ResizeFilter::Area)); }},
+        {"thumbnail_area_256", any, [](Fixture& f) { consume(f.a.resize(256, 144, ResizeFilter::Area)); }},
+        {"rotate90", any, [](Fixture& f) { consume(f.a.rotate90()); }},
+        {"transpose", any, [](Fixture& f) { consume(f.a.transpose()); }},
+        {"rotate180", any, [](Fixture& f) { consume(f.a.rotate180()); }},
+        {"flip_horizontal", any, [](Fixture& f) { consume(f.a.flipHorizontal()); }},
+        {"flip_vertical_in_place", any, [](Fixture& f) { consume(f.a.orient(Orientation::FlipVertical)); }},
+        {"warp_rotate_bilinear", any, [](Fixture& f) {
+             const int w = f.a.getWidth(), h = f.a.getHeight();
+             consume(f.a.warp(Transform::rotation(0.05, (w - 1) / 2.0, (h - 1) / 2.0), w, h)); }},
+        {"warp_perspective_bicubic", any, [](Fixture& f) {
+             const double w = f.a.getWidth() - 1, h = f.a.getHeight() - 1;
+             const Transform t = Transform::perspective({{{0, 0}, {w, 0}, {w, h}, {0, h}}},
+                                                        {{{w * 0.05, h * 0.1}, {w * 0.9, 0}, {w, h}, {0, h * 0.95}}});
+             consume(f.a.warp(t, f.a.getWidth(), f.a.getHeight(), Interpolation::Bicubic)); }},
+        {"paste_crop_half", any, [](Fixture& f) {
+             const int w = f.a.getWidth(), h = f.a.getHeight();
+             consume(f.a.paste(f.b.crop(w / 4, h / 4, w / 2, h / 2), w / 8, h / 8)); }},
+        {"composite_over", alpha, [](Fixture& f) { consume(f.a.composite(f.b, 0, 0)); }},
+        {"composite_over_watermark", alpha, [](Fixture& f) {
+             consume(f.a.composite(f.padded, f.a.getWidth() / 3, f.a.getHeight() / 3)); }},
+        {"composite_xor", alpha, [](Fixture& f) { consume(f.a.composite(f.b, 0, 0, Composite::Xor)); }},
+        {"mipmaps_8", any, [](Fixture& f) { consume(f.a.mipmaps(8)); }},
+        {"gaussian_pyramid_6", any, [](Fixture& f) { consume(f.a.gaussianPyramid(6)); }},
+        {"laplacian_pyramid_6", any, [](Fixture& f) { consume(f.a.laplacianPyramid(6)); }},
+        {"at_read",        any, [](Fixture& f) {
+             uint64_t s = 0;
+             for (int y = 0; y < f.a.getHeight(); ++y)
+                 for (int x = 0; x < f.a.getWidth(); ++x) s += f.a.at(x, y, 0);
+             g_sink = g_sink + s; }},
+        {"save_png",       savable, [](Fixture& f) { g_sink = g_sink + f.a.save(f.pngPath.c_str()); }},
+        {"load_png",       savable, [](Fixture& f) { consume(Image::load(f.pngPath.c_str())); }},
+    };
+}
+
+struct Result {
+    std::string name;
+    std::string op;
+    Size size;
+    int channels;
+    Layout layout;
+    size_t bytes;
+    long iterations;
+    std::vector<double> samples;  // ns par itération, une valeur par répétition
+    double median, min, mad;
+    PerfCounters::Sample perf;  // par itération, hors des répétitions chronométrées
+};
+
+double medianOf(std::vector<double> v) {
+    std::sort(v.begin(), v.end());
+    size_t n = v.size();
+    return n == 0 ? 0.0 : (n % 2 ? v[n / 2] : 0.5 * (v[n / 2 - 1] + v[n / 2]));
+}
+
+double madOf(const std::vector<double>& v, double med) {
+    std::vector<double> d;
+    for (double x : v) d.push_back(std::fabs(x - med));
+    return medianOf(d);
+}
+
+double secondsSince(Clock::time_point t0) {
+    return std::chrono::duration<double>(Clock::now() - t0).count();
+}
+
+// Calibre le nombre d'itérations pour atteindre minTime, puis mesure chaque répétition
+Result measure(const Case& c, Fixture& f, const Options& opt, PerfCounters* counters) {
+    c.run(f);  // échauffement (caches, allocations)
+    long iters = 1;
+    for (;;) {
+        auto t0 = Clock::now();
+        for (long i = 0; i < iters; ++i) c.run(f);
+        double t = secondsSince(t0);
+        if (t >= opt.minTime || iters >= (1L << 30)) break;
+        long next = t > 0 ? static_cast<long>(iters * opt.minTime * 1.2 / t) : iters * 10;
+        iters = std::max(iters + 1, std::min(next, iters * 10));
+    }
+
+    Result r;
+    r.iterations = iters;
+    for (int rep = 0; rep < opt.repetitions; ++rep) {
+        auto t0 = Clock::now();
+        for (long i = 0; i < iters; ++i) c.run(f);
+        r.samples.push_back(secondsSince(t0) * 1e9 / iters);
+    }
+    r.median = medianOf(r.samples);
+    r.min = *std::min_element(r.samples.begin(), r.samples.end());
+    r.mad = madOf(r.samples, r.median);
+
+    if (counters) {
+        counters->start();
+        for (long i = 0; i < iters; ++i) c.run(f);
+        r.perf = counters->stop();
+        for (uint64_t& v : r.perf.value) v /= static_cast<uint64_t>(iters);
+    }
+    return r;
+}
+
+// IPC, octets par cycle, défauts de cache par Ko traité, mauvaises prédictions par Kpixel
+void printPerf(const Result& r) {
+    const PerfCounters::Sample& p = r.perf;
+    auto column = [](bool valid, double v, int width, int precision) {
+        if (valid) std::printf(" %*.*f", width, precision, v);
+        else std::printf(" %*s", width, "-");
+    };
+    const double kpix = static_cast<double>(r.size.width) * r.size.height / 1e3;
+    column(p.valid[PerfCounters::Cycles] && p.valid[PerfCounters::Instructions], p.ipc(), 6, 2);
+    column(p.valid[PerfCounters::Cycles], p.bytesPerCycle(r.bytes), 7, 2);
+    column(p.valid[PerfCounters::CacheMisses], p.value[PerfCounters::CacheMisses] / (r.bytes / 1e3), 9, 2);
+    column(p.valid[PerfCounters::BranchMisses], p.value[PerfCounters::BranchMisses] / kpix, 9, 2);
+}
+
+const char* layoutName(Layout l) { return l == Layout::Planar ? "planar" : "interleaved"; }
+
+std::string jsonEscape(const std::string& s) {
+    std::string out;
+    for (char ch : s) {
+        if (ch == '"' || ch == '\\') out += '\\';
+        out += ch;
+    }
+    return out;
+}
+
+void writeJson(const std::string& path, const std::vector<Result>& results, const Options& opt) {
+    std::ofstream os(path);
+    if (!os) throw std::runtime_error("Cannot write " + path);
+    os.precision(10);
+    std::time_t now = std::time(nullptr);
+    char date[32];
+    std::strftime(date, sizeof(date), "%Y-%m-%dT%H:%M:%S", std::localtime(&now));
+    os << "{\n  \"context\": {\n"
+       << "    \"date\": \"" << date << "\",\n"
+#if defined(__clang__)
+       << "    \"compiler\": \"clang " << __clang_version__ << "\",\n"
+#elif defined(__GNUC__)
+       << "    \"compiler\": \"gcc " << __VERSION__ << "\",\n"
+#else
+       << "    \"compiler\": \"unknown\",\n"
+#endif
+#if defined(__SSE2__) && !defined(IMAGE_NO_SIMD)
+       << "    \"simd\": \"sse2\",\n"
+#else
+       << "    \"simd\": \"none\",\n"
+#endif
+       << "    \"repetitions\": " << opt.repetitions << ",\n"
+       << "    \"min_time_s\": " << opt.minTime << "\n  },\n  \"benchmarks\": [\n";
+    for (size_t i = 0; i < results.size(); ++i) {
+        const Result& r = results[i];
+        double mbps = r.bytes / (r.median * 1e-9) / 1e6;
+        double mpix = static_cast<double>(r.size.width) * r.size.height / (r.median * 1e-9) / 1e6;
+        os << "    {\"name\": \"" << jsonEscape(r.name) << "\", \"op\": \"" << r.op << "\", "
+           << "\"width\": " << r.size.width << ", \"height\": " << r.size.height << ", "
+           << "\"channels\": " << r.channels << ", \"layout\": \"" << layoutName(r.layout) << "\", "
+           << "\"bytes\": " << r.bytes << ", \"iterations\": " << r.iterations << ",\n     \"samples_ns\": [";
+        for (size_t k = 0; k < r.samples.size(); ++k) os << (k ? ", " : "") << r.samples[k];
+        os << "], \"median_ns\": " << r.median << ", \"min_ns\": " << r.min << ", \"mad_ns\": " << r.mad
+           << ", \"mb_per_s\": " << mbps << ", \"mpix_per_s\": " << mpix;
+        if (r.perf.valid[PerfCounters::Cycles]) {
+            os << ",\n     \"perf\": {";
+            for (int e = 0; e < PerfCounters::EventCount; ++e)
+                if (r.perf.valid[e])
+                    os << "\"" << PerfCounters::name(static_cast<PerfCounters::Event>(e)) << "\": "
+                       << r.perf.value[e] << ", ";
+            os << "\"ipc\": " << r.perf.ipc() << ", \"bytes_per_cycle\": " << r.perf.bytesPerCycle(r.bytes) << "}";
+        }
+        os << "}"
+           << (i + 1 < results.size() ? "," : "") << "\n";
+    }
+    os << "  ]\n}\n";
+}
+
+std::vector<std::string> split(const std::string& s) {
+    std::vector<std::string> out;
+    std::stringstream ss(s);
+    std::string item;
+    while (std::getline(ss, item, ',')) if (!item.empty()) out.push_back(item);
+    return out;
+}
+
+void usage() {
+    std::printf(
+        "Usage : bench_image [options]\n"
+        "  --sizes LISTE       tailles parmi 64,256,1K,FHD,4K,8K ou 'all' (défaut : jusqu'à 4K)\n"
+        "  --channels LISTE    nombres de canaux (défaut : 1,3,4)\n"
+        "  --layouts LISTE     interleaved,planar (défaut : interleaved)\n"
+        "  --filter TEXTE      ne garde que les cas dont le nom contient TEXTE\n"
+        "  --repetitions N     répétitions mesurées par cas (défaut : 5)\n"
+        "  --min-time S        durée minimale d'une répétition en secondes (défaut : 0.02)\n"
+        "  --json FICHIER      écrit les résultats (échantillons compris) en JSON\n"
+        "  --perf              compteurs matériels (Linux) : IPC, octets/cycle, défauts de cache/branchement\n"
+        "                      (mesure sur un seul thread : le pool parallèle est réduit à 1)\n"
+        "  --list              liste les cas sans les exécuter\n");
+}
+
+Options parse(int argc, char** argv) {
+    Options opt;
+    std::string sizes;
+    for (int i = 1; i < argc; ++i) {
+        std::string a = argv[i];
+        auto next = [&]() -> std::string {
+            if (i + 1 >= argc) throw std::invalid_argument("Missing value for " + a);
+            return argv[++i];
+        };
+        if (a == "--sizes") sizes = next();
+        else if (a == "--channels") {
+            opt.channels.clear();
+            for (const std::string& c : split(next())) opt.channels.push_back(std::stoi(c));
+        } else if (a == "--layouts") {
+            opt.layouts.clear();
+            for (const std::string& l : split(next())) {
+                if (l == "planar") opt.layouts.push_back(Layout::Planar);
+                else if (l == "interleaved") opt.layouts.push_back(Layout::Interleaved);
+                else throw std::invalid_argument("Unknown layout: " + l);
+            }
+        } else if (a == "--filter") opt.filter = next();
+        else if (a == "--repetitions") opt.repetitions = std::max(1, std::stoi(next()));
+        else if (a == "--min-time") opt.minTime = std::stod(next());
+        else if (a == "--json") opt.jsonPath = next();
+        else if (a == "--list") opt.list = true;
+        else if (a == "--perf") opt.perf = true;
+        else if (a == "--help" || a == "-h") { usage(); std::exit(0); }
+        else throw std::invalid_argument("Unknown option: " + a);
+    }
+    for (const Size& s : ALL_SIZES) {
+        bool wanted = sizes.empty() ? std::strcmp(s.name, "8K") != 0 : sizes == "all";
+        for (const std::string& n : split(sizes)) wanted = wanted || n == s.name;
+        if (wanted) opt.sizes.push_back(s);
+    }
+    return opt;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    try {
+        Options opt = parse(argc, argv);
+        std::vector<Case> cases = makeCases();
+        std::vector<Result> results;
+        const std::string tmpPng =
+            (std::filesystem::temp_directory_path() / "bench_image_tmp.png").string();
+
+        PerfCounters counters;
+        if (opt.perf && !opt.list && !counters.open())
+            std::fprintf(stderr, "bench_image: compteurs matériels indisponibles (%s), mesure du temps seule\n",
+                         counters.error().c_str());
+        PerfCounters* perf = counters.isOpen() ? &counters : nullptr;
+        if (perf && parallel::threadCount() > 1) {
+            // Sinon les cycles et défauts des workers du pool échappent aux compteurs
+            std::printf("--perf : compteurs du seul thread appelant, pool ramené de %d à 1 thread\n",
+                        parallel::threadCount());
+            parallel::setThreadCount(1);
+        }
+
+        std::printf("%-36s %12s %12s %10s %12s", "benchmark", "median", "min", "MAD %", "MB/s");
+        if (perf) std::printf(" %6s %7s %9s %9s", "IPC", "B/cyc", "cmiss/KB", "bmiss/Kpx");
+        std::printf("\n");
+        for (const Size& size : opt.sizes) {
+            for (int ch : opt.channels) {
+                for (Layout layout : opt.layouts) {
+                    Fixture f;
+                    f.a = Image(size.width, size.height, ch, defaultModel(ch), uint8_t(0), layout);
+                    f.b = f.a;
+                    f.padded = Image(size.width / 2 + 1, size.height / 2 + 1, ch, defaultModel(ch), uint8_t(0), layout);
+                    fillRandom(f.a, 1);
+                    fillRandom(f.b, 2);
+                    fillRandom(f.padded, 3);
+                    f.pixel.assign(ch, 37);
+                    f.m1 = f.a > 100;
+                    f.m2 = f.b < 160;
+                    f.pngPath = tmpPng;
+                    if (ch <= 4) f.a.save(f.pngPath.c_str());
+
+                    for (const Case& c : cases) {
+                        std::string name = std::string(c.name) + "/" + size.name + "x" + std::to_string(ch) +
+                                           (layout == Layout::Planar ? "/planar" : "");
+                        if (!opt.filter.empty() && name.find(opt.filter) == std::string::npos) continue;
+                        if (!c.applies(f)) continue;
+                        if (opt.list) { std::printf("%s\n", name.c_str()); continue; }
+
+                        Fixture work = f;  // les cas en place ne doivent pas contaminer les suivants
+                        Result r = measure(c, work, opt, perf);
+                        r.name = name;
+                        r.op = c.name;
+                        r.size = size;
+                        r.channels = ch;
+                        r.layout = layout;
+                        r.bytes = static_cast<size_t>(size.width) * size.height * ch;
+                        double mbps = r.bytes / (r.median * 1e-9) / 1e6;
+                        std::printf("%-36s %10.3f us %10.3f us %9.1f%% %12.1f", name.c_str(), r.median / 1e3,
+                                    r.min / 1e3, r.median > 0 ? 100.0 * r.mad / r.median : 0.0, mbps);
+                        if (perf) printPerf(r);
+                        std::printf("\n");
+                        std::fflush(stdout);
+                        results.push_back(r);
+                    }
+                }
+            }
+        }
+        std::remove(tmpPng.c_str());
+        if (!opt.jsonPath.empty()) writeJson(opt.jsonPath, results, opt);
+    } catch (const std::exception& e) {
+        std::fprintf(stderr, "bench_image: %s\n", e.what());
+        return 1;
+    }
+    return 0;
+}
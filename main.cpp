@@ -41,23 +41,26 @@ int main() {
         Image lulu_inversee  = ~lulu;
         Image lulu_bright    = lulu + 60;
         Image lulu_dark      = lulu - 40;
-        Image lulu_seuil     = lulu > 120;
+        Mask  lulu_seuil     = lulu > 120;
         Image lulu_contraste = lulu * 1.5;
+        Image lulu_gris      = lulu.convertTo(ColorModel::GRAY);
 
         lulu_inversee.save("lulu_inversee.png");
         lulu_bright.save("lulu_plus_lumineuse.png");
         lulu_dark.save("lulu_plus_sombre.png");
         lulu_seuil.save("lulu_seuillage.png");
         lulu_contraste.save("lulu_contraste.png");
+        lulu_gris.save("lulu_gris.png");
 
         std::cout << "Lulu - Inversion           : lulu_inversee.png\n";
         std::cout << "Lulu - +60 luminosité      : lulu_plus_lumineuse.png\n";
         std::cout << "Lulu - -40 luminosité      : lulu_plus_sombre.png\n";
-        std::cout << "Lulu - Seuillage >120      : lulu_seuillage.png\n";
-        std::cout << "Lulu - Contraste x1.5       : lulu_contraste.png\n\n";
+        std::cout << "Lulu - Seuillage >120      : lulu_seuillage.png (" << lulu_seuil.coverage() * 100 << " % allumés)\n";
+        std::cout << "Lulu - Contraste x1.5       : lulu_contraste.png\n";
+        std::cout << "Lulu - Niveaux de gris     : lulu_gris.png (" << lulu_gris << ")\n\n";
 
         Image pip_inversee   = ~pip;
-        Image pip_seuil      = pip > 100;
+        Mask  pip_seuil      = pip > 100;
         Image pip_bright     = pip + 80;
 
         pip_inversee.save("pip_inversee.png");
@@ -65,7 +68,7 @@ int main() {
         pip_bright.save("pip_plus_lumineuse.png");
 
         std::cout << "Pip - Inversion            : pip_inversee.png\n";
-        std::cout << "Pip - Seuillage >100       : pip_seuillage.png\n";
+        std::cout << "Pip - Seuillage >100       : pip_seuillage.png (" << pip_seuil.coverage() * 100 << " % allumés)\n";
         std::cout << "Pip - +80 luminosité       : pip_plus_lumineuse.png\n\n";
 
         // ===============================================================
@@ -78,6 +81,7 @@ int main() {
         std::cout << "- lulu_plus_sombre.png\n";
         std::cout << "- lulu_seuillage.png\n";
         std::cout << "- lulu_contraste.png\n";
+        std::cout << "- lulu_gris.png\n";
         std::cout << "- pip_inversee.png\n";
         std::cout << "- pip_seuillage.png\n";
         std::cout << "- pip_plus_lumineuse.png\n\n";
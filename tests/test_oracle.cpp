@@ -0,0 +1,1207 @@
+// Oracle de correction : les implémentations scalaires d'origine de Image
+// (clampAdd/Sub/Diff/Mul/Div avec arrondi std::lround, agrandissement à 0 de
+// enlargeTo, seuillage par moyenne entière des canaux) sont recopiées ici
+// telles quelles et servent de référence. Chaque chemin accéléré (SSE2,
+// planaire, noyaux de conversion) doit les reproduire au bit près :
+//   - toutes les paires d'opérandes 256 x 256 pour les opérateurs image-image,
+//     scalaire et pixel ;
+//   - des images aléatoires de tailles impaires, 1 à 5 canaux, tailles
+//     différentes (padding) et layouts mélangés ;
+//   - chaque noyau face à sa version "Scalar" sur toutes les couleurs 24 bits ;
+//   - les noyaux de voisinage et de géométrie (convolution, flous, rangs,
+//     morphologie, redimensionnement, pyramides, orientations...) face à leur version "Scalar" naïve,
+//     sur des surfaces aléatoires avec bourrage de lignes, plusieurs threads
+//     forcés pour exercer le découpage en bandes.
+//
+//   test_oracle [--seed N] [--rounds N]
+//
+// Code de sortie 0 si tout concorde, 1 sinon (premières divergences affichées).
+#include "../Image.h"
+#include "../ImageKernels.h"
+#include "../Parallel.h"
+#include "../tools/Pipeline.h"
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <functional>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+namespace {
+
+// === RAPPORT ===
+int g_failures = 0;
+int g_checks = 0;
+
+void fail(const std::string& what) {
+    if (++g_failures <= 20) std::printf("  ECHEC %s\n", what.c_str());
+}
+
+bool check(bool ok, const std::string& what) {
+    ++g_checks;
+    if (!ok) fail(what);
+    return ok;
+}
+
+std::string fmt(const char* f, long a = 0, long b = 0, long c = 0, long d = 0, long e = 0) {
+    char buf[256];
+    std::snprintf(buf, sizeof(buf), f, a, b, c, d, e);
+    return buf;
+}
+
+// === RÉFÉRENCE (implémentation scalaire d'origine) ===
+namespace oracle {
+
+uint8_t clampAdd(int a, int b) {
+    int res = a + b;
+    return static_cast<uint8_t>(res < 0 ? 0 : (res > 255 ? 255 : res));
+}
+
+uint8_t clampSub(int a, int b) {
+    int res = a - b;
+    return static_cast<uint8_t>(res < 0 ? 0 : (res > 255 ? 255 : res));
+}
+
+uint8_t clampDiff(int a, int b) {
+    return clampSub(std::max(a, b), std::min(a, b)); // |a - b|
+}
+
+uint8_t clampMul(int a, double b) {
+    double res = a * b;
+    return static_cast<uint8_t>(res < 0 ? 0 : (res > 255 ? 255 : std::lround(res)));
+}
+
+uint8_t clampDiv(int a, double b) {
+    double res = a / b;
+    return static_cast<uint8_t>(res < 0 ? 0 : (res > 255 ? 255 : std::lround(res)));
+}
+
+// Image entrelacée minimale, indexée comme l'Image d'origine
+struct Ref {
+    int w = 0, h = 0, c = 0;
+    std::vector<uint8_t> data;
+
+    Ref(int w_, int h_, int c_) : w(w_), h(h_), c(c_), data(static_cast<size_t>(w_) * h_ * c_, 0) {}
+    uint8_t& at(int x, int y, int k) { return data[(static_cast<size_t>(y) * w + x) * c + k]; }
+    uint8_t at(int x, int y, int k) const { return data[(static_cast<size_t>(y) * w + x) * c + k]; }
+};
+
+// enlargeTo d'origine : nouvelle image à 0, ancien contenu recopié en haut à gauche
+Ref enlarge(const Ref& r, int nw, int nh) {
+    if (nw <= r.w && nh <= r.h) return r;
+    Ref out(nw, nh, r.c);
+    for (int y = 0; y < r.h; ++y)
+        for (int x = 0; x < r.w; ++x)
+            for (int k = 0; k < r.c; ++k) out.at(x, y, k) = r.at(x, y, k);
+    return out;
+}
+
+Ref binary(const Ref& a, const Ref& b, uint8_t (*op)(int, int)) {
+    const int nw = std::max(a.w, b.w), nh = std::max(a.h, b.h);
+    Ref x = enlarge(a, nw, nh), y = enlarge(b, nw, nh);
+    for (size_t i = 0; i < x.data.size(); ++i) x.data[i] = op(x.data[i], y.data[i]);
+    return x;
+}
+
+// Seuillage d'origine : moyenne entière des canaux comparée au seuil
+bool threshold(const Ref& r, int x, int y, uint8_t t, kernels::Compare op) {
+    uint32_t sum = 0;
+    for (int k = 0; k < r.c; ++k) sum += r.at(x, y, k);
+    const uint8_t v = static_cast<uint8_t>(sum / r.c);
+    switch (op) {
+        case kernels::Compare::Less:         return v < t;
+        case kernels::Compare::LessEqual:    return v <= t;
+        case kernels::Compare::Greater:      return v > t;
+        case kernels::Compare::GreaterEqual: return v >= t;
+        case kernels::Compare::Equal:        return v == t;
+        default:                             return v != t;
+    }
+}
+
+} // namespace oracle
+
+// === CONVERSIONS ENTRE Ref ET Image ===
+ColorModel modelFor(int channels) { return defaultModel(channels); }
+
+Image toImage(const oracle::Ref& r, Layout layout) {
+    Image img(r.w, r.h, r.c, modelFor(r.c), r.data.data());
+    return layout == Layout::Planar ? img.toLayout(Layout::Planar) : img;
+}
+
+// Compare pixel à pixel via at(), donc indépendamment du layout
+bool same(const Image& img, const oracle::Ref& r, const std::string& what) {
+    if (!check(img.getWidth() == r.w && img.getHeight() == r.h && img.getChannels() == r.c, what + " : dimensions"))
+        return false;
+    for (int y = 0; y < r.h; ++y)
+        for (int x = 0; x < r.w; ++x)
+            for (int k = 0; k < r.c; ++k)
+                if (img.at(x, y, k) != r.at(x, y, k)) {
+                    check(false, what + fmt(" : (%ld,%ld,%ld) obtenu %ld, attendu %ld", x, y, k, img.at(x, y, k),
+                                            r.at(x, y, k)));
+                    return false;
+                }
+    ++g_checks;
+    return true;
+}
+
+// Mêmes dimensions et mêmes pixels, layouts quelconques
+bool sameImage(const Image& a, const Image& b) {
+    if (a.getWidth() != b.getWidth() || a.getHeight() != b.getHeight() || a.getChannels() != b.getChannels())
+        return false;
+    for (int y = 0; y < a.getHeight(); ++y)
+        for (int x = 0; x < a.getWidth(); ++x)
+            for (int c = 0; c < a.getChannels(); ++c)
+                if (a.at(x, y, c) != b.at(x, y, c)) return false;
+    return true;
+}
+
+const Layout LAYOUTS[] = {Layout::Interleaved, Layout::Planar};
+
+const char* layoutName(Layout l) { return l == Layout::Planar ? "planar" : "interleaved"; }
+
+// === PAIRES EXHAUSTIVES ===
+// a(x, y) = x et b(x, y) = y : une image 256 x 256 couvre les 65536 paires
+void exhaustivePairs() {
+    std::printf("paires exhaustives 256 x 256\n");
+    for (int ch : {1, 3}) {
+        oracle::Ref a(256, 256, ch), b(256, 256, ch);
+        for (int y = 0; y < 256; ++y)
+            for (int x = 0; x < 256; ++x)
+                for (int k = 0; k < ch; ++k) {
+                    // canaux permutés pour que chaque canal voie toutes les paires
+                    a.at(x, y, k) = static_cast<uint8_t>(k % 2 ? y : x);
+                    b.at(x, y, k) = static_cast<uint8_t>(k % 2 ? x : y);
+                }
+        for (Layout la : LAYOUTS)
+            for (Layout lb : LAYOUTS) {
+                const std::string tag = fmt("%ldch ", ch) + layoutName(la) + "/" + layoutName(lb);
+                Image ia = toImage(a, la), ib = toImage(b, lb);
+                same(ia + ib, oracle::binary(a, b, oracle::clampAdd), "a + b " + tag);
+                same(ia - ib, oracle::binary(a, b, oracle::clampSub), "a - b " + tag);
+                same(ia ^ ib, oracle::binary(a, b, oracle::clampDiff), "a ^ b " + tag);
+                Image acc = ia;
+                acc += ib;
+                same(acc, oracle::binary(a, b, oracle::clampAdd), "a += b " + tag);
+            }
+    }
+
+    // Scalaires : chaque valeur de pixel contre des entiers hors de [0, 255]
+    oracle::Ref ramp(256, 1, 1);
+    for (int x = 0; x < 256; ++x) ramp.at(x, 0, 0) = static_cast<uint8_t>(x);
+    for (Layout l : LAYOUTS) {
+        Image img = toImage(ramp, l);
+        for (int v = -600; v <= 600; ++v) {
+            oracle::Ref add = ramp, sub = ramp, diff = ramp;
+            for (size_t i = 0; i < ramp.data.size(); ++i) {
+                add.data[i] = oracle::clampAdd(ramp.data[i], v);
+                sub.data[i] = oracle::clampSub(ramp.data[i], v);
+                diff.data[i] = oracle::clampDiff(ramp.data[i], v);
+            }
+            same(img + v, add, fmt("x + %ld", v));
+            same(img - v, sub, fmt("x - %ld", v));
+            same(img ^ v, diff, fmt("x ^ %ld", v));
+        }
+    }
+
+    // Pixel : les 256 valeurs sur chaque canal
+    for (int ch = 1; ch <= 5; ++ch) {
+        oracle::Ref r(256, 1, ch);
+        for (int x = 0; x < 256; ++x)
+            for (int k = 0; k < ch; ++k) r.at(x, 0, k) = static_cast<uint8_t>(x);
+        for (Layout l : LAYOUTS) {
+            Image img = toImage(r, l);
+            for (int v = 0; v < 256; ++v) {
+                std::vector<uint8_t> pixel(ch);
+                for (int k = 0; k < ch; ++k) pixel[k] = static_cast<uint8_t>((v + 97 * k) & 255);
+                oracle::Ref add = r, sub = r, diff = r;
+                for (int x = 0; x < 256; ++x)
+                    for (int k = 0; k < ch; ++k) {
+                        add.at(x, 0, k) = oracle::clampAdd(r.at(x, 0, k), pixel[k]);
+                        sub.at(x, 0, k) = oracle::clampSub(r.at(x, 0, k), pixel[k]);
+                        diff.at(x, 0, k) = oracle::clampDiff(r.at(x, 0, k), pixel[k]);
+                    }
+                const std::string tag = fmt(" pixel %ld, %ldch ", v, ch) + layoutName(l);
+                same(img + pixel, add, "x +" + tag);
+                same(img - pixel, sub, "x -" + tag);
+                same(img ^ pixel, diff, "x ^" + tag);
+            }
+        }
+    }
+
+    // Multiplication / division : égalités exactes en .5 (arrondi de lround), négatifs, extrêmes
+    const double factors[] = {0.0,  0.5,  1.0,  1.5,   2.5,        1.0 / 3, 0.1,  0.7,  1.004, 2.0,
+                              3.3,  -1.0, -0.5, 255.0, 1e-9,       1e9,     0.25, 0.75, 127.5, 0.999999999};
+    for (Layout l : LAYOUTS) {
+        Image img = toImage(ramp, l);
+        for (double f : factors) {
+            oracle::Ref mul = ramp, div = ramp;
+            for (size_t i = 0; i < ramp.data.size(); ++i) {
+                mul.data[i] = oracle::clampMul(ramp.data[i], f);
+                if (f != 0.0) div.data[i] = oracle::clampDiv(ramp.data[i], f);
+            }
+            same(img * f, mul, "x * " + std::to_string(f));
+            if (f != 0.0) same(img / f, div, "x / " + std::to_string(f));
+        }
+        bool threw = false;
+        try { img / 0.0; } catch (const std::invalid_argument&) { threw = true; }
+        check(threw, "x / 0 doit lever std::invalid_argument");
+
+        oracle::Ref inv = ramp;
+        for (uint8_t& v : inv.data) v = static_cast<uint8_t>(255 - v);
+        same(~img, inv, std::string("~x ") + layoutName(l));
+    }
+}
+
+// === IMAGES ALÉATOIRES ===
+oracle::Ref randomRef(std::mt19937& rng, int w, int h, int c) {
+    oracle::Ref r(w, h, c);
+    for (uint8_t& v : r.data) v = static_cast<uint8_t>(rng());
+    // Quelques plages saturées : les bornes 0 et 255 sont les cas de clamp
+    std::uniform_int_distribution<size_t> pos(0, r.data.size() - 1);
+    for (int i = 0; i < 8; ++i) r.data[pos(rng)] = (i & 1) ? 255 : 0;
+    return r;
+}
+
+void randomImages(std::mt19937& rng, int rounds) {
+    std::printf("images aléatoires (%d tirages)\n", rounds);
+    std::uniform_int_distribution<int> dim(1, 67), chan(1, 5), scalar(-300, 300), thr(0, 255);
+    const kernels::Compare ops[] = {kernels::Compare::Less,         kernels::Compare::LessEqual,
+                                    kernels::Compare::Greater,      kernels::Compare::GreaterEqual,
+                                    kernels::Compare::Equal,        kernels::Compare::NotEqual};
+    for (int round = 0; round < rounds; ++round) {
+        const int c = chan(rng);
+        const int aw = dim(rng) | 1, ah = dim(rng) | 1, bw = dim(rng), bh = dim(rng);
+        oracle::Ref a = randomRef(rng, aw, ah, c), b = randomRef(rng, bw, bh, c);
+        const Layout la = LAYOUTS[rng() & 1], lb = LAYOUTS[rng() & 1];
+        const std::string tag =
+            fmt(" [%ldx%ld vs %ldx%ld, %ldch ", aw, ah, bw, bh, c) + layoutName(la) + "/" + layoutName(lb) + "]";
+        Image ia = toImage(a, la), ib = toImage(b, lb);
+
+        // Opérations image-image : padding à 0 de enlargeTo des deux côtés
+        same(ia + ib, oracle::binary(a, b, oracle::clampAdd), "a + b" + tag);
+        same(ia - ib, oracle::binary(a, b, oracle::clampSub), "a - b" + tag);
+        same(ia ^ ib, oracle::binary(a, b, oracle::clampDiff), "a ^ b" + tag);
+        same(ib - ia, oracle::binary(b, a, oracle::clampSub), "b - a" + tag);
+
+        const int v = scalar(rng);
+        oracle::Ref add = a, mul = a;
+        const double f = std::uniform_real_distribution<double>(-0.5, 4.0)(rng);
+        for (size_t i = 0; i < a.data.size(); ++i) {
+            add.data[i] = oracle::clampAdd(a.data[i], v);
+            mul.data[i] = oracle::clampMul(a.data[i], f);
+        }
+        same(ia + v, add, fmt("a + %ld", v) + tag);
+        same(ia * f, mul, "a * " + std::to_string(f) + tag);
+
+        // Seuillage : bits du masque, bourrage de fin de ligne à 0, comptage
+        const uint8_t t = static_cast<uint8_t>(thr(rng));
+        for (kernels::Compare op : ops) {
+            Mask m;
+            switch (op) {
+                case kernels::Compare::Less:         m = ia < t; break;
+                case kernels::Compare::LessEqual:    m = ia <= t; break;
+                case kernels::Compare::Greater:      m = ia > t; break;
+                case kernels::Compare::GreaterEqual: m = ia >= t; break;
+                case kernels::Compare::Equal:        m = ia == t; break;
+                default:                             m = ia != t; break;
+            }
+            size_t expected = 0;
+            bool ok = m.getWidth() == aw && m.getHeight() == ah;
+            for (int y = 0; ok && y < ah; ++y) {
+                for (int x = 0; x < aw; ++x) {
+                    const bool bit = oracle::threshold(a, x, y, t, op);
+                    expected += bit;
+                    if (m.get(x, y) != bit) {
+                        ok = check(false, fmt("seuil op %ld t=%ld en (%ld,%ld)", static_cast<long>(op), t, x, y) + tag);
+                        break;
+                    }
+                }
+                const int r = aw % 64;
+                if (ok && r) ok = check((m.row(y)[m.getWordsPerRow() - 1] >> r) == 0, "bourrage du masque" + tag);
+            }
+            if (ok) check(m.count() == expected, "Mask::count" + tag);
+
+            // Expansion en image 0/255
+            Image e(m);
+            bool expandOk = true;
+            for (int y = 0; expandOk && y < ah; ++y)
+                for (int x = 0; x < aw; ++x)
+                    if (e.at(x, y, 0) != (m.get(x, y) ? 255 : 0)) { expandOk = false; break; }
+            check(expandOk, "Image(Mask)" + tag);
+        }
+
+        // Changement de layout aller-retour
+        same(ia.toLayout(Layout::Planar).toLayout(Layout::Interleaved), a, "toLayout aller-retour" + tag);
+    }
+}
+
+// === NOYAUX ACCÉLÉRÉS CONTRE LEUR RÉFÉRENCE SCALAIRE ===
+bool sameBuffer(const std::vector<uint8_t>& x, const std::vector<uint8_t>& y, const std::string& what) {
+    for (size_t i = 0; i < x.size(); ++i)
+        if (x[i] != y[i]) return check(false, what + fmt(" : octet %ld obtenu %ld, attendu %ld", i, x[i], y[i]));
+    ++g_checks;
+    return true;
+}
+
+void colorKernels() {
+    std::printf("noyaux de conversion sur les 2^24 couleurs\n");
+    // Toutes les couleurs RGB, suivies de quelques pixels pour une fin non alignée
+    const size_t n = (size_t(1) << 24) + 13;
+    for (int sc : {3, 4}) {
+        std::vector<uint8_t> src(n * sc);
+        for (size_t i = 0; i < n; ++i) {
+            const uint32_t rgb = static_cast<uint32_t>(i * 2654435761u);
+            const uint32_t v = i < (size_t(1) << 24) ? static_cast<uint32_t>(i) : rgb;
+            src[i * sc] = static_cast<uint8_t>(v);
+            src[i * sc + 1] = static_cast<uint8_t>(v >> 8);
+            src[i * sc + 2] = static_cast<uint8_t>(v >> 16);
+            if (sc == 4) src[i * sc + 3] = static_cast<uint8_t>(v >> 5);
+        }
+        for (LumaStandard st : {LumaStandard::BT601, LumaStandard::BT709}) {
+            const std::string tag = fmt(" (%ld canaux, BT.%ld)", sc, st == LumaStandard::BT601 ? 601 : 709);
+            for (int dc : {1, 2}) {
+                std::vector<uint8_t> fast(n * dc), ref(n * dc);
+                kernels::rgbToGray(src.data(), sc, fast.data(), dc, n, st);
+                kernels::rgbToGrayScalar(src.data(), sc, ref.data(), dc, n, st);
+                sameBuffer(fast, ref, fmt("rgbToGray -> %ld", dc) + tag);
+            }
+            std::vector<uint8_t> yuvFast(n * 3), yuvRef(n * 3);
+            kernels::rgbToYuv(src.data(), sc, yuvFast.data(), n, st);
+            kernels::rgbToYuvScalar(src.data(), sc, yuvRef.data(), n, st);
+            sameBuffer(yuvFast, yuvRef, "rgbToYuv" + tag);
+
+            // Les entrées YUV parcourent aussi les 2^24 triplets (src lu comme du YUV)
+            if (sc == 3) {
+                for (int dc : {3, 4}) {
+                    std::vector<uint8_t> fast(n * dc), ref(n * dc);
+                    kernels::yuvToRgb(src.data(), fast.data(), dc, n, st);
+                    kernels::yuvToRgbScalar(src.data(), ref.data(), dc, n, st);
+                    sameBuffer(fast, ref, fmt("yuvToRgb -> %ld", dc) + tag);
+                }
+            }
+        }
+    }
+}
+
+void thresholdKernels(std::mt19937& rng) {
+    std::printf("noyaux de seuillage, expansion et comptage\n");
+    const kernels::Compare ops[] = {kernels::Compare::Less,         kernels::Compare::LessEqual,
+                                    kernels::Compare::Greater,      kernels::Compare::GreaterEqual,
+                                    kernels::Compare::Equal,        kernels::Compare::NotEqual};
+    for (int c = 1; c <= 8; ++c) {
+        for (size_t pixels : {size_t(1), size_t(15), size_t(16), size_t(17), size_t(63), size_t(64), size_t(65),
+                              size_t(1000), size_t(4099)}) {
+            // Décalage de 1 octet : entrées non alignées
+            std::vector<uint8_t> src(pixels * c + 1);
+            for (uint8_t& v : src) v = static_cast<uint8_t>(rng());
+            const size_t words = (pixels + 63) / 64;
+            for (kernels::Compare op : ops)
+                for (int t : {0, 1, 127, 128, 254, 255, static_cast<int>(rng() & 255)}) {
+                    std::vector<uint64_t> fast(words, ~uint64_t(0)), ref(words, ~uint64_t(0));
+                    kernels::threshold(src.data() + 1, fast.data(), pixels, c, static_cast<uint8_t>(t), op);
+                    kernels::thresholdScalar(src.data() + 1, ref.data(), pixels, c, static_cast<uint8_t>(t), op);
+                    check(fast == ref, fmt("threshold %ld canaux, %ld pixels, op %ld, t=%ld", c,
+                                           static_cast<long>(pixels), static_cast<long>(op), t));
+
+                    // Planaire : mêmes pixels désentrelacés
+                    std::vector<uint8_t> planes(pixels * c);
+                    kernels::deinterleave(src.data() + 1, planes.data(), pixels, c);
+                    std::vector<uint64_t> planar(words, ~uint64_t(0));
+                    kernels::thresholdPlanar(planes.data(), pixels, c, planar.data(), pixels,
+                                             static_cast<uint8_t>(t), op);
+                    check(planar == ref, fmt("thresholdPlanar %ld canaux, %ld pixels, op %ld, t=%ld", c,
+                                             static_cast<long>(pixels), static_cast<long>(op), t));
+                }
+
+            // Désentrelacement / entrelacement contre l'indexation directe
+            std::vector<uint8_t> planes(pixels * c), back(pixels * c);
+            kernels::deinterleave(src.data() + 1, planes.data(), pixels, c);
+            bool ok = true;
+            for (size_t i = 0; ok && i < pixels; ++i)
+                for (int k = 0; k < c; ++k)
+                    if (planes[k * pixels + i] != src[1 + i * c + k]) { ok = false; break; }
+            check(ok, fmt("deinterleave %ld canaux, %ld pixels", c, static_cast<long>(pixels)));
+            kernels::interleave(planes.data(), back.data(), pixels, c);
+            check(std::memcmp(back.data(), src.data() + 1, back.size()) == 0,
+                  fmt("interleave %ld canaux, %ld pixels", c, static_cast<long>(pixels)));
+        }
+    }
+
+    for (size_t pixels : {size_t(1), size_t(7), size_t(8), size_t(9), size_t(64), size_t(200), size_t(1027)}) {
+        std::vector<uint64_t> bits((pixels + 63) / 64);
+        for (uint64_t& w : bits) w = (uint64_t(rng()) << 32) | rng();
+        std::vector<uint8_t> out(pixels + 1, 0xAB);
+        kernels::expandBits(bits.data(), out.data(), pixels, 200, 7);
+        bool ok = out[pixels] == 0xAB;  // pas d'écriture au-delà de la fin
+        size_t pop = 0;
+        for (size_t i = 0; i < pixels; ++i) {
+            const bool bit = (bits[i / 64] >> (i % 64)) & 1;
+            ok = ok && out[i] == (bit ? 200 : 7);
+        }
+        for (uint64_t w : bits)
+            for (int b = 0; b < 64; ++b) pop += (w >> b) & 1;
+        check(ok, fmt("expandBits %ld pixels", static_cast<long>(pixels)));
+        check(kernels::popcount(bits.data(), bits.size()) == pop, fmt("popcount %ld mots", static_cast<long>(bits.size())));
+    }
+}
+
+// === VOISINAGES ===
+// Surface aléatoire dont les lignes ont `pad` octets de bourrage (stride > largeur)
+struct TestSurface {
+    int w, h, c;
+    size_t stride;
+    std::vector<uint8_t> data;
+
+    TestSurface(int width, int height, int channels, size_t pad, uint8_t fill = 0xCD)
+        : w(width), h(height), c(channels), stride(static_cast<size_t>(width) * channels + pad),
+          data(stride * height, fill) {}
+
+    kernels::ConstSurface in() const { return {data.data(), w, h, c, stride}; }
+    kernels::Surface out() { return {data.data(), w, h, c, stride}; }
+    uint8_t at(int x, int y, int k) const { return data[y * stride + static_cast<size_t>(x) * c + k]; }
+};
+
+TestSurface randomSurface(std::mt19937& rng, int w, int h, int c) {
+    TestSurface s(w, h, c, rng() % 5);
+    for (uint8_t& v : s.data) v = static_cast<uint8_t>(rng());
+    return s;
+}
+
+const Border BORDERS[] = {Border::Zero, Border::Replicate, Border::Reflect};
+
+void convolutionKernels(std::mt19937& rng, int rounds) {
+    std::printf("convolution (%d tirages)\n", rounds);
+    std::uniform_int_distribution<int> dim(1, 40), chan(1, 4), radius(0, 4);
+    std::uniform_real_distribution<float> weight(-1.0f, 1.0f);
+    for (int round = 0; round < rounds; ++round) {
+        const int w = dim(rng), h = dim(rng), c = chan(rng);
+        const Border border = BORDERS[round % 3];
+        const TestSurface src = randomSurface(rng, w, h, c);
+
+        // Un tirage sur deux : noyau positif normalisé (flou), sinon poids signés
+        std::vector<float> hk(2 * radius(rng) + 1), vk(2 * radius(rng) + 1);
+        for (std::vector<float>* k : {&hk, &vk}) {
+            float sum = 0;
+            for (float& x : *k) sum += (x = round % 2 ? weight(rng) : std::fabs(weight(rng)) + 0.01f);
+            if (round % 2 == 0)
+                for (float& x : *k) x /= sum;
+        }
+        TestSurface fast(w, h, c, src.stride - static_cast<size_t>(w) * c), ref = fast;
+        kernels::convolveSeparable(src.in(), fast.out(), hk.data(), static_cast<int>(hk.size()), vk.data(),
+                                   static_cast<int>(vk.size()), border);
+        kernels::convolveSeparableScalar(src.in(), ref.out(), hk.data(), static_cast<int>(hk.size()), vk.data(),
+                                         static_cast<int>(vk.size()), border);
+        sameBuffer(fast.data, ref.data, fmt("convolveSeparable %ldx%ldx%ld, noyau %ldx%ld", w, h, c,
+                                            static_cast<long>(hk.size()), static_cast<long>(vk.size())));
+
+        const int kw = 2 * radius(rng) + 1, kh = 2 * radius(rng) + 1;
+        std::vector<float> k2(static_cast<size_t>(kw) * kh);
+        for (float& x : k2) x = weight(rng) * (rng() % 4 ? 1.0f : 0.0f);
+        const Kernel kernel(kw, kh, k2);
+        kernels::convolve2D(src.in(), fast.out(), kernel, border);
+        kernels::convolve2DScalar(src.in(), ref.out(), kernel, border);
+        sameBuffer(fast.data, ref.data, fmt("convolve2D %ldx%ldx%ld, noyau %ldx%ld", w, h, c, kw, kh));
+    }
+
+    // Image de plusieurs bandes, gaussienne : à ±1 de la convolution en double
+    const int w = 257, h = 301;
+    const oracle::Ref r = randomRef(rng, w, h, 3);
+    const Kernel gauss = Kernel::gaussian(2.0);
+    const int kr = gauss.getWidth() / 2;
+    std::vector<float> hg, vg;
+    check(gauss.separate(hg, vg), "Kernel::gaussian séparable");
+    check(!Kernel::sharpen().separate(hg, vg), "Kernel::sharpen non séparable");
+    // Grand sigma : facteurs 1D seulement (pas de noyau dense de 6001²), borne avant le cast
+    const Kernel wide = Kernel::gaussian(1000.0);
+    check(wide.getWidth() == 6001 && wide.separate(hg, vg) && hg.size() == 6001 && vg.size() == 6001,
+          "Kernel::gaussian, grand sigma séparable");
+    bool threw = false;
+    try { Kernel::gaussian(1e9); } catch (const std::invalid_argument&) { threw = true; }
+    check(threw, "Kernel::gaussian, sigma hors borne");
+    for (Layout layout : LAYOUTS) {
+        for (Border border : BORDERS) {
+            const Image out = toImage(r, layout).convolve(gauss, border);
+            int worst = 0;
+            for (int y = 0; y < h; ++y)
+                for (int x = 0; x < w; ++x)
+                    for (int k = 0; k < 3; ++k) {
+                        double acc = 0;
+                        for (int j = -kr; j <= kr; ++j)
+                            for (int i = -kr; i <= kr; ++i) {
+                                const int xx = kernels::borderIndex(x + i, w, border);
+                                const int yy = kernels::borderIndex(y + j, h, border);
+                                if (xx >= 0 && yy >= 0) acc += gauss(i + kr, j + kr) * r.at(xx, yy, k);
+                            }
+                        worst = std::max(worst, std::abs(out.at(x, y, k) - static_cast<int>(std::lround(acc))));
+                    }
+            check(worst <= 1, std::string("convolve gaussienne ") + layoutName(layout) +
+                                  fmt(", bord %ld : écart %ld", static_cast<long>(border), worst));
+        }
+    }
+}
+
+void blurKernels(std::mt19937& rng, int rounds) {
+    std::printf("flous par sommes glissantes (%d tirages)\n", rounds);
+    std::uniform_int_distribution<int> dim(1, 70), chan(1, 5), radius(0, 12), passes(1, 3);
+    for (int round = 0; round < rounds; ++round) {
+        const int w = dim(rng), h = dim(rng), c = chan(rng), n = passes(rng);
+        const Border border = BORDERS[round % 3];
+        // Quelques rayons plus grands que l'image (reflets multiples)
+        int radii[3];
+        for (int& r : radii) r = round % 7 ? radius(rng) : radius(rng) * 10;
+        const TestSurface src = randomSurface(rng, w, h, c);
+        TestSurface fast = src, ref = src;
+        kernels::boxBlurRows(fast.out(), radii, n, border);
+        kernels::boxBlurRowsScalar(ref.out(), radii, n, border);
+        sameBuffer(fast.data, ref.data, fmt("boxBlurRows %ldx%ldx%ld, rayon %ld, %ld passe(s)", w, h, c, radii[0], n));
+        kernels::boxBlurColumns(fast.out(), radii, n, border);
+        kernels::boxBlurColumnsScalar(ref.out(), radii, n, border);
+        sameBuffer(fast.data, ref.data, fmt("boxBlurColumns %ldx%ldx%ld, rayon %ld, %ld passe(s)", w, h, c, radii[0], n));
+    }
+    // Fenêtres au-delà de 4096 : division exacte au lieu de la multiplication
+    TestSurface big = randomSurface(rng, 5000, 3, 1), ref = big;
+    const int r = 2100;
+    kernels::boxBlurRows(big.out(), &r, 1, Border::Reflect);
+    kernels::boxBlurRowsScalar(ref.out(), &r, 1, Border::Reflect);
+    sameBuffer(big.data, ref.data, "boxBlurRows rayon 2100");
+    TestSurface tall = randomSurface(rng, 3, 5000, 2), tallRef = tall;
+    kernels::boxBlurColumns(tall.out(), &r, 1, Border::Zero);
+    kernels::boxBlurColumnsScalar(tallRef.out(), &r, 1, Border::Zero);
+    sameBuffer(tall.data, tallRef.data, "boxBlurColumns rayon 2100");
+
+    // Étapes de Pipeline (imgop, imgopd) : chaque opérateur de flou appelle le sien
+    const Image photo = toImage(randomRef(rng, 61, 47, 3), Layout::Interleaved);
+    auto step = [&](const std::string& op, const std::string& arg) {
+        Pipeline p;
+        p.add(op, arg);
+        return p.run(photo);
+    };
+    Image boxed = photo, smooth = photo;
+    check(sameImage(step("boxblur", "4"), boxed.boxBlur(4)), "Pipeline boxblur = Image::boxBlur");
+    check(sameImage(step("fastblur", "3.5"), smooth.gaussianBlur(3.5)), "Pipeline fastblur = Image::gaussianBlur");
+    check(sameImage(step("blur", "1.5"), photo.convolve(Kernel::gaussian(1.5))), "Pipeline blur");
+    check(sameImage(step("sharpen", "0.5"), photo.convolve(Kernel::sharpen(0.5))), "Pipeline sharpen");
+
+    // sigma borné comme Kernel::gaussian (cast du rayon des box sinon indéfini)
+    for (double sigma : {0.0, -1.0, Kernel::maxRadius / 3.0 + 1, 1e300, std::nan("")}) {
+        Image big = photo;
+        bool threw = false;
+        try { big.gaussianBlur(sigma); } catch (const std::invalid_argument&) { threw = true; }
+        check(threw, "gaussianBlur, sigma hors borne");
+    }
+
+    // Gaussienne par trois box : proche de la convolution gaussienne exacte
+    // loin des bords (chaque passe y réapplique le bord au résultat de la précédente)
+    const oracle::Ref img = randomRef(rng, 240, 180, 1);
+    for (double sigma : {2.0, 5.0, 12.0}) {
+        Image approx = toImage(img, Layout::Interleaved);
+        approx.gaussianBlur(sigma);
+        const Image exact = toImage(img, Layout::Interleaved).convolve(Kernel::gaussian(sigma));
+        const int margin = static_cast<int>(3 * sigma) + 1;
+        int worst = 0;
+        for (int y = margin; y < img.h - margin; ++y)
+            for (int x = margin; x < img.w - margin; ++x)
+                worst = std::max(worst, std::abs(approx.at(x, y, 0) - exact.at(x, y, 0)));
+        check(worst <= 6, fmt("gaussianBlur sigma %ld : écart %ld avec convolve", static_cast<long>(sigma), worst));
+    }
+}
+
+void rankKernels(std::mt19937& rng, int rounds) {
+    std::printf("filtres de rang (%d tirages)\n", rounds);
+    std::uniform_int_distribution<int> dim(1, 50), chan(1, 5), radius(0, 6);
+    for (int round = 0; round < rounds; ++round) {
+        const int w = dim(rng), h = dim(rng), c = chan(rng), r = radius(rng), n = (2 * r + 1) * (2 * r + 1);
+        const Border border = BORDERS[round % 3];
+        // Extrêmes et médiane (chemins les plus utilisés), sinon rang quelconque
+        const int k = round % 4 == 0 ? 0 : round % 4 == 1 ? n - 1 : round % 4 == 2 ? n / 2 : static_cast<int>(rng() % n);
+        const TestSurface src = randomSurface(rng, w, h, c);
+        TestSurface fast(w, h, c, src.stride - static_cast<size_t>(w) * c), ref = fast;
+        kernels::rankFilter(src.in(), fast.out(), r, k, border);
+        kernels::rankFilterScalar(src.in(), ref.out(), r, k, border);
+        sameBuffer(fast.data, ref.data, fmt("rankFilter %ldx%ldx%ld, rayon %ld, rang %ld", w, h, c, r, k));
+    }
+    // Plusieurs tuiles et bandes d'histogrammes
+    for (int r : {4, 9, 30}) {
+        const TestSurface src = randomSurface(rng, 300, 150, 1);
+        TestSurface fast(300, 150, 1, 0), ref = fast;
+        const int n = (2 * r + 1) * (2 * r + 1);
+        kernels::rankFilter(src.in(), fast.out(), r, n / 3, Border::Reflect);
+        kernels::rankFilterScalar(src.in(), ref.out(), r, n / 3, Border::Reflect);
+        sameBuffer(fast.data, ref.data, fmt("rankFilter 300x150, rayon %ld", r));
+    }
+    // r >= 128 : fenêtre de plus de 65535 échantillons (compteurs de la fenêtre sur 32 bits)
+    for (Border border : BORDERS) {
+        const int r = 130, n = (2 * r + 1) * (2 * r + 1);
+        const TestSurface src = randomSurface(rng, 9, 7, 2);
+        TestSurface fast(9, 7, 2, 0), ref = fast;
+        for (int k : {n / 2, n - 1}) {
+            kernels::rankFilter(src.in(), fast.out(), r, k, border);
+            kernels::rankFilterScalar(src.in(), ref.out(), r, k, border);
+            sameBuffer(fast.data, ref.data, fmt("rankFilter rayon 130, rang %ld", k));
+        }
+    }
+    bool threw = false;
+    try { toImage(randomRef(rng, 4, 4, 1), Layout::Interleaved).median(kernels::maxRankRadius + 1); }
+    catch (const std::invalid_argument&) { threw = true; }
+    check(threw, "median, rayon hors borne");
+
+    // Image::median : mêmes valeurs quel que soit le layout
+    const oracle::Ref img = randomRef(rng, 61, 47, 3);
+    for (int r : {1, 2, 3}) {
+        const Image a = toImage(img, Layout::Interleaved).median(r);
+        const Image b = toImage(img, Layout::Planar).median(r);
+        int diff = 0;
+        for (int y = 0; y < img.h; ++y)
+            for (int x = 0; x < img.w; ++x)
+                for (int k = 0; k < 3; ++k) diff += a.at(x, y, k) != b.at(x, y, k);
+        check(diff == 0, fmt("median rayon %ld : %ld écart(s) entre layouts", r, diff));
+    }
+}
+
+// Élément aléatoire : rectangle plein une fois sur trois, sinon points tirés
+// au hasard (le centre toujours actif), disque ou croix
+StructuringElement randomElement(std::mt19937& rng, int round) {
+    std::uniform_int_distribution<int> radius(0, 5);
+    const int w = 2 * radius(rng) + 1, h = 2 * radius(rng) + 1;
+    switch (round % 5) {
+        case 0:
+        case 1: return StructuringElement::rectangle(w, h);
+        case 2: return StructuringElement::disk(radius(rng) + 1);
+        case 3: return StructuringElement::cross(radius(rng));
+        default: {
+            std::vector<uint8_t> p(static_cast<size_t>(w) * h);
+            for (uint8_t& v : p) v = rng() % 2;
+            p[p.size() / 2] = 1;
+            return StructuringElement(w, h, p);
+        }
+    }
+}
+
+Mask randomMask(std::mt19937& rng, int w, int h) {
+    Mask m(w, h);
+    const unsigned density = 1 + rng() % 9;  // de 10 % à 90 % de points
+    for (int y = 0; y < h; ++y)
+        for (int x = 0; x < w; ++x) m.set(x, y, rng() % 10 < density);
+    return m;
+}
+
+void morphologyKernels(std::mt19937& rng, int rounds) {
+    std::printf("morphologie (%d tirages)\n", rounds);
+    std::uniform_int_distribution<int> dim(1, 60), wide(1, 300), chan(1, 4);
+    for (int round = 0; round < rounds; ++round) {
+        const StructuringElement se = randomElement(rng, round);
+        const std::string shape = fmt("élément %ldx%ld", se.getWidth(), se.getHeight()) +
+                                  (se.isRectangle() ? " plein" : "");
+
+        const int w = dim(rng), h = dim(rng), c = chan(rng);
+        const Border border = BORDERS[round % 3];
+        const kernels::Extremum ext = round % 2 ? kernels::Extremum::Max : kernels::Extremum::Min;
+        const TestSurface src = randomSurface(rng, w, h, c);
+        TestSurface fast(w, h, c, src.stride - static_cast<size_t>(w) * c), ref = fast;
+        kernels::windowExtremum(src.in(), fast.out(), se, ext, border);
+        kernels::windowExtremumScalar(src.in(), ref.out(), se, ext, border);
+        sameBuffer(fast.data, ref.data, fmt("windowExtremum %ldx%ldx%ld, ", w, h, c) + shape);
+
+        const Mask m = randomMask(rng, wide(rng), dim(rng));
+        Mask a(m.getWidth(), m.getHeight()), b = a;
+        kernels::windowOrBits(m.row(0), a.row(0), m.getWidth(), m.getHeight(), m.getWordsPerRow(), se);
+        kernels::windowOrBitsScalar(m.row(0), b.row(0), m.getWidth(), m.getHeight(), m.getWordsPerRow(), se);
+        check(a == b, fmt("windowOrBits %ldx%ld, ", m.getWidth(), m.getHeight()) + shape);
+
+        // Mask et Image 0/255 concordent (extérieur ignoré : Zero pour dilate,
+        // Replicate pour erode par un rectangle)
+        const Image img = m.toImage();
+        check(m.dilate(se) == (img.dilate(se, Border::Zero) > 127), "Mask::dilate / Image::dilate, " + shape);
+        if (se.isRectangle())
+            check(m.erode(se) == (img.erode(se) > 127), "Mask::erode / Image::erode, " + shape);
+        const Mask opened = m.open(se);
+        check(opened.open(se) == opened && (opened & ~m).count() == 0, "Mask::open idempotente, " + shape);
+    }
+}
+
+const ResizeFilter FILTERS[] = {ResizeFilter::Nearest, ResizeFilter::Bilinear, ResizeFilter::Bicubic,
+                                 ResizeFilter::Lanczos3, ResizeFilter::Area};
+
+void resizeKernels(std::mt19937& rng, int rounds) {
+    std::printf("redimensionnement (%d tirages)\n", rounds);
+    std::uniform_int_distribution<int> dim(1, 60), chan(1, 5), pow2(0, 4);
+    for (int round = 0; round < rounds; ++round) {
+        const ResizeFilter filter = FILTERS[round % 5];
+        const int w = dim(rng), h = dim(rng), c = chan(rng);
+        // Un tirage sur quatre : réduction par 2^k (chemin direct de Area)
+        const bool box = round % 4 == 0;
+        const int sw = box ? w << pow2(rng) : w, sh = box ? h << pow2(rng) : h;
+        const int dw = box ? w : dim(rng) + rng() % 2 * 40, dh = box ? h : dim(rng);
+        const TestSurface src = randomSurface(rng, sw, sh, c);
+        TestSurface fast(dw, dh, c, rng() % 5), ref = fast;
+        kernels::resize(src.in(), fast.out(), filter);
+        kernels::resizeScalar(src.in(), ref.out(), filter);
+        sameBuffer(fast.data, ref.data, fmt("resize %ldx%ldx%ld -> %ldx%ld, filtre ", sw, sh, c, dw, dh) +
+                                            std::to_string(static_cast<int>(filter)));
+    }
+
+    // Image constante : poids de somme exacte ; même taille : identité
+    const oracle::Ref img = randomRef(rng, 37, 29, 3);
+    for (ResizeFilter filter : FILTERS) {
+        const std::string tag = " (filtre " + std::to_string(static_cast<int>(filter)) + ")";
+        Image flat(53, 41, 3, ColorModel::RGB, uint8_t(77));
+        const Image small = flat.resize(17, 90, filter);
+        bool constant = true;
+        for (int y = 0; y < small.getHeight(); ++y)
+            for (int x = 0; x < small.getWidth(); ++x)
+                for (int k = 0; k < 3; ++k) constant &= small.at(x, y, k) == 77;
+        check(constant, "resize d'une image constante" + tag);
+        same(toImage(img, Layout::Interleaved).resize(img.w, img.h, filter), img, "resize à l'identique" + tag);
+        const Image a = toImage(img, Layout::Interleaved).resize(60, 20, filter);
+        const Image b = toImage(img, Layout::Planar).resize(60, 20, filter);
+        int diff = 0;
+        for (int y = 0; y < 20; ++y)
+            for (int x = 0; x < 60; ++x)
+                for (int k = 0; k < 3; ++k) diff += a.at(x, y, k) != b.at(x, y, k);
+        check(diff == 0, "resize planaire / entrelacé" + tag);
+    }
+}
+
+void pyramidKernels(std::mt19937& rng, int rounds) {
+    std::printf("pyramides (%d tirages)\n", rounds);
+    std::uniform_int_distribution<int> dim(1, 70), chan(1, 4), depth(1, 7);
+    for (int round = 0; round < rounds; ++round) {
+        const kernels::PyramidKind kind = round % 2 ? kernels::PyramidKind::Gaussian : kernels::PyramidKind::Box;
+        const bool laplacian = kind == kernels::PyramidKind::Gaussian && round % 4 == 1;
+        const int w = dim(rng), h = dim(rng), c = chan(rng), count = depth(rng);
+        const TestSurface src = randomSurface(rng, w, h, c);
+        std::vector<TestSurface> fast, ref, lapFast, lapRef;
+        for (int k = 0, lw = w, lh = h; k < count; ++k) {
+            if (laplacian) {
+                lapFast.emplace_back(lw, lh, c, rng() % 5);
+                lapRef.push_back(lapFast.back());
+            }
+            lw = (lw + 1) / 2, lh = (lh + 1) / 2;
+            fast.emplace_back(lw, lh, c, rng() % 5);
+            ref.push_back(fast.back());
+        }
+        std::vector<kernels::Surface> f, r, lf, lr;
+        for (int k = 0; k < count; ++k) {
+            f.push_back(fast[k].out()), r.push_back(ref[k].out());
+            if (laplacian) lf.push_back(lapFast[k].out()), lr.push_back(lapRef[k].out());
+        }
+        kernels::pyramid(src.in(), f.data(), count, kind, laplacian ? lf.data() : nullptr);
+        kernels::pyramidScalar(src.in(), r.data(), count, kind, laplacian ? lr.data() : nullptr);
+        const std::string tag = fmt("pyramide %ldx%ldx%ld, ", w, h, c) + (laplacian ? "laplacien" : "type ") +
+                                std::to_string(static_cast<int>(kind)) + ", niveau ";
+        for (int k = 0; k < count; ++k) {
+            sameBuffer(fast[k].data, ref[k].data, tag + std::to_string(k));
+            if (laplacian) sameBuffer(lapFast[k].data, lapRef[k].data, tag + std::to_string(k) + " (détail)");
+        }
+    }
+
+    // Nombre de niveaux, planaire / entrelacé, reconstruction exacte sans saturation
+    const oracle::Ref img = randomRef(rng, 45, 31, 3);
+    const std::vector<Image> a = toImage(img, Layout::Interleaved).mipmaps();
+    const std::vector<Image> b = toImage(img, Layout::Planar).mipmaps();
+    check(a.size() == 6 && a.back().getWidth() == 1 && a.back().getHeight() == 1, "mipmaps jusqu'à 1x1");
+    int diff = 0;
+    for (size_t k = 0; k < a.size() && k < b.size(); ++k)
+        for (int y = 0; y < a[k].getHeight(); ++y)
+            for (int x = 0; x < a[k].getWidth(); ++x)
+                for (int i = 0; i < 3; ++i) diff += a[k].at(x, y, i) != b[k].at(x, y, i);
+    check(diff == 0, "mipmaps planaire / entrelacé");
+
+    Image smooth(61, 43, 3, ColorModel::RGB, uint8_t(0));
+    for (int y = 0; y < 43; ++y)
+        for (int x = 0; x < 61; ++x)
+            for (int i = 0; i < 3; ++i) smooth.at(x, y, i) = static_cast<uint8_t>(60 + x + y + 20 * i);
+    for (Layout layout : LAYOUTS) {
+        const Image src = smooth.toLayout(layout);
+        const std::vector<Image> lap = src.laplacianPyramid(4);
+        check(lap.size() == 5 && lap[0].getWidth() == 61 && lap[4].getWidth() == 4, "laplacianPyramid(4) : 5 niveaux");
+        const Image back = Image::collapseLaplacian(lap);
+        int err = 0;
+        for (int y = 0; y < 43; ++y)
+            for (int x = 0; x < 61; ++x)
+                for (int i = 0; i < 3; ++i) err += back.at(x, y, i) != smooth.at(x, y, i);
+        check(err == 0, "collapseLaplacian(laplacianPyramid) sans saturation");
+    }
+}
+
+// JPEG avec un segment APP1 "Exif" minimal (IFD0 réduit au tag d'orientation)
+std::vector<uint8_t> withExifOrientation(const std::vector<uint8_t>& jpeg, int orientation, bool bigEndian) {
+    const uint8_t le[] = {'I', 'I', 42, 0, 8, 0, 0, 0, 1, 0, 0x12, 0x01, 3, 0, 1, 0, 0, 0,
+                          static_cast<uint8_t>(orientation), 0, 0, 0, 0, 0, 0, 0};
+    const uint8_t be[] = {'M', 'M', 0, 42, 0, 0, 0, 8, 0, 1, 0x01, 0x12, 0, 3, 0, 0, 0, 1,
+                          0, static_cast<uint8_t>(orientation), 0, 0, 0, 0, 0, 0};
+    std::vector<uint8_t> out(jpeg.begin(), jpeg.begin() + 2);
+    const uint8_t header[] = {0xFF, 0xE1, 0, 2 + 6 + sizeof le, 'E', 'x', 'i', 'f', 0, 0};
+    out.insert(out.end(), header, header + sizeof header);
+    out.insert(out.end(), bigEndian ? be : le, (bigEndian ? be : le) + sizeof le);
+    out.insert(out.end(), jpeg.begin() + 2, jpeg.end());
+    return out;
+}
+
+void orientationKernels(std::mt19937& rng, int rounds) {
+    std::printf("orientations (%d tirages)\n", rounds);
+    std::uniform_int_distribution<int> dim(1, 90), chan(1, 5), orientation(1, 8);
+    for (int round = 0; round < rounds; ++round) {
+        const Orientation o = static_cast<Orientation>(orientation(rng));
+        const int w = dim(rng), c = chan(rng);
+        // Un tirage sur trois carré : quarts de tour en place
+        const int h = round % 3 == 0 ? w : dim(rng);
+        const bool swap = kernels::swapsAxes(o);
+        const TestSurface src = randomSurface(rng, w, h, c);
+        TestSurface fast(swap ? h : w, swap ? w : h, c, rng() % 5), ref = fast;
+        kernels::orient(src.in(), fast.out(), o);
+        kernels::orientScalar(src.in(), ref.out(), o);
+        const std::string tag = fmt("orientation %ld, %ldx%ldx%ld", static_cast<int>(o), w, h, c);
+        sameBuffer(fast.data, ref.data, tag);
+        if (swap && w != h) continue;
+        TestSurface inPlace = src;
+        kernels::orientInPlace(inPlace.out(), o);
+        bool same = true;
+        for (int y = 0; y < ref.h; ++y)
+            for (int x = 0; x < ref.w; ++x)
+                for (int k = 0; k < c; ++k) same &= inPlace.at(x, y, k) == ref.at(x, y, k);
+        check(same, tag + " (en place)");
+    }
+
+    // Compositions, layouts, réallocation en place d'une image non carrée
+    const oracle::Ref ref = randomRef(rng, 37, 21, 3);
+    for (Layout layout : LAYOUTS) {
+        const Image img = toImage(ref, layout);
+        check(sameImage(img.rotate90().rotate270(), img), "rotate90 puis rotate270");
+        check(sameImage(img.rotate90().rotate90(), img.rotate180()), "deux quarts de tour");
+        check(sameImage(img.transpose().flipHorizontal(), img.rotate90()), "transpose puis miroir");
+        check(sameImage(img.flipVertical().flipHorizontal(), img.rotate180()), "deux miroirs");
+        Image copy = img;
+        check(sameImage(copy.orient(Orientation::Transverse), img.oriented(Orientation::Transverse)),
+              "orient en place, image non carrée");
+    }
+
+    // Pipeline rotate : tout angle multiple de 90 après réduction modulo 360
+    // prend le quart de tour (taille transposée), pas la déformation
+    const Image photo = toImage(ref, Layout::Interleaved);
+    auto rotated = [&](const std::string& deg) {
+        Pipeline p;
+        p.add("rotate", deg);
+        return p.run(photo);
+    };
+    for (const char* deg : {"90", "90.0", "450", "-270"})
+        check(sameImage(rotated(deg), photo.rotate90()), std::string("Pipeline rotate ") + deg);
+    for (const char* deg : {"180", "-180", "540"})
+        check(sameImage(rotated(deg), photo.rotate180()), std::string("Pipeline rotate ") + deg);
+    for (const char* deg : {"270", "-90", "630"})
+        check(sameImage(rotated(deg), photo.rotate270()), std::string("Pipeline rotate ") + deg);
+    for (const char* deg : {"0", "360", "-720"})
+        check(sameImage(rotated(deg), photo), std::string("Pipeline rotate ") + deg);
+
+    // Orientation EXIF appliquée au décodage, TIFF petit et grand boutiste
+    const std::vector<uint8_t> jpeg = toImage(ref, Layout::Interleaved).encode(FileFormat::JPEG, 95);
+    const Image stored = Image::decode(jpeg.data(), jpeg.size());
+    for (int v = 1; v <= 8; ++v) {
+        const std::vector<uint8_t> tagged = withExifOrientation(jpeg, v, v % 2 == 0);
+        const Image shown = Image::decode(tagged.data(), tagged.size());
+        const Image raw = Image::decode(tagged.data(), tagged.size(), 0, false);
+        check(sameImage(shown, stored.oriented(static_cast<Orientation>(v))), "EXIF orientation " + std::to_string(v));
+        check(sameImage(raw, stored), "EXIF ignoré, orientation " + std::to_string(v));
+    }
+}
+
+const Interpolation INTERPOLATIONS[] = {Interpolation::Nearest, Interpolation::Bilinear, Interpolation::Bicubic};
+
+void warpKernels(std::mt19937& rng, int rounds) {
+    std::printf("déformations (%d tirages)\n", rounds);
+    std::uniform_int_distribution<int> dim(1, 70), chan(1, 5), pick(0, 2);
+    std::uniform_real_distribution<double> unit(-1, 1);
+    for (int round = 0; round < rounds; ++round) {
+        const int w = dim(rng), h = dim(rng), c = chan(rng);
+        const int ow = dim(rng), oh = dim(rng);
+        // Rotation + échelle + translation, parfois un terme de perspective
+        const double angle = unit(rng) * 3.2, s = 0.4 + (unit(rng) + 1);
+        std::array<double, 9> m = {s * std::cos(angle), -s * std::sin(angle), unit(rng) * w,
+                                   s * std::sin(angle), s * std::cos(angle),  unit(rng) * h,
+                                   0, 0, 1};
+        if (round % 2) m[6] = unit(rng) * 0.02, m[7] = unit(rng) * 0.02;
+        const Interpolation interp = INTERPOLATIONS[pick(rng)];
+        const Border border = BORDERS[pick(rng)];
+        const TestSurface src = randomSurface(rng, w, h, c);
+        TestSurface fast(ow, oh, c, rng() % 5), ref = fast;
+        const kernels::WarpMap map = kernels::warpMap(m.data(), ow, oh);
+        kernels::warp(src.in(), fast.out(), map, interp, border);
+        kernels::warpScalar(src.in(), ref.out(), map, interp, border);
+        sameBuffer(fast.data, ref.data,
+                   fmt("warp %ldx%ldx%ld -> %ldx%ld", w, h, c, ow, oh) +
+                       fmt(", interpolation %ld, bord %ld", static_cast<int>(interp), static_cast<int>(border)));
+    }
+
+    // Transform : points de perspective, inverse
+    const std::array<Transform::Point, 4> from = {{{0, 0}, {99, 0}, {99, 49}, {0, 49}}};
+    const std::array<Transform::Point, 4> to = {{{10, 5}, {90, 12}, {80, 60}, {3, 44}}};
+    const Transform t = Transform::perspective(from, to);
+    for (int i = 0; i < 4; ++i) {
+        const Transform::Point p = t.apply(from[i]);
+        check(std::fabs(p.x - to[i].x) < 1e-9 && std::fabs(p.y - to[i].y) < 1e-9, fmt("perspective, point %ld", i));
+    }
+    const Transform id = t * t.inverse();
+    bool identity = true;
+    for (int r = 0; r < 3; ++r)
+        for (int k = 0; k < 3; ++k) identity &= std::fabs(id(r, k) / id(2, 2) - (r == k)) < 1e-12;
+    check(identity, "transform * inverse");
+
+    // Identité et translation entière exactes, layouts concordants
+    const oracle::Ref ref = randomRef(rng, 41, 27, 3);
+    const Image img = toImage(ref, Layout::Interleaved);
+    const Image planar = toImage(ref, Layout::Planar);
+    for (Interpolation interp : INTERPOLATIONS) {
+        const std::string tag = fmt("interpolation %ld", static_cast<int>(interp));
+        check(sameImage(img.warp(Transform(), 41, 27, interp), img), "warp identité, " + tag);
+        const Image moved = img.warp(Transform::translation(-5, -3), 30, 20, interp);
+        bool same = true;
+        for (int y = 0; y < 20; ++y)
+            for (int x = 0; x < 30; ++x)
+                for (int k = 0; k < 3; ++k) same &= moved.at(x, y, k) == img.at(x + 5, y + 3, k);
+        check(same, "warp translation entière, " + tag);
+        const Transform turn = Transform::rotation(0.3, 20, 13);
+        check(sameImage(planar.warp(turn, 41, 27, interp).toLayout(Layout::Interleaved), img.warp(turn, 41, 27, interp)),
+              "warp planaire, " + tag);
+    }
+    // Quart de tour exact : même résultat que rotate90
+    const Transform quarter = Transform::translation(26, 0) * Transform::rotation(std::acos(-1.0) / 2);
+    check(sameImage(img.warp(quarter, 27, 41, Interpolation::Nearest), img.rotate90()), "warp quart de tour");
+}
+
+const Composite COMPOSITES[] = {Composite::Over, Composite::In, Composite::Out, Composite::Atop, Composite::Xor,
+                                Composite::DestOver, Composite::DestIn, Composite::DestOut, Composite::DestAtop};
+
+void compositeKernels(std::mt19937& rng, int rounds) {
+    std::printf("composition (%d tirages)\n", rounds);
+    std::uniform_int_distribution<int> dim(1, 70), pick(0, 8);
+    for (int round = 0; round < rounds; ++round) {
+        const int w = dim(rng), h = dim(rng), sc = round % 2 ? 4 : 2, dc = sc - (round / 2) % 2;
+        const Composite op = COMPOSITES[pick(rng)];
+        TestSurface src = randomSurface(rng, w, h, sc);
+        // Plages de 8 pixels d'alpha 0 ou 255 : raccourcis de Over
+        for (int y = 0; y < h; ++y)
+            for (int x = 0; x < w; ++x) {
+                const int mode = (x / 8 + y * 3 + round) % 3;
+                if (mode) src.data[y * src.stride + static_cast<size_t>(x) * sc + sc - 1] = mode == 1 ? 0 : 255;
+            }
+        TestSurface fast = randomSurface(rng, w, h, dc), ref = fast;
+        kernels::composite(src.in(), fast.out(), op);
+        kernels::compositeScalar(src.in(), ref.out(), op);
+        sameBuffer(fast.data, ref.data,
+                   fmt("composite %ld, %ldx%ld, %ld -> %ld canaux", static_cast<int>(op), w, h, sc, dc));
+    }
+
+    // Vues, copies et mélanges à décalage quelconque
+    const oracle::Ref base = randomRef(rng, 45, 31, 4), over = randomRef(rng, 20, 17, 4);
+    for (Layout layout : LAYOUTS) {
+        const Image img = toImage(base, layout), logo = toImage(over, layout);
+        const ImageView view = img.crop(7, 5, 20, 11);
+        bool same = view.getWidth() == 20 && view.getHeight() == 11;
+        for (int y = 0; y < 11; ++y)
+            for (int x = 0; x < 20; ++x)
+                for (int k = 0; k < 4; ++k) same &= view.at(x, y, k) == img.at(x + 7, y + 5, k);
+        check(same && sameImage(Image(view.crop(2, 3, 4, 5)), Image(img.crop(9, 8, 4, 5))), "crop");
+        bool threw = false;
+        try { img.crop(40, 0, 6, 1); } catch (const std::out_of_range&) { threw = true; }
+        check(threw, "crop hors de l'image");
+
+        // paste à cheval sur le coin haut-gauche, puis sur soi-même avec recouvrement
+        Image pasted = img;
+        pasted.paste(logo, -3, -4);
+        same = true;
+        for (int y = 0; y < 31; ++y)
+            for (int x = 0; x < 45; ++x)
+                for (int k = 0; k < 4; ++k) {
+                    const bool in = x < 17 && y < 13;
+                    same &= pasted.at(x, y, k) == (in ? logo.at(x + 3, y + 4, k) : img.at(x, y, k));
+                }
+        check(same, "paste, décalage négatif");
+        Image shifted = img;
+        shifted.paste(shifted.crop(0, 0, 40, 30), 2, 1);
+        Image expected = img;
+        expected.paste(Image(img.crop(0, 0, 40, 30)), 2, 1);
+        check(sameImage(shifted, expected), "paste sur soi-même");
+
+        // Over : source opaque = paste, transparente = rien ; planaire = entrelacé
+        Image opaque = logo, clear = logo;
+        for (int y = 0; y < 17; ++y)
+            for (int x = 0; x < 20; ++x) opaque.at(x, y, 3) = 255, clear.at(x, y, 3) = 0;
+        Image a = img, b = img, c = img;
+        a.composite(opaque, 30, 20);
+        b.paste(opaque, 30, 20);
+        c.composite(clear, 30, 20);
+        check(sameImage(a, b) && sameImage(c, img), "composite, alpha 0 et 255");
+        for (Composite op : COMPOSITES) {
+            Image mixed = img;
+            mixed.composite(logo, 31, -2, op);
+            Image flat = toImage(base, Layout::Interleaved);
+            flat.composite(toImage(over, Layout::Interleaved), 31, -2, op);
+            check(sameImage(mixed, flat), fmt("composite %ld, layout", static_cast<int>(op)));
+        }
+    }
+
+    // RGBA sur RGB : destination opaque
+    const Image rgba = toImage(over, Layout::Interleaved);
+    Image rgb = toImage(base, Layout::Interleaved).convertTo(ColorModel::RGB), withAlpha = rgb.convertTo(ColorModel::RGBA);
+    rgb.composite(rgba, 5, 6);
+    withAlpha.composite(rgba, 5, 6);
+    check(sameImage(rgb, withAlpha.convertTo(ColorModel::RGB)), "composite RGBA sur RGB");
+
+    // Valeurs calculées à la main : rouge à 50 % (α 128) sur bleu à 50 %.
+    // ws = Fs·αs, wd = Fd·αd (Fs, Fd sur 255), couleur (ws·cs + wd·cd + D/2) / D
+    // avec D = ws + wd, alpha (D + 127) / 255
+    const uint8_t red[4] = {255, 0, 0, 128}, blue[4] = {0, 0, 255, 128}, clearBlue[4] = {0, 0, 255, 0};
+    // 9 pixels identiques : 4 par 4 en SSE2 puis la queue scalaire
+    auto row = [](const uint8_t* px) {
+        std::vector<uint8_t> v;
+        for (int x = 0; x < 9; ++x) v.insert(v.end(), px, px + 4);
+        return Image(9, 1, 4, ColorModel::RGBA, v.data());
+    };
+    const Image redHalf = row(red);
+    const struct {
+        Composite op;
+        const uint8_t* dst;
+        uint8_t expected[4];
+    } pixels[] = {
+        {Composite::Over, blue, {170, 0, 85, 192}},      // ws 32640, wd 16256
+        {Composite::In, blue, {255, 0, 0, 64}},          // ws 16384, wd 0
+        {Composite::Out, blue, {255, 0, 0, 64}},         // ws 16256, wd 0
+        {Composite::Atop, blue, {128, 0, 127, 128}},     // ws 16384, wd 16256
+        {Composite::Xor, blue, {128, 0, 128, 127}},      // ws 16256, wd 16256
+        {Composite::DestOver, blue, {85, 0, 170, 192}},  // ws 16256, wd 32640
+        {Composite::DestIn, blue, {0, 0, 255, 64}},      // ws 0, wd 16384
+        {Composite::DestOut, blue, {0, 0, 255, 64}},     // ws 0, wd 16256
+        {Composite::DestAtop, blue, {127, 0, 128, 128}}, // ws 16256, wd 16384
+        {Composite::In, clearBlue, {0, 0, 255, 0}},      // D = 0 : couleur inchangée
+    };
+    for (const auto& p : pixels) {
+        Image out = row(p.dst);
+        out.composite(redHalf, 0, 0, p.op);
+        bool same = true;
+        for (int x = 0; x < 9; ++x)
+            for (int k = 0; k < 4; ++k) same &= out.at(x, 0, k) == p.expected[k];
+        check(same, fmt("composite %ld, rouge 50 %% sur bleu 50 %% (alpha %ld)", static_cast<int>(p.op), p.dst[3]));
+    }
+}
+
+void blendKernels(std::mt19937& rng, int rounds) {
+    std::printf("combinaisons linéaires (%d tirages)\n", rounds);
+    std::uniform_int_distribution<int> dim(1, 60), count(1, 5), chans(1, 4);
+    std::uniform_real_distribution<double> weight(-1.5, 1.5), offset(-120, 120);
+    for (int round = 0; round < rounds; ++round) {
+        const int w = dim(rng), h = dim(rng), c = chans(rng), n = count(rng);
+        // Sources plus petites que dst une fois sur deux : 0 au-delà de leurs bords
+        std::vector<TestSurface> src;
+        std::vector<kernels::ConstSurface> in;
+        std::vector<double> weights;
+        for (int k = 0; k < n; ++k) {
+            const bool smaller = rng() % 2;
+            src.push_back(randomSurface(rng, smaller ? 1 + rng() % w : w, smaller ? 1 + rng() % h : h, c));
+            weights.push_back(round % 4 ? weight(rng) : 1.0 / n);
+        }
+        for (const TestSurface& s : src) in.push_back(s.in());
+        const double bias = round % 3 ? offset(rng) : 0.0;
+        TestSurface fast(w, h, c, rng() % 5), ref = fast;
+        kernels::linearCombination(in.data(), weights.data(), n, bias, fast.out());
+        kernels::linearCombinationScalar(in.data(), weights.data(), n, bias, ref.out());
+        if (!sameBuffer(fast.data, ref.data, fmt("combinaison de %ld, %ldx%ldx%ld", n, w, h, c))) continue;
+        // À un près du calcul en double (poids quantifiés)
+        bool near = true;
+        for (int y = 0; y < h; ++y)
+            for (int x = 0; x < w; ++x)
+                for (int k = 0; k < c; ++k) {
+                    double sum = bias;
+                    for (int i = 0; i < n; ++i)
+                        if (x < src[i].w && y < src[i].h) sum += weights[i] * src[i].at(x, y, k);
+                    near &= std::fabs(fast.at(x, y, k) - std::clamp(sum, 0.0, 255.0)) <= 1.0;
+                }
+        check(near, fmt("combinaison de %ld, écart au double", n));
+    }
+
+    // Poids entiers : mêmes résultats que +, - et leur agrandissement à 0
+    const oracle::Ref ra = randomRef(rng, 37, 21, 3), rb = randomRef(rng, 25, 30, 3);
+    for (Layout la : LAYOUTS)
+        for (Layout lb : LAYOUTS) {
+            const Image a = toImage(ra, la), b = toImage(rb, lb);
+            const std::string tag = std::string(" ") + layoutName(la) + "/" + layoutName(lb);
+            check(sameImage(Image::addWeighted(a, 1, b, 1), a + b), "addWeighted 1, 1" + tag);
+            check(sameImage(Image::addWeighted(a, 1, b, -1), a - b), "addWeighted 1, -1" + tag);
+            check(sameImage(Image::linearCombination({a}, {1.0}, 40), a + 40), "linearCombination, décalage" + tag);
+            const Image mix = Image::addWeighted(a, 0.3, b, 0.7);
+            check(mix.getWidth() == 37 && mix.getHeight() == 30 && mix.getLayout() == la, "addWeighted, taille" + tag);
+        }
+    // Fondu : entrées égales inchangées quel que soit t
+    const Image img = toImage(ra, Layout::Interleaved);
+    bool kept = true;
+    for (double t = 0; t <= 1; t += 0.0625) kept &= sameImage(Image::addWeighted(img, 1 - t, img, t), img);
+    check(kept, "fondu d'une image sur elle-même");
+    const Image gray = img.convertTo(ColorModel::GRAY);
+    bool threw = false;
+    try {
+        Image::linearCombination({img, gray}, {0.5, 0.5});
+    } catch (const std::invalid_argument&) {
+        threw = true;
+    }
+    check(threw, "linearCombination, modèles différents");
+
+    // Pipeline blend : T seulement si le suffixe est numérique, opérande GRAY
+    // converti vers le modèle de l'image (une fois, puis réutilisé)
+    const fs::path dir = fs::temp_directory_path() / fs::path("oracle:" + std::to_string(rng()));
+    fs::create_directories(dir);
+    const std::string file = (dir / "gray.png").string();
+    gray.save(file.c_str());
+    const Image operand = Image::load(file.c_str()).convertTo(img.getModel());
+    for (const auto& [arg, t] : {std::pair<std::string, double>{"@" + file, 0.5}, {"@" + file + ":0.25", 0.25}}) {
+        Pipeline p;
+        p.add("blend", arg);
+        const Image expected = Image::addWeighted(img, 1 - t, operand, t);
+        check(sameImage(p.run(img), expected) && sameImage(p.run(img), expected), "Pipeline blend " + arg);
+    }
+    fs::remove_all(dir);
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    unsigned seed = 20240601;
+    int rounds = 300;
+    for (int i = 1; i < argc; ++i) {
+        std::string a = argv[i];
+        if (a == "--seed" && i + 1 < argc) seed = static_cast<unsigned>(std::stoul(argv[++i]));
+        else if (a == "--rounds" && i + 1 < argc) rounds = std::stoi(argv[++i]);
+        else {
+            std::fprintf(stderr, "Usage : test_oracle [--seed N] [--rounds N]\n");
+            return 2;
+        }
+    }
+    std::mt19937 rng(seed);
+    // Plusieurs threads même sur une machine à un cœur : découpage en bandes exercé
+    parallel::setThreadCount(4);
+    try {
+        exhaustivePairs();
+        randomImages(rng, rounds);
+        thresholdKernels(rng);
+        colorKernels();
+        convolutionKernels(rng, rounds);
+        blurKernels(rng, rounds);
+        rankKernels(rng, rounds);
+        morphologyKernels(rng, rounds);
+        resizeKernels(rng, rounds);
+        pyramidKernels(rng, rounds);
+        orientationKernels(rng, rounds);
+        warpKernels(rng, rounds);
+        compositeKernels(rng, rounds);
+        blendKernels(rng, rounds);
+    } catch (const std::exception& e) {
+        std::printf("  EXCEPTION %s\n", e.what());
+        ++g_failures;
+    }
+    std::printf("%d vérifications, %d échec(s) (graine %u)\n", g_checks, g_failures, seed);
+    return g_failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,417 @@
+#include "Pipeline.h"
+#include <algorithm>
+#include <array>
+#include <cctype>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <filesystem>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+
+#if __has_include(<glob.h>)
+#include <glob.h>
+#define PIPELINE_HAVE_GLOB 1
+#endif
+
+namespace fs = std::filesystem;
+
+namespace {
+
+std::string lower(std::string s) {
+    std::transform(s.begin(), s.end(), s.begin(), [](unsigned char c) { return std::tolower(c); });
+    return s;
+}
+
+// Entier complet (pas de caractères en trop), sinon std::invalid_argument
+long parseInt(const std::string& s, const std::string& op) {
+    size_t used = 0;
+    long v = 0;
+    try { v = std::stol(s, &used); } catch (const std::exception&) { used = 0; }
+    if (used == 0 || used != s.size()) throw std::invalid_argument(op + ": expected an integer, got '" + s + "'");
+    return v;
+}
+
+double parseDouble(const std::string& s, const std::string& op) {
+    size_t used = 0;
+    double v = 0;
+    try { v = std::stod(s, &used); } catch (const std::exception&) { used = 0; }
+    if (used == 0 || used != s.size() || !std::isfinite(v))
+        throw std::invalid_argument(op + ": expected a number, got '" + s + "'");
+    return v;
+}
+
+// Bornes des paramètres : une requête imgopd non fiable ne doit ni déborder un
+// int ni réclamer une allocation ou un temps de calcul démesurés
+constexpr long maxRadius = 1024;
+constexpr double maxSigma = 256;
+constexpr long maxDimension = 32768;
+constexpr long long maxPixels = 1LL << 28;
+
+long parseRadius(const std::string& s, const std::string& op) {
+    const long r = parseInt(s, op);
+    if (r < 0 || r > maxRadius)
+        throw std::invalid_argument(op + ": radius must be in [0, " + std::to_string(maxRadius) + "]: " + s);
+    return r;
+}
+
+double parseSigma(const std::string& s, const std::string& op) {
+    const double v = parseDouble(s, op);
+    if (!(v > 0 && v <= maxSigma))
+        throw std::invalid_argument(op + ": sigma must be in ]0, " + std::to_string(static_cast<int>(maxSigma)) +
+                                    "]: " + s);
+    return v;
+}
+
+void checkSize(long w, long h, const std::string& op) {
+    if (w > maxDimension || h > maxDimension || static_cast<long long>(w) * h > maxPixels)
+        throw std::invalid_argument(op + ": output too large (" + std::to_string(w) + "x" + std::to_string(h) + ")");
+}
+
+uint8_t parseByte(const std::string& s, const std::string& op) {
+    long v = parseInt(s, op);
+    if (v < 0 || v > 255) throw std::invalid_argument(op + ": value out of [0, 255]: " + s);
+    return static_cast<uint8_t>(v);
+}
+
+ColorModel parseModel(const std::string& s) {
+    const std::string m = lower(s);
+    if (m == "gray") return ColorModel::GRAY;
+    if (m == "graya") return ColorModel::GRAYA;
+    if (m == "rgb") return ColorModel::RGB;
+    if (m == "rgba") return ColorModel::RGBA;
+    if (m == "yuv") return ColorModel::YUV;
+    if (m == "hsv") return ColorModel::HSV;
+    throw std::invalid_argument("convert: unknown model '" + s + "'");
+}
+
+ResizeFilter parseFilter(const std::string& s) {
+    const std::string f = lower(s);
+    if (f == "nearest") return ResizeFilter::Nearest;
+    if (f == "bilinear") return ResizeFilter::Bilinear;
+    if (f == "bicubic") return ResizeFilter::Bicubic;
+    if (f == "lanczos") return ResizeFilter::Lanczos3;
+    if (f == "area") return ResizeFilter::Area;
+    throw std::invalid_argument("resize: unknown filter '" + s + "'");
+}
+
+// resize "WxH[:filtre]" ; une dimension à 0 suit le rapport d'aspect
+std::function<void(Image&)> resize(const std::string& arg) {
+    const size_t colon = arg.find(':'), x = arg.find('x');
+    if (x == std::string::npos || x > colon) throw std::invalid_argument("resize: expected WxH[:filter], got '" + arg + "'");
+    const long w = parseInt(arg.substr(0, x), "resize"), h = parseInt(arg.substr(x + 1, colon - x - 1), "resize");
+    if (w < 0 || h < 0 || (w == 0 && h == 0)) throw std::invalid_argument("resize: invalid size '" + arg + "'");
+    checkSize(w, h, "resize");
+    const ResizeFilter filter = colon == std::string::npos ? ResizeFilter::Bilinear : parseFilter(arg.substr(colon + 1));
+    return [w, h, filter](Image& img) {
+        const int iw = img.getWidth(), ih = img.getHeight();
+        const long nw = w ? w : std::max(1L, (h * iw + ih / 2) / std::max(ih, 1));
+        const long nh = h ? h : std::max(1L, (w * ih + iw / 2) / std::max(iw, 1));
+        checkSize(nw, nh, "resize");
+        img = img.resize(static_cast<int>(nw), static_cast<int>(nh), filter);
+    };
+}
+
+// rotate DEG hors quarts de tour : déformation autour du centre, même taille,
+// sens horaire, coins complétés par répétition du bord
+std::function<void(Image&)> rotate(double degrees) {
+    const double angle = degrees * std::acos(-1.0) / 180;
+    return [angle](Image& img) {
+        const int w = img.getWidth(), h = img.getHeight();
+        img = img.warp(Transform::rotation(angle, (w - 1) / 2.0, (h - 1) / 2.0), w, h, Interpolation::Bilinear,
+                       Border::Replicate);
+    };
+}
+
+// perspective "x0,y0,x1,y1,x2,y2,x3,y3[:WxH]" : coins source haut-gauche,
+// haut-droit, bas-droit, bas-gauche envoyés sur ceux de la sortie (taille de
+// l'entrée par défaut)
+std::function<void(Image&)> perspective(const std::string& arg) {
+    const size_t colon = arg.find(':');
+    const std::string list = arg.substr(0, colon);
+    std::vector<double> v;
+    size_t start = 0;
+    for (;;) {
+        const size_t comma = list.find(',', start);
+        v.push_back(parseDouble(list.substr(start, comma - start), "perspective"));
+        if (comma == std::string::npos) break;
+        start = comma + 1;
+    }
+    if (v.size() != 8) throw std::invalid_argument("perspective: expected 8 coordinates, got '" + arg + "'");
+    long w = 0, h = 0;
+    if (colon != std::string::npos) {
+        const std::string size = arg.substr(colon + 1);
+        const size_t x = size.find('x');
+        if (x == std::string::npos) throw std::invalid_argument("perspective: expected WxH, got '" + size + "'");
+        w = parseInt(size.substr(0, x), "perspective"), h = parseInt(size.substr(x + 1), "perspective");
+        if (w <= 0 || h <= 0) throw std::invalid_argument("perspective: invalid size '" + size + "'");
+        checkSize(w, h, "perspective");
+    }
+    const std::array<Transform::Point, 4> from = {{{v[0], v[1]}, {v[2], v[3]}, {v[4], v[5]}, {v[6], v[7]}}};
+    return [from, w, h](Image& img) {
+        const int ow = w ? static_cast<int>(w) : img.getWidth(), oh = h ? static_cast<int>(h) : img.getHeight();
+        const std::array<Transform::Point, 4> to = {{{0, 0}, {ow - 1.0, 0}, {ow - 1.0, oh - 1.0}, {0, oh - 1.0}}};
+        img = img.warp(Transform::perspective(from, to), ow, oh, Interpolation::Bilinear, Border::Replicate);
+    };
+}
+
+// Opérande "@fichier" : chargé une fois, converti au plus une fois par modèle
+// (GRAY contre RGB...). Les pipelines en cache d'imgopd sont partagés entre
+// connexions : conversions sous mutex, jamais retirées (références stables)
+class Operand {
+public:
+    explicit Operand(const std::string& path) : image(Image::load(path.c_str())) {}
+
+    const Image& as(ColorModel m) {
+        if (image.getModel() == m || m == ColorModel::NONE || image.getModel() == ColorModel::NONE) return image;
+        std::lock_guard<std::mutex> lock(mutex);
+        std::unique_ptr<const Image>& converted = conversions[m];
+        if (!converted) converted = std::make_unique<const Image>(image.convertTo(m));
+        return *converted;
+    }
+
+private:
+    const Image image;
+    std::mutex mutex;
+    std::map<ColorModel, std::unique_ptr<const Image>> conversions;
+};
+
+// blend "@fichier[:T]" : fondu (1 - T)·image + T·opérande, T = 0.5 par défaut.
+// Le suffixe après le dernier ':' n'est T que s'il est numérique :
+// "@dir:nom/x.png" reste un chemin
+std::function<void(Image&)> blend(const std::string& arg) {
+    if (arg.empty() || arg[0] != '@') throw std::invalid_argument("blend: expected @image[:T], got '" + arg + "'");
+    const size_t colon = arg.rfind(':');
+    double t = 0.5;
+    std::string path = arg.substr(1);
+    if (colon != std::string::npos && colon > 1) {
+        const std::string suffix = arg.substr(colon + 1);
+        size_t used = 0;
+        try { std::stod(suffix, &used); } catch (const std::exception&) { used = 0; }
+        if (used != 0 && used == suffix.size()) {
+            t = parseDouble(suffix, "blend");
+            path = arg.substr(1, colon - 1);
+        }
+    }
+    auto operand = std::make_shared<Operand>(path);
+    return [operand, t](Image& img) { img = Image::addWeighted(img, 1 - t, operand->as(img.getModel()), t); };
+}
+
+// add / sub / diff : scalaire, pixel "R,G,B" ou image "@fichier"
+template <typename WithInt, typename WithPixel, typename WithImage>
+std::function<void(Image&)> arithmetic(const std::string& op, const std::string& arg, WithInt withInt,
+                                       WithPixel withPixel, WithImage withImage) {
+    if (!arg.empty() && arg[0] == '@') {
+        auto operand = std::make_shared<Operand>(arg.substr(1));
+        return [operand, withImage](Image& img) { withImage(img, operand->as(img.getModel())); };
+    }
+    if (arg.find(',') != std::string::npos) {
+        std::vector<uint8_t> pixel;
+        size_t start = 0;
+        for (;;) {
+            size_t comma = arg.find(',', start);
+            pixel.push_back(parseByte(arg.substr(start, comma - start), op));
+            if (comma == std::string::npos) break;
+            start = comma + 1;
+        }
+        return [pixel, withPixel](Image& img) { withPixel(img, pixel); };
+    }
+    const int value = static_cast<int>(parseInt(arg, op));
+    return [value, withInt](Image& img) { withInt(img, value); };
+}
+
+std::function<void(Image&)> threshold(const std::string& arg) {
+    size_t n = 0;
+    while (n < arg.size() && std::strchr("<>=!", arg[n])) ++n;
+    const std::string cmp = arg.substr(0, n);
+    const uint8_t t = parseByte(arg.substr(n), "threshold");
+    Mask (*apply)(const Image&, uint8_t) = nullptr;
+    if (cmp == "<") apply = [](const Image& i, uint8_t v) { return i < v; };
+    else if (cmp == "<=") apply = [](const Image& i, uint8_t v) { return i <= v; };
+    else if (cmp == ">") apply = [](const Image& i, uint8_t v) { return i > v; };
+    else if (cmp == ">=") apply = [](const Image& i, uint8_t v) { return i >= v; };
+    else if (cmp == "==" || cmp == "=") apply = [](const Image& i, uint8_t v) { return i == v; };
+    else if (cmp == "!=") apply = [](const Image& i, uint8_t v) { return i != v; };
+    else throw std::invalid_argument("threshold: expected <, <=, >, >=, == or != before the value, got '" + arg + "'");
+    return [apply, t](Image& img) { img = Image(apply(img, t)); };
+}
+
+} // namespace
+
+int Pipeline::arity(const std::string& op) {
+    if (op == "invert" || op == "transpose") return 0;
+    if (op == "add" || op == "sub" || op == "diff" || op == "mul" || op == "div" || op == "threshold" ||
+        op == "convert" || op == "layout" || op == "blur" || op == "sharpen" ||
+        op == "boxblur" || op == "fastblur" || op == "median" ||
+        op == "erode" || op == "dilate" || op == "open" || op == "close" || op == "resize" ||
+        op == "rotate" || op == "flip" || op == "perspective" || op == "blend")
+        return 1;
+    return -1;
+}
+
+void Pipeline::add(const std::string& op, const std::string& arg) {
+    const int n = arity(op);
+    if (n < 0) throw std::invalid_argument("Unknown operator: " + op);
+    if (n == 1 && arg.empty()) throw std::invalid_argument("Missing value for " + op);
+
+    Step step;
+    step.name = n ? op + " " + arg : op;
+    if (op == "add") {
+        step.apply = arithmetic(op, arg, [](Image& i, int v) { i += v; },
+                                [](Image& i, const std::vector<uint8_t>& p) { i += p; },
+                                [](Image& i, const Image& o) { i += o; });
+    } else if (op == "sub") {
+        step.apply = arithmetic(op, arg, [](Image& i, int v) { i -= v; },
+                                [](Image& i, const std::vector<uint8_t>& p) { i -= p; },
+                                [](Image& i, const Image& o) { i -= o; });
+    } else if (op == "diff") {
+        step.apply = arithmetic(op, arg, [](Image& i, int v) { i ^= v; },
+                                [](Image& i, const std::vector<uint8_t>& p) { i ^= p; },
+                                [](Image& i, const Image& o) { i ^= o; });
+    } else if (op == "mul") {
+        const double f = parseDouble(arg, op);
+        step.apply = [f](Image& i) { i *= f; };
+    } else if (op == "div") {
+        const double f = parseDouble(arg, op);
+        if (f == 0.0) throw std::invalid_argument("div: division by zero");
+        step.apply = [f](Image& i) { i /= f; };
+    } else if (op == "invert") {
+        step.apply = [](Image& i) { i = ~i; };
+    } else if (op == "threshold") {
+        step.apply = threshold(arg);
+    } else if (op == "convert") {
+        const size_t colon = arg.find(':');
+        const ColorModel model = parseModel(arg.substr(0, colon));
+        LumaStandard standard = LumaStandard::BT601;
+        if (colon != std::string::npos) {
+            const std::string s = lower(arg.substr(colon + 1));
+            if (s == "bt709") standard = LumaStandard::BT709;
+            else if (s != "bt601") throw std::invalid_argument("convert: unknown luma standard '" + s + "'");
+        }
+        step.apply = [model, standard](Image& i) { i = i.convertTo(model, standard); };
+    } else if (op == "blur" || op == "sharpen") {
+        const double v = op == "blur" ? parseSigma(arg, op) : parseDouble(arg, op);
+        const Kernel k = op == "blur" ? Kernel::gaussian(v) : Kernel::sharpen(v);
+        step.apply = [k](Image& i) { i = i.convolve(k); };
+    } else if (op == "boxblur") {
+        const long r = parseRadius(arg, op);
+        step.apply = [r](Image& i) { i.boxBlur(static_cast<int>(r)); };
+    } else if (op == "fastblur") {
+        const double sigma = parseSigma(arg, op);
+        step.apply = [sigma](Image& i) { i.gaussianBlur(sigma); };
+    } else if (op == "median") {
+        const long r = parseRadius(arg, op);
+        step.apply = [r](Image& i) { i = i.median(static_cast<int>(r)); };
+    } else if (op == "resize") {
+        step.apply = resize(arg);
+    } else if (op == "rotate" || op == "flip" || op == "transpose") {
+        Orientation o = Orientation::Transpose;
+        const std::string a = lower(arg);
+        double degrees = 0;
+        if (op == "rotate") {
+            // Angle ramené dans [0, 360) : tout multiple de 90 ("90.0", "450",
+            // "-270"...) prend le quart de tour exact, sans rééchantillonnage
+            degrees = std::fmod(parseDouble(arg, op), 360.0);
+            if (degrees < 0) degrees += 360;
+            if (degrees == 360) degrees = 0;  // -1e-20 + 360 arrondi
+            if (degrees == 90) o = Orientation::Rotate90;
+            else if (degrees == 180) o = Orientation::Rotate180;
+            else if (degrees == 270) o = Orientation::Rotate270;
+            else o = Orientation::Normal;  // 0 ou angle quelconque
+        } else if (op == "flip") {
+            if (a == "h" || a == "horizontal") o = Orientation::FlipHorizontal;
+            else if (a == "v" || a == "vertical") o = Orientation::FlipVertical;
+            else throw std::invalid_argument("flip: expected h or v, got '" + arg + "'");
+        }
+        if (o != Orientation::Normal) step.apply = [o](Image& i) { i.orient(o); };
+        else if (degrees != 0) step.apply = rotate(degrees);
+        else step.apply = [](Image&) {};
+    } else if (op == "perspective") {
+        step.apply = perspective(arg);
+    } else if (op == "blend") {
+        step.apply = blend(arg);
+    } else if (op == "erode" || op == "dilate" || op == "open" || op == "close") {
+        const long r = parseRadius(arg, op);
+        const StructuringElement se = StructuringElement::square(static_cast<int>(r));
+        if (op == "erode") step.apply = [se](Image& i) { i = i.erode(se); };
+        else if (op == "dilate") step.apply = [se](Image& i) { i = i.dilate(se); };
+        else if (op == "open") step.apply = [se](Image& i) { i = i.open(se); };
+        else step.apply = [se](Image& i) { i = i.close(se); };
+    } else {
+        const std::string l = lower(arg);
+        if (l != "planar" && l != "interleaved") throw std::invalid_argument("layout: expected planar or interleaved");
+        const Layout layout = l == "planar" ? Layout::Planar : Layout::Interleaved;
+        step.apply = [layout](Image& i) { if (i.getLayout() != layout) i = i.toLayout(layout); };
+    }
+    steps.push_back(std::move(step));
+}
+
+Pipeline Pipeline::parse(const std::vector<std::string>& tokens) {
+    Pipeline p;
+    for (size_t i = 0; i < tokens.size(); ++i) {
+        std::string op = tokens[i];
+        op.erase(0, op.find_first_not_of('-'));
+        const int n = arity(op);
+        if (n < 0) throw std::invalid_argument("Unknown operator: " + tokens[i]);
+        if (n == 1 && i + 1 >= tokens.size()) throw std::invalid_argument("Missing value for " + tokens[i]);
+        p.add(op, n ? tokens[++i] : "");
+    }
+    return p;
+}
+
+Image Pipeline::run(Image img, std::vector<double>* stepSeconds) const {
+    if (stepSeconds && stepSeconds->size() < steps.size()) stepSeconds->resize(steps.size(), 0.0);
+    for (size_t i = 0; i < steps.size(); ++i) {
+        if (!stepSeconds) {
+            steps[i].apply(img);
+            continue;
+        }
+        auto t0 = std::chrono::steady_clock::now();
+        steps[i].apply(img);
+        (*stepSeconds)[i] += std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+    }
+    return img;
+}
+
+// === ENTRÉES ===
+bool isImageFile(const std::string& path) {
+    const std::string ext = lower(fs::path(path).extension().string());
+    return ext == ".png" || ext == ".jpg" || ext == ".jpeg" || ext == ".bmp" || ext == ".tga" ||
+           ext == ".gif" || ext == ".psd" || ext == ".pnm" || ext == ".ppm" || ext == ".pgm";
+}
+
+std::vector<std::string> expandInputs(const std::vector<std::string>& inputs) {
+    std::vector<std::string> files;
+    auto addPath = [&](const std::string& in) {
+        const fs::path p(in);
+        if (fs::is_directory(p)) {
+            for (const auto& e : fs::recursive_directory_iterator(p))
+                if (e.is_regular_file() && isImageFile(e.path().string())) files.push_back(e.path().string());
+        } else if (fs::is_regular_file(p)) {
+            files.push_back(in);
+        } else {
+            return false;
+        }
+        return true;
+    };
+    for (const std::string& in : inputs) {
+        if (addPath(in)) continue;
+#ifdef PIPELINE_HAVE_GLOB
+        // Motif non développé par le shell (entre guillemets)
+        if (in.find_first_of("*?[") != std::string::npos) {
+            glob_t g;
+            const int rc = ::glob(in.c_str(), 0, nullptr, &g);
+            if (rc == 0)
+                for (size_t i = 0; i < g.gl_pathc; ++i) addPath(g.gl_pathv[i]);
+            globfree(&g);
+            if (rc == 0 || rc == GLOB_NOMATCH) continue;
+        }
+#endif
+        throw std::invalid_argument("No such file or directory: " + in);
+    }
+    std::sort(files.begin(), files.end());
+    files.erase(std::unique(files.begin(), files.end()), files.end());
+    return files;
+}
@@ -0,0 +1,67 @@
+#ifndef PIPELINE_H
+#define PIPELINE_H
+
+#include "../Image.h"
+#include <functional>
+#include <string>
+#include <vector>
+
+// Chaîne d'opérateurs de Image décrite en texte, partagée par les outils
+// (imgop, imgopd). Chaque étape est un nom d'opérateur et au plus un argument :
+//
+//   add V | add R,G,B | add @image.png     (idem sub, diff)
+//   blend @image.png[:T]                   (fondu (1 - T)·image + T·opérande, un seul arrondi)
+//   mul F | div F | invert
+//   threshold ">120"                       (<, <=, >, >=, ==, != ; résultat GRAY 0/255)
+//   convert gray|graya|rgb|rgba|yuv|hsv[:bt709]
+//   layout planar|interleaved
+//   blur SIGMA | sharpen AMOUNT            (convolution, bords répliqués)
+//   boxblur R | fastblur SIGMA             (sommes glissantes, coût indépendant du rayon)
+//   median R                               (fenêtre (2R+1)², bruit poivre et sel)
+//   erode R | dilate R | open R | close R  (carré (2R+1)², après threshold)
+//   resize WxH[:nearest|bilinear|bicubic|lanczos|area]  (0 : rapport d'aspect conservé)
+//   rotate 90|180|270 | flip h|v | transpose  (en place si possible)
+//   rotate DEG                             (modulo 360 ; multiple de 90 : quart de tour exact, sinon sens
+//                                          horaire, déformation bilinéaire, même taille)
+//   perspective x0,y0,...,x3,y3[:WxH]      (coins source HG, HD, BD, BG redressés en rectangle)
+//
+// Paramètres bornés, les jetons pouvant venir d'un client non fiable (imgopd) :
+// rayons <= 1024, sigma <= 256, sorties (resize, perspective) <= 32768 de côté
+// et 2^28 pixels, nombres finis ; std::invalid_argument au-delà.
+// Un opérande image d'un autre modèle est converti dans celui de l'image traitée.
+// Les étapes s'appliquent dans l'ordre, en place (opérateurs composés) pour
+// éviter une copie par étape. Les opérandes image (@fichier) sont chargés une
+// fois à la construction puis partagés en lecture seule : un Pipeline construit
+// peut être exécuté par plusieurs threads à la fois.
+class Pipeline {
+public:
+    // Nombre d'arguments de l'opérateur (0 ou 1), -1 s'il n'existe pas
+    static int arity(const std::string& op);
+
+    // Ajoute une étape ; std::invalid_argument si l'opérateur ou l'argument est invalide
+    void add(const std::string& op, const std::string& arg = "");
+
+    // Construit depuis une suite de jetons "op [arg] op [arg]..." (tirets initiaux ignorés)
+    static Pipeline parse(const std::vector<std::string>& tokens);
+
+    // Applique les étapes ; stepSeconds (optionnel) cumule le temps de chaque étape
+    Image run(Image img, std::vector<double>* stepSeconds = nullptr) const;
+
+    size_t size() const { return steps.size(); }
+    const std::string& name(size_t i) const { return steps[i].name; }
+
+private:
+    struct Step {
+        std::string name;  // "add 60", "threshold >120"...
+        std::function<void(Image&)> apply;
+    };
+    std::vector<Step> steps;
+};
+
+// Fichiers images désignés par des chemins, dossiers (parcourus récursivement)
+// ou motifs glob ; triés, sans doublon. std::invalid_argument si un chemin n'existe pas.
+std::vector<std::string> expandInputs(const std::vector<std::string>& inputs);
+
+bool isImageFile(const std::string& path);
+
+#endif
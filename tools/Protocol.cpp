@@ -0,0 +1,212 @@
+#include "Protocol.h"
+#include <algorithm>
+#include <cctype>
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+namespace protocol {
+
+namespace {
+
+std::runtime_error systemError(const std::string& what) {
+    const int err = errno;
+    return std::runtime_error(what + ": " + std::strerror(err));
+}
+
+// Lit exactement size octets ; renvoie le nombre lu (< size seulement si fin de flux)
+size_t readFully(int fd, void* buffer, size_t size) {
+    uint8_t* p = static_cast<uint8_t*>(buffer);
+    size_t done = 0;
+    while (done < size) {
+        const ssize_t n = ::read(fd, p + done, size - done);
+        if (n == 0) break;
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            throw systemError("read");
+        }
+        done += static_cast<size_t>(n);
+    }
+    return done;
+}
+
+void readExact(int fd, void* buffer, size_t size) {
+    if (readFully(fd, buffer, size) != size) throw std::runtime_error("connection closed mid-message");
+}
+
+void writeFully(int fd, const void* buffer, size_t size) {
+    const uint8_t* p = static_cast<const uint8_t*>(buffer);
+    while (size > 0) {
+        // MSG_NOSIGNAL : un client parti donne EPIPE plutôt que SIGPIPE
+        const ssize_t n = ::send(fd, p, size, MSG_NOSIGNAL);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            throw systemError("write");
+        }
+        p += n;
+        size -= static_cast<size_t>(n);
+    }
+}
+
+void putU32(std::vector<uint8_t>& out, uint32_t v) {
+    for (int i = 0; i < 4; ++i) out.push_back(static_cast<uint8_t>(v >> (8 * i)));
+}
+
+uint32_t getU32(const uint8_t* p) {
+    return uint32_t(p[0]) | uint32_t(p[1]) << 8 | uint32_t(p[2]) << 16 | uint32_t(p[3]) << 24;
+}
+
+uint32_t readU32(int fd) {
+    uint8_t b[4];
+    readExact(fd, b, 4);
+    return getU32(b);
+}
+
+uint32_t checkedU32(size_t v) {
+    if (v > UINT32_MAX) throw std::invalid_argument("message larger than 4 GiB");
+    return static_cast<uint32_t>(v);
+}
+
+sockaddr_un address(const std::string& path) {
+    sockaddr_un addr{};
+    addr.sun_family = AF_UNIX;
+    if (path.empty() || path.size() >= sizeof(addr.sun_path))
+        throw std::invalid_argument("Invalid socket path: " + path);
+    std::memcpy(addr.sun_path, path.c_str(), path.size() + 1);
+    return addr;
+}
+
+} // namespace
+
+// === REQUÊTES ===
+bool readRequest(int fd, Request& req, size_t maxBytes) {
+    uint8_t b[8];
+    const size_t n = readFully(fd, b, 8);
+    if (n == 0) return false;
+    if (n != 8) throw std::runtime_error("connection closed mid-message");
+    if (getU32(b) != magic) throw std::runtime_error("bad magic (not an imgopd client?)");
+
+    const uint32_t argsLen = getU32(b + 4);
+    if (argsLen > maxBytes) throw std::length_error("request too large");
+    std::string args(argsLen, '\0');
+    readExact(fd, args.data(), argsLen);
+    req.args.clear();
+    for (size_t start = 0; start < args.size();) {
+        size_t end = args.find('\0', start);
+        if (end == std::string::npos) end = args.size();
+        req.args.emplace_back(args, start, end - start);
+        start = end + 1;
+    }
+
+    const uint32_t dataLen = readU32(fd);
+    if (static_cast<size_t>(argsLen) + dataLen > maxBytes) throw std::length_error("request too large");
+    req.data.resize(dataLen);
+    readExact(fd, req.data.data(), dataLen);
+    return true;
+}
+
+void writeRequest(int fd, const std::vector<std::string>& args, const uint8_t* data, size_t size) {
+    std::vector<uint8_t> head;
+    putU32(head, magic);
+    size_t argsLen = 0;
+    for (const std::string& a : args) argsLen += a.size() + 1;
+    putU32(head, checkedU32(argsLen));
+    for (const std::string& a : args) {
+        head.insert(head.end(), a.begin(), a.end());
+        head.push_back(0);
+    }
+    putU32(head, checkedU32(size));
+    writeFully(fd, head.data(), head.size());
+    writeFully(fd, data, size);
+}
+
+// === RÉPONSES ===
+bool readResponse(int fd, Response& res) {
+    uint8_t b[20];
+    const size_t n = readFully(fd, b, sizeof(b));
+    if (n == 0) return false;
+    if (n != sizeof(b)) throw std::runtime_error("connection closed mid-message");
+    res.status = getU32(b);
+    res.width = getU32(b + 4);
+    res.height = getU32(b + 8);
+    res.channels = getU32(b + 12);
+    res.payload.resize(getU32(b + 16));
+    readExact(fd, res.payload.data(), res.payload.size());
+    return true;
+}
+
+void writeResponse(int fd, const Response& res) {
+    std::vector<uint8_t> head;
+    putU32(head, res.status);
+    putU32(head, res.width);
+    putU32(head, res.height);
+    putU32(head, res.channels);
+    putU32(head, checkedU32(res.payload.size()));
+    writeFully(fd, head.data(), head.size());
+    writeFully(fd, res.payload.data(), res.payload.size());
+}
+
+void parseFormat(const std::string& s, FileFormat& format, int& quality) {
+    const size_t colon = s.find(':');
+    std::string name = s.substr(0, colon);
+    std::transform(name.begin(), name.end(), name.begin(), [](unsigned char c) { return std::tolower(c); });
+    if (name == "png") format = FileFormat::PNG;
+    else if (name == "bmp") format = FileFormat::BMP;
+    else if (name == "tga") format = FileFormat::TGA;
+    else if (name == "jpg" || name == "jpeg") format = FileFormat::JPEG;
+    else throw std::invalid_argument("Unknown output format: " + s);
+    if (colon == std::string::npos) return;
+    if (format != FileFormat::JPEG) throw std::invalid_argument("Quality only applies to jpg: " + s);
+    size_t used = 0;
+    try { quality = std::stoi(s.substr(colon + 1), &used); } catch (const std::exception&) { used = 0; }
+    if (used == 0 || colon + 1 + used != s.size() || quality < 1 || quality > 100)
+        throw std::invalid_argument("jpg quality must be in [1, 100]: " + s);
+}
+
+// === SOCKETS ===
+int listenUnix(const std::string& path, int backlog) {
+    const sockaddr_un addr = address(path);
+    const int fd = ::socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (fd < 0) throw systemError("socket");
+    // Seule une socket abandonnée est remplacée : ni un fichier ordinaire, ni
+    // la socket d'un démon qui répond encore
+    struct stat st;
+    if (::lstat(path.c_str(), &st) == 0) {
+        if (!S_ISSOCK(st.st_mode)) {
+            ::close(fd);
+            throw std::runtime_error(path + ": exists and is not a socket");
+        }
+        const int probe = ::socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+        const bool live = probe >= 0 && ::connect(probe, reinterpret_cast<const sockaddr*>(&addr), sizeof(addr)) == 0;
+        if (probe >= 0) ::close(probe);
+        if (live) {
+            ::close(fd);
+            throw std::runtime_error(path + ": a server is already listening");
+        }
+        ::unlink(path.c_str());
+    }
+    if (::bind(fd, reinterpret_cast<const sockaddr*>(&addr), sizeof(addr)) < 0 || ::listen(fd, backlog) < 0) {
+        const std::runtime_error e = systemError(path);
+        ::close(fd);
+        throw e;
+    }
+    return fd;
+}
+
+int connectUnix(const std::string& path) {
+    const sockaddr_un addr = address(path);
+    const int fd = ::socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (fd < 0) throw systemError("socket");
+    if (::connect(fd, reinterpret_cast<const sockaddr*>(&addr), sizeof(addr)) < 0) {
+        const std::runtime_error e = systemError(path);
+        ::close(fd);
+        throw e;
+    }
+    return fd;
+}
+
+} // namespace protocol
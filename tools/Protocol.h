@@ -0,0 +1,67 @@
+#ifndef PROTOCOL_H
+#define PROTOCOL_H
+
+#include "../Image.h"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Protocole de imgopd sur socket Unix (SOCK_STREAM). Entiers en u32 little-endian.
+// Une connexion peut enchaîner plusieurs requêtes ; chacune reçoit une réponse.
+//
+//   requête : "IMG1" | u32 argsLen | args | u32 dataLen | data
+//   réponse : u32 status | u32 width | u32 height | u32 channels | u32 payloadLen | payload
+//
+// args : jetons séparés par des '\0', comme une ligne de commande :
+//   --path FICHIER        image lue par le démon (sinon data contient l'image encodée)
+//   --channels N          force le nombre de canaux au décodage
+//   --format png|bmp|tga|jpg[:qualité]   format du résultat (défaut png)
+//   opérateurs            voir tools/Pipeline.h (--add 60 --threshold ">120"...)
+//
+// status 0 : payload est l'image résultat encodée ; sinon payload est le message d'erreur.
+namespace protocol {
+
+constexpr uint32_t magic = 0x31474D49;  // "IMG1"
+
+enum Status : uint32_t {
+    Ok = 0,
+    BadRequest = 1,   // arguments invalides, image illisible
+    Failed = 2,       // erreur pendant le traitement ou l'encodage
+    TooLarge = 3      // requête au-delà de la limite du démon
+};
+
+struct Request {
+    std::vector<std::string> args;
+    std::vector<uint8_t> data;
+};
+
+struct Response {
+    uint32_t status = Ok;
+    uint32_t width = 0;
+    uint32_t height = 0;
+    uint32_t channels = 0;
+    std::vector<uint8_t> payload;
+};
+
+// Lit une requête ; false si la connexion est fermée proprement avant le début.
+// std::length_error si elle dépasse maxBytes, std::runtime_error si le flux est
+// invalide ou coupé (la connexion n'est alors plus utilisable).
+// Les vecteurs de req sont réutilisés (capacité conservée d'une requête à l'autre).
+bool readRequest(int fd, Request& req, size_t maxBytes);
+void writeRequest(int fd, const std::vector<std::string>& args, const uint8_t* data, size_t size);
+
+bool readResponse(int fd, Response& res);
+void writeResponse(int fd, const Response& res);
+
+// "png", "jpg:85"... ; std::invalid_argument si inconnu
+void parseFormat(const std::string& s, FileFormat& format, int& quality);
+
+// Socket d'écoute (remplace une socket abandonnée, refuse tout autre fichier
+// existant ou une socket où un serveur répond) et connexion ;
+// std::runtime_error en cas d'échec
+int listenUnix(const std::string& path, int backlog = 64);
+int connectUnix(const std::string& path);
+
+} // namespace protocol
+
+#endif
@@ -0,0 +1,265 @@
+// Opérateurs de Image en ligne de commande, sur une image ou en lot.
+//
+//   imgop in.png --add 60 --threshold ">120" -o out.png
+//   imgop photos/ "scans/*.png" --convert gray --mul 1.2 -o sortie/ -j 8 --stats
+//   imgop big.png --diff @ref.png --repeat 20 --stats      (sans -o : mesure seule)
+//
+// Les opérateurs (voir tools/Pipeline.h) s'appliquent dans l'ordre de la ligne
+// de commande. En lot, -o désigne un dossier : chaque résultat y est écrit en
+// PNG sous le chemin de son entrée relatif au dossier commun des entrées.
+#include "Pipeline.h"
+#include "../Trace.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <filesystem>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+struct Options {
+    std::vector<std::string> inputs;
+    std::vector<std::string> operators;  // jetons passés à Pipeline::parse
+    std::string output;
+    int jobs = 0;
+    int channels = 0;
+    int repeat = 1;
+    bool stats = false;
+    bool quiet = false;
+};
+
+// Temps cumulés par thread (secondes CPU-mur de chaque worker), fusionnés à la fin
+struct Totals {
+    size_t images = 0;
+    size_t failed = 0;
+    double pixels = 0;
+    double bytesIn = 0;
+    double bytesOut = 0;
+    double load = 0;
+    double save = 0;
+    std::vector<double> steps;
+
+    void merge(const Totals& o) {
+        images += o.images;
+        failed += o.failed;
+        pixels += o.pixels;
+        bytesIn += o.bytesIn;
+        bytesOut += o.bytesOut;
+        load += o.load;
+        save += o.save;
+        if (steps.size() < o.steps.size()) steps.resize(o.steps.size(), 0.0);
+        for (size_t i = 0; i < o.steps.size(); ++i) steps[i] += o.steps[i];
+    }
+};
+
+double since(Clock::time_point t0) { return std::chrono::duration<double>(Clock::now() - t0).count(); }
+
+void usage() {
+    std::printf(
+        "Usage : imgop ENTRÉE... [opérateurs] [-o SORTIE] [options]\n"
+        "  ENTRÉE : fichier, dossier (récursif) ou motif glob entre guillemets\n"
+        "\n"
+        "Opérateurs (appliqués dans l'ordre) :\n"
+        "  --add V|R,G,B|@img    --sub ...    --diff ...   (saturés à [0, 255])\n"
+        "  --blend @img[:T]      (fondu (1 - T)·image + T·img, T = 0.5 par défaut)\n"
+        "  --mul F   --div F   --invert\n"
+        "  --threshold \">120\"   (<, <=, >, >=, ==, != ; résultat GRAY 0/255)\n"
+        "  --convert gray|graya|rgb|rgba|yuv|hsv[:bt709]\n"
+        "  --layout planar|interleaved\n"
+        "  --blur SIGMA   --sharpen AMOUNT   (convolution, bords répliqués)\n"
+        "  --boxblur R    --fastblur SIGMA   (sommes glissantes, grands rayons)\n"
+        "  --median R     (fenêtre (2R+1)², avant --threshold sur un scan bruité)\n"
+        "  --erode R   --dilate R   --open R   --close R   (carré (2R+1)², après --threshold)\n"
+        "  --resize WxH[:nearest|bilinear|bicubic|lanczos|area]   (0 : garde le rapport d'aspect)\n"
+        "  --rotate 90|180|270   --flip h|v   --transpose\n"
+        "  --rotate DEG          (autre angle, sens horaire ; redressement d'un scan)\n"
+        "  --perspective x0,y0,x1,y1,x2,y2,x3,y3[:WxH]   (coins HG, HD, BD, BG redressés)\n"
+        "\n"
+        "Options :\n"
+        "  -o SORTIE        fichier (une entrée) ou dossier (lot) ; absent : aucun fichier écrit\n"
+        "  -j N             threads de traitement (défaut : nombre de cœurs)\n"
+        "  --channels N     force le nombre de canaux au chargement\n"
+        "  --repeat N       applique les opérateurs N fois par image (mesure)\n"
+        "  --stats          débits par étape (chargement, opérateurs, sauvegarde)\n"
+        "  --quiet          n'affiche que les erreurs\n");
+}
+
+Options parse(int argc, char** argv) {
+    Options opt;
+    for (int i = 1; i < argc; ++i) {
+        const std::string a = argv[i];
+        auto next = [&]() -> std::string {
+            if (i + 1 >= argc) throw std::invalid_argument("Missing value for " + a);
+            return argv[++i];
+        };
+        if (a == "-o" || a == "--output") opt.output = next();
+        else if (a == "-j" || a == "--jobs") opt.jobs = std::max(1, std::stoi(next()));
+        else if (a == "--channels") {
+            opt.channels = std::stoi(next());
+            if (opt.channels < 0 || opt.channels > 4) throw std::invalid_argument("--channels must be in [0, 4]");
+        }
+        else if (a == "--repeat") opt.repeat = std::max(1, std::stoi(next()));
+        else if (a == "--stats") opt.stats = true;
+        else if (a == "--quiet" || a == "-q") opt.quiet = true;
+        else if (a == "--help" || a == "-h") { usage(); std::exit(0); }
+        else if (a.size() > 2 && a[0] == '-' && a[1] == '-') {
+            const int n = Pipeline::arity(a.substr(2));
+            if (n < 0) throw std::invalid_argument("Unknown option: " + a);
+            opt.operators.push_back(a);
+            if (n == 1) opt.operators.push_back(next());
+        } else if (!a.empty() && a[0] == '-' && a.size() > 1) {
+            throw std::invalid_argument("Unknown option: " + a);
+        } else {
+            opt.inputs.push_back(a);
+        }
+    }
+    if (opt.inputs.empty()) throw std::invalid_argument("No input image");
+    return opt;
+}
+
+// Dossier commun à toutes les entrées (chemins absolus normalisés)
+fs::path commonRoot(const std::vector<std::string>& files) {
+    fs::path root;
+    for (size_t i = 0; i < files.size(); ++i) {
+        const fs::path dir = fs::absolute(files[i]).lexically_normal().parent_path();
+        if (i == 0) {
+            root = dir;
+            continue;
+        }
+        fs::path common;
+        for (auto a = root.begin(), b = dir.begin(); a != root.end() && b != dir.end() && *a == *b; ++a, ++b)
+            common /= *a;
+        root = common;
+    }
+    return root;
+}
+
+// Chemins de sortie, calculés avant de lancer les workers : -o tel quel pour une
+// seule entrée vers un fichier, sinon dossier/<chemin relatif au dossier commun>.png
+// (a/x.png et b/x.png restent distincts). Deux entrées vers la même sortie
+// (x.png et x.jpg) : std::invalid_argument plutôt qu'un écrasement silencieux.
+std::vector<std::string> outputPaths(const Options& opt, const std::vector<std::string>& files, bool single) {
+    std::vector<std::string> paths(files.size());
+    if (opt.output.empty()) return paths;
+    if (single && !fs::is_directory(opt.output) && opt.output.back() != '/') {
+        paths[0] = opt.output;
+        return paths;
+    }
+    const fs::path root = commonRoot(files);
+    std::map<std::string, std::string> owner;
+    for (size_t i = 0; i < files.size(); ++i) {
+        fs::path rel = fs::absolute(files[i]).lexically_normal().lexically_relative(root);
+        rel.replace_extension(".png");
+        paths[i] = (fs::path(opt.output) / rel).string();
+        const auto [it, added] = owner.emplace(paths[i], files[i]);
+        if (!added)
+            throw std::invalid_argument("Inputs " + it->second + " and " + files[i] + " both write " + paths[i]);
+        fs::create_directories(fs::path(paths[i]).parent_path());
+    }
+    return paths;
+}
+
+void printStats(const Totals& t, const Pipeline& pipeline, double wall, int jobs, int repeat) {
+    auto line = [&](const char* what, double seconds, double bytes) {
+        std::printf("  %-28s %9.3f s %10.1f Mo/s %10.1f Mpix/s\n", what, seconds,
+                    seconds > 0 ? bytes / seconds / 1e6 : 0.0, seconds > 0 ? t.pixels / seconds / 1e6 : 0.0);
+    };
+    std::printf("imgop: %zu image(s), %.1f Mpix en %.3f s, %d thread(s) : %.1f images/s, %.1f Mpix/s\n", t.images,
+                t.pixels / 1e6, wall, jobs, wall > 0 ? t.images / wall : 0.0, wall > 0 ? t.pixels / wall / 1e6 : 0.0);
+    std::printf("  temps cumulés des threads :\n");
+    line("load", t.load, t.bytesIn);
+    for (size_t i = 0; i < pipeline.size(); ++i) {
+        const std::string label = pipeline.name(i) + (repeat > 1 ? " (x" + std::to_string(repeat) + ")" : "");
+        line(label.c_str(), i < t.steps.size() ? t.steps[i] : 0.0, t.bytesIn * repeat);
+    }
+    if (t.save > 0) line("save", t.save, t.bytesOut);
+    if (t.failed) std::printf("  %zu échec(s)\n", t.failed);
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    try {
+        Options opt = parse(argc, argv);
+        const Pipeline pipeline = Pipeline::parse(opt.operators);
+        const std::vector<std::string> files = expandInputs(opt.inputs);
+        if (files.empty()) throw std::invalid_argument("No image found in the given inputs");
+
+        const bool single = files.size() == 1;
+        if (!opt.output.empty() && (!single || fs::is_directory(opt.output) || opt.output.back() == '/'))
+            fs::create_directories(opt.output);
+        const std::vector<std::string> outputs = outputPaths(opt, files, single);
+
+        const int jobs = std::max(1, std::min<int>(opt.jobs ? opt.jobs : std::thread::hardware_concurrency(),
+                                                   static_cast<int>(files.size())));
+        std::atomic<size_t> nextFile{0};
+        std::mutex lock;  // sorties console et fusion des totaux
+        Totals totals;
+
+        auto worker = [&](int id) {
+            if (trace::enabled()) trace::setThreadName(("imgop worker " + std::to_string(id)).c_str());
+            Totals local;
+            for (size_t i; (i = nextFile.fetch_add(1)) < files.size();) {
+                const std::string& in = files[i];
+                try {
+                    auto t0 = Clock::now();
+                    Image img = Image::load(in.c_str(), opt.channels);
+                    local.load += since(t0);
+                    const double bytes = static_cast<double>(img.getWidth()) * img.getHeight() * img.getChannels();
+                    const double pixels = static_cast<double>(img.getWidth()) * img.getHeight();
+
+                    // Chaque répétition repart de l'image chargée ; la dernière la consomme
+                    Image out;
+                    for (int r = 0; r < opt.repeat; ++r)
+                        out = pipeline.run(r + 1 < opt.repeat ? Image(img) : std::move(img),
+                                           opt.stats ? &local.steps : nullptr);
+
+                    const std::string& path = outputs[i];
+                    if (!path.empty()) {
+                        t0 = Clock::now();
+                        if (!out.save(path.c_str())) throw std::runtime_error("cannot write " + path);
+                        local.save += since(t0);
+                        local.bytesOut += static_cast<double>(out.getWidth()) * out.getHeight() * out.getChannels();
+                    }
+                    ++local.images;
+                    local.bytesIn += bytes;
+                    local.pixels += pixels;
+                    if (!opt.quiet && !opt.stats) {
+                        std::lock_guard<std::mutex> g(lock);
+                        std::printf("%s -> %s (%dx%dx%d)\n", in.c_str(), path.empty() ? "-" : path.c_str(),
+                                    out.getWidth(), out.getHeight(), out.getChannels());
+                    }
+                } catch (const std::exception& e) {
+                    ++local.failed;
+                    std::lock_guard<std::mutex> g(lock);
+                    std::fprintf(stderr, "imgop: %s: %s\n", in.c_str(), e.what());
+                }
+            }
+            std::lock_guard<std::mutex> g(lock);
+            totals.merge(local);
+        };
+
+        const auto start = Clock::now();
+        std::vector<std::thread> threads;
+        for (int j = 1; j < jobs; ++j) threads.emplace_back(worker, j);
+        worker(0);
+        for (std::thread& t : threads) t.join();
+        const double wall = since(start);
+
+        if (opt.stats) printStats(totals, pipeline, wall, jobs, opt.repeat);
+        return totals.failed ? 1 : 0;
+    } catch (const std::exception& e) {
+        std::fprintf(stderr, "imgop: %s\n", e.what());
+        std::fprintf(stderr, "imgop --help pour l'aide\n");
+        return 2;
+    }
+}
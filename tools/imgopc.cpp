@@ -0,0 +1,118 @@
+// Client de imgopd : envoie une image et une suite d'opérateurs, écrit le résultat.
+//
+//   imgopc in.png --add 60 --threshold ">120" -o out.png
+//   imgopc in.png --convert gray --format jpg:85 -o out.jpg --repeat 100   (latence)
+//   imgopc /data/in.png --remote --mul 1.2 -o out.png    (lu par le démon, --allow-paths)
+#include "Pipeline.h"
+#include "Protocol.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+#include <unistd.h>
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+struct Options {
+    std::string socket = "/tmp/imgopd.sock";
+    std::string input;
+    std::string output;
+    std::vector<std::string> args;  // transmis tels quels au démon
+    bool remote = false;
+    int repeat = 1;
+};
+
+void usage() {
+    std::printf(
+        "Usage : imgopc ENTRÉE [opérateurs de imgop] [options]\n"
+        "  -o SORTIE          fichier résultat (absent : rien n'est écrit)\n"
+        "  --format F         png|bmp|tga|jpg[:qualité] (défaut png)\n"
+        "  --channels N       force le nombre de canaux au décodage\n"
+        "  --remote           ENTRÉE est un chemin lu par le démon\n"
+        "  --repeat N         envoie la requête N fois sur la même connexion (latences)\n"
+        "  --socket CHEMIN    défaut : /tmp/imgopd.sock\n");
+}
+
+Options parse(int argc, char** argv) {
+    Options opt;
+    for (int i = 1; i < argc; ++i) {
+        const std::string a = argv[i];
+        auto next = [&]() -> std::string {
+            if (i + 1 >= argc) throw std::invalid_argument("Missing value for " + a);
+            return argv[++i];
+        };
+        if (a == "-o" || a == "--output") opt.output = next();
+        else if (a == "--socket") opt.socket = next();
+        else if (a == "--remote") opt.remote = true;
+        else if (a == "--repeat") opt.repeat = std::max(1, std::stoi(next()));
+        else if (a == "--help" || a == "-h") { usage(); std::exit(0); }
+        else if (a.size() > 2 && a[0] == '-' && a[1] == '-') {
+            // --format, --channels et opérateurs (arité de Pipeline) : le démon valide
+            const bool daemon = a == "--format" || a == "--channels";
+            const int n = daemon ? 1 : Pipeline::arity(a.substr(2));
+            if (n < 0) throw std::invalid_argument("Unknown option: " + a);
+            opt.args.push_back(a);
+            if (n == 1) opt.args.push_back(next());
+        } else if (opt.input.empty()) {
+            opt.input = a;
+        } else {
+            throw std::invalid_argument("Unexpected argument: " + a);
+        }
+    }
+    if (opt.input.empty()) throw std::invalid_argument("No input image");
+    return opt;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    try {
+        Options opt = parse(argc, argv);
+        std::vector<uint8_t> data;
+        if (opt.remote) {
+            opt.args.insert(opt.args.begin(), {"--path", opt.input});
+        } else {
+            std::ifstream in(opt.input, std::ios::binary);
+            if (!in) throw std::runtime_error("cannot read " + opt.input);
+            data.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+        }
+
+        const int fd = protocol::connectUnix(opt.socket);
+        protocol::Response res;
+        std::vector<double> latencies;
+        for (int r = 0; r < opt.repeat; ++r) {
+            const auto t0 = Clock::now();
+            protocol::writeRequest(fd, opt.args, data.data(), data.size());
+            if (!protocol::readResponse(fd, res)) throw std::runtime_error("connection closed by imgopd");
+            latencies.push_back(std::chrono::duration<double, std::milli>(Clock::now() - t0).count());
+            if (res.status != protocol::Ok) break;
+        }
+        ::close(fd);
+
+        if (res.status != protocol::Ok) {
+            std::fprintf(stderr, "imgopc: erreur %u : %.*s\n", res.status, static_cast<int>(res.payload.size()),
+                         reinterpret_cast<const char*>(res.payload.data()));
+            return 1;
+        }
+        if (!opt.output.empty()) {
+            std::ofstream out(opt.output, std::ios::binary);
+            out.write(reinterpret_cast<const char*>(res.payload.data()), res.payload.size());
+            if (!out) throw std::runtime_error("cannot write " + opt.output);
+        }
+        std::sort(latencies.begin(), latencies.end());
+        std::printf("%s -> %s (%ux%ux%u, %zu octets) : médiane %.2f ms", opt.input.c_str(),
+                    opt.output.empty() ? "-" : opt.output.c_str(), res.width, res.height, res.channels,
+                    res.payload.size(), latencies[latencies.size() / 2]);
+        if (latencies.size() > 1) std::printf(", min %.2f ms, max %.2f ms", latencies.front(), latencies.back());
+        std::printf("\n");
+        return 0;
+    } catch (const std::exception& e) {
+        std::fprintf(stderr, "imgopc: %s\n", e.what());
+        return 2;
+    }
+}
@@ -0,0 +1,376 @@
+// Démon de traitement d'images sur socket Unix : évite de repayer le démarrage
+// d'un processus et des caches froids à chaque image.
+//
+//   imgopd --socket /tmp/imgopd.sock -j 8
+//   imgopc in.png --add 60 --threshold ">120" --format png -o out.png
+//
+// Protocole : tools/Protocol.h. Les workers sont créés au démarrage et gardent
+// leurs buffers d'entrée/sortie d'une requête à l'autre ; les Pipelines (avec
+// leurs opérandes @image déjà chargés) sont gardés dans un cache LRU.
+// Chaque worker sert une connexion à la fois, jusqu'à sa fermeture ou à
+// --idle secondes sans activité.
+#include "Pipeline.h"
+#include "Protocol.h"
+#include "../Trace.h"
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <condition_variable>
+#include <csignal>
+#include <cstdio>
+#include <deque>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+#include <pthread.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <unistd.h>
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+struct Options {
+    std::string socket = "/tmp/imgopd.sock";
+    int jobs = 0;
+    size_t maxBytes = size_t(256) << 20;
+    size_t maxPixels = size_t(64) << 20;
+    int idleSeconds = 30;
+    size_t cacheSize = 64;
+    bool allowPaths = false;
+    bool verbose = false;
+};
+
+volatile std::sig_atomic_t stopRequested = 0;
+
+void onSignal(int) { stopRequested = 1; }
+
+void usage() {
+    std::printf(
+        "Usage : imgopd [options]\n"
+        "  --socket CHEMIN   socket d'écoute (défaut : /tmp/imgopd.sock)\n"
+        "  -j N              workers, donc connexions servies en parallèle (défaut : nombre de cœurs)\n"
+        "  --max-bytes N     taille maximale d'une requête (défaut : 256 Mo)\n"
+        "  --max-pixels N    pixels maximaux de l'image décodée (défaut : 64 Mpix)\n"
+        "  --idle S          coupe une connexion muette depuis S secondes (défaut : 30)\n"
+        "  --cache N         pipelines gardés en cache (défaut : 64)\n"
+        "  --allow-paths     accepte --path et les opérandes @fichier (lus par le démon)\n"
+        "  --verbose         une ligne par requête\n"
+        "Arrêt : SIGINT / SIGTERM (la socket est supprimée).\n");
+}
+
+Options parse(int argc, char** argv) {
+    Options opt;
+    for (int i = 1; i < argc; ++i) {
+        const std::string a = argv[i];
+        auto next = [&]() -> std::string {
+            if (i + 1 >= argc) throw std::invalid_argument("Missing value for " + a);
+            return argv[++i];
+        };
+        if (a == "--socket") opt.socket = next();
+        else if (a == "-j" || a == "--jobs") opt.jobs = std::max(1, std::stoi(next()));
+        else if (a == "--max-bytes") opt.maxBytes = std::stoull(next());
+        else if (a == "--max-pixels") opt.maxPixels = std::stoull(next());
+        else if (a == "--idle") opt.idleSeconds = std::max(1, std::stoi(next()));
+        else if (a == "--cache") opt.cacheSize = std::max(1, std::stoi(next()));
+        else if (a == "--allow-paths") opt.allowPaths = true;
+        else if (a == "--verbose" || a == "-v") opt.verbose = true;
+        else if (a == "--help" || a == "-h") { usage(); std::exit(0); }
+        else throw std::invalid_argument("Unknown option: " + a);
+    }
+    return opt;
+}
+
+// Pipelines déjà construits, indexés par leur suite de jetons (LRU)
+class PipelineCache {
+public:
+    explicit PipelineCache(size_t capacity) : capacity(capacity) {}
+
+    std::shared_ptr<const Pipeline> get(const std::vector<std::string>& tokens) {
+        std::string key;
+        for (const std::string& t : tokens) (key += t) += '\0';
+        {
+            std::lock_guard<std::mutex> g(lock);
+            auto it = index.find(key);
+            if (it != index.end()) {
+                order.splice(order.begin(), order, it->second);
+                return it->second->second;
+            }
+        }
+        // Construit hors du verrou (peut charger des opérandes) ; deux workers
+        // peuvent construire le même pipeline, le second remplace le premier
+        auto pipeline = std::make_shared<const Pipeline>(Pipeline::parse(tokens));
+        std::lock_guard<std::mutex> g(lock);
+        auto it = index.find(key);
+        if (it != index.end()) order.erase(it->second);
+        order.emplace_front(key, pipeline);
+        index[key] = order.begin();
+        if (order.size() > capacity) {
+            index.erase(order.back().first);
+            order.pop_back();
+        }
+        return pipeline;
+    }
+
+private:
+    using Entry = std::pair<std::string, std::shared_ptr<const Pipeline>>;
+    size_t capacity;
+    std::mutex lock;
+    std::list<Entry> order;  // plus récent en tête
+    std::unordered_map<std::string, std::list<Entry>::iterator> index;
+};
+
+// Connexions acceptées en attente d'un worker, et connexions en cours
+// (coupées à l'arrêt pour débloquer les workers en lecture)
+class Connections {
+public:
+    void push(int fd) {
+        {
+            std::lock_guard<std::mutex> g(lock);
+            pending.push_back(fd);
+        }
+        ready.notify_one();
+    }
+
+    // -1 après close()
+    int pop() {
+        std::unique_lock<std::mutex> g(lock);
+        ready.wait(g, [&] { return closed || !pending.empty(); });
+        if (closed) return -1;
+        const int fd = pending.front();
+        pending.pop_front();
+        active.insert(fd);
+        return fd;
+    }
+
+    void done(int fd) {
+        std::lock_guard<std::mutex> g(lock);
+        active.erase(fd);
+        ::close(fd);
+    }
+
+    void close() {
+        {
+            std::lock_guard<std::mutex> g(lock);
+            closed = true;
+            for (int fd : pending) ::close(fd);
+            pending.clear();
+            for (int fd : active) ::shutdown(fd, SHUT_RDWR);
+        }
+        ready.notify_all();
+    }
+
+private:
+    std::mutex lock;
+    std::condition_variable ready;
+    std::deque<int> pending;
+    std::set<int> active;
+    bool closed = false;
+};
+
+struct Counters {
+    std::atomic<uint64_t> requests{0};
+    std::atomic<uint64_t> failed{0};
+    std::atomic<uint64_t> bytesIn{0};
+    std::atomic<uint64_t> bytesOut{0};
+};
+
+// Un worker et ses buffers, réutilisés d'une requête à l'autre
+class Worker {
+public:
+    Worker(const Options& opt, PipelineCache& cache, Counters& counters)
+        : opt(opt), cache(cache), counters(counters) {}
+
+    void serve(int fd) {
+        for (;;) {
+            try {
+                if (!protocol::readRequest(fd, req, opt.maxBytes)) return;
+            } catch (const std::length_error& e) {
+                reply(fd, protocol::TooLarge, e.what());
+                return;
+            } catch (const std::exception& e) {
+                // Flux désynchronisé : la connexion est abandonnée
+                if (opt.verbose && !stopRequested) std::fprintf(stderr, "imgopd: %s\n", e.what());
+                return;
+            }
+            const auto t0 = Clock::now();
+            handle();
+            if (opt.verbose) log(std::chrono::duration<double, std::milli>(Clock::now() - t0).count());
+            try {
+                protocol::writeResponse(fd, res);
+            } catch (const std::exception&) {
+                return;  // client parti
+            }
+        }
+    }
+
+private:
+    const Options& opt;
+    PipelineCache& cache;
+    Counters& counters;
+    protocol::Request req;
+    protocol::Response res;
+    std::vector<std::string> operators;
+
+    void reply(int fd, uint32_t status, const std::string& message) {
+        fail(status, message);
+        try { protocol::writeResponse(fd, res); } catch (const std::exception&) {}
+    }
+
+    void fail(uint32_t status, const std::string& message) {
+        ++counters.failed;
+        res.status = status;
+        res.width = res.height = res.channels = 0;
+        res.payload.assign(message.begin(), message.end());
+    }
+
+    void handle() {
+        ++counters.requests;
+        counters.bytesIn += req.data.size();
+        std::string path;
+        int channels = 0;
+        FileFormat format = FileFormat::PNG;
+        int quality = 90;
+        Image img;
+        try {
+            operators.clear();
+            for (size_t i = 0; i < req.args.size(); ++i) {
+                const std::string& a = req.args[i];
+                auto next = [&]() -> const std::string& {
+                    if (i + 1 >= req.args.size()) throw std::invalid_argument("Missing value for " + a);
+                    return req.args[++i];
+                };
+                if (a == "--path") path = next();
+                else if (a == "--channels") channels = std::stoi(next());
+                else if (a == "--format") protocol::parseFormat(next(), format, quality);
+                else {
+                    if (!opt.allowPaths && !a.empty() && a[0] == '@')
+                        throw std::invalid_argument("Image operands are disabled (imgopd --allow-paths)");
+                    operators.push_back(a);
+                }
+            }
+            if (channels < 0 || channels > 4) throw std::invalid_argument("--channels must be in [0, 4]");
+            if (!path.empty() && !opt.allowPaths)
+                throw std::invalid_argument("--path is disabled (imgopd --allow-paths)");
+            if (path.empty() && req.data.empty()) throw std::invalid_argument("No input image");
+            img = path.empty() ? Image::decode(req.data.data(), req.data.size(), channels)
+                               : Image::load(path.c_str(), channels);
+        } catch (const std::exception& e) {
+            fail(protocol::BadRequest, e.what());
+            return;
+        }
+        if (static_cast<size_t>(img.getWidth()) * img.getHeight() > opt.maxPixels) {
+            fail(protocol::TooLarge, "Image larger than the daemon limit (imgopd --max-pixels)");
+            return;
+        }
+        try {
+            const auto pipeline = cache.get(operators);
+            img = pipeline->run(std::move(img));
+            img.encode(res.payload, format, quality);
+        } catch (const std::invalid_argument& e) {
+            fail(protocol::BadRequest, e.what());
+            return;
+        } catch (const std::exception& e) {
+            fail(protocol::Failed, e.what());
+            return;
+        }
+        res.status = protocol::Ok;
+        res.width = static_cast<uint32_t>(img.getWidth());
+        res.height = static_cast<uint32_t>(img.getHeight());
+        res.channels = static_cast<uint32_t>(img.getChannels());
+        counters.bytesOut += res.payload.size();
+    }
+
+    void log(double ms) const {
+        std::string ops;
+        for (const std::string& o : operators) (ops += ' ') += o;
+        if (res.status == protocol::Ok)
+            std::fprintf(stderr, "imgopd: %ux%ux%u%s -> %zu octets en %.2f ms\n", res.width, res.height,
+                         res.channels, ops.c_str(), res.payload.size(), ms);
+        else
+            std::fprintf(stderr, "imgopd: erreur %u : %.*s\n", res.status, static_cast<int>(res.payload.size()),
+                         reinterpret_cast<const char*>(res.payload.data()));
+    }
+};
+
+} // namespace
+
+int main(int argc, char** argv) {
+    Options opt;
+    try {
+        opt = parse(argc, argv);
+    } catch (const std::exception& e) {
+        std::fprintf(stderr, "imgopd: %s\nimgopd --help pour l'aide\n", e.what());
+        return 2;
+    }
+
+    // Les workers héritent du masque : seuls les signaux du thread principal
+    // interrompent accept()
+    sigset_t stopSignals;
+    sigemptyset(&stopSignals);
+    sigaddset(&stopSignals, SIGINT);
+    sigaddset(&stopSignals, SIGTERM);
+    pthread_sigmask(SIG_BLOCK, &stopSignals, nullptr);
+    struct sigaction sa {};
+    sa.sa_handler = onSignal;  // sans SA_RESTART
+    sigaction(SIGINT, &sa, nullptr);
+    sigaction(SIGTERM, &sa, nullptr);
+    std::signal(SIGPIPE, SIG_IGN);
+
+    int listener;
+    try {
+        listener = protocol::listenUnix(opt.socket);
+    } catch (const std::exception& e) {
+        std::fprintf(stderr, "imgopd: %s\n", e.what());
+        return 1;
+    }
+
+    const int jobs = opt.jobs ? opt.jobs : std::max(1u, std::thread::hardware_concurrency());
+    PipelineCache cache(opt.cacheSize);
+    Connections connections;
+    Counters counters;
+    std::vector<std::thread> workers;
+    for (int j = 0; j < jobs; ++j) {
+        workers.emplace_back([&, j] {
+            if (trace::enabled()) trace::setThreadName(("imgopd worker " + std::to_string(j)).c_str());
+            Worker w(opt, cache, counters);
+            for (int fd; (fd = connections.pop()) >= 0;) {
+                w.serve(fd);
+                connections.done(fd);
+            }
+        });
+    }
+    pthread_sigmask(SIG_UNBLOCK, &stopSignals, nullptr);
+    std::fprintf(stderr, "imgopd: en écoute sur %s, %d worker(s)\n", opt.socket.c_str(), jobs);
+
+    while (!stopRequested) {
+        const int fd = ::accept4(listener, nullptr, nullptr, SOCK_CLOEXEC);
+        if (fd >= 0) {
+            // Client muet ou qui ne lit plus : read / write échouent, le worker est libéré
+            const timeval idle{opt.idleSeconds, 0};
+            ::setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &idle, sizeof(idle));
+            ::setsockopt(fd, SOL_SOCKET, SO_SNDTIMEO, &idle, sizeof(idle));
+            connections.push(fd);
+        } else if (errno != EINTR && errno != ECONNABORTED) {
+            std::perror("imgopd: accept");
+            break;
+        }
+    }
+
+    ::close(listener);
+    ::unlink(opt.socket.c_str());
+    connections.close();
+    for (std::thread& t : workers) t.join();
+    std::fprintf(stderr, "imgopd: arrêt, %llu requête(s) dont %llu en erreur, %.1f Mo reçus, %.1f Mo envoyés\n",
+                 static_cast<unsigned long long>(counters.requests.load()),
+                 static_cast<unsigned long long>(counters.failed.load()), counters.bytesIn.load() / 1e6,
+                 counters.bytesOut.load() / 1e6);
+    return stopRequested ? 0 : 1;
+}
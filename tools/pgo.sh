@@ -0,0 +1,84 @@
+#!/bin/sh
+# Build PGO complet :
+#   1. build instrumenté (preset pgo-generate)
+#   2. entraînement : pgo_train sur le corpus (défaut : les images de la démo)
+#   3. rebuild optimisé avec les profils (preset pgo-use)
+#   4. si llvm-bolt est disponible : réordonnancement post-édition de liens
+#      des exécutables (profil collecté par instrumentation BOLT)
+#
+#   tools/pgo.sh [IMAGE|DOSSIER...]
+set -eu
+
+SRC=$(cd "$(dirname "$0")/.." && pwd)
+
+# Corpus : paramètres positionnels (un chemin par élément, espaces compris),
+# rendus absolus avant le cd
+if [ $# -eq 0 ]; then
+    set -- "$SRC/new-lulu-fit.png" "$SRC/pip-secret.png"
+fi
+for path in "$@"; do
+    shift
+    case $path in
+        /*) ;;
+        *) path="$PWD/$path" ;;
+    esac
+    set -- "$@" "$path"
+done
+# Liste CMake (séparateur ;)
+CORPUS_LIST=
+for path in "$@"; do
+    CORPUS_LIST="${CORPUS_LIST:+$CORPUS_LIST;}$path"
+done
+
+cd "$SRC"
+PROFILES="$SRC/build/pgo-profiles"
+JOBS=${JOBS:-$(nproc 2>/dev/null || echo 4)}
+BOLT=${LLVM_BOLT:-$(command -v llvm-bolt || true)}
+
+echo "== PGO 1/3 : build instrumenté"
+rm -rf "$PROFILES"
+cmake --preset pgo-generate -DIMAGE_PGO_CORPUS="$CORPUS_LIST"
+cmake --build --preset pgo-generate -j "$JOBS"
+
+echo "== PGO 2/3 : entraînement"
+cmake --build --preset pgo-generate --target pgo-train
+if ls "$PROFILES"/*.profraw >/dev/null 2>&1; then
+    # Clang : les profils bruts doivent être fusionnés
+    llvm-profdata merge -o "$PROFILES/default.profdata" "$PROFILES"/*.profraw
+fi
+
+echo "== PGO 3/3 : build optimisé"
+if [ -n "$BOLT" ]; then
+    cmake --preset pgo-use -DIMAGE_BOLT=ON
+else
+    cmake --preset pgo-use -DIMAGE_BOLT=OFF
+fi
+cmake --build --preset pgo-use -j "$JOBS"
+
+if [ -z "$BOLT" ]; then
+    echo "llvm-bolt introuvable : étape BOLT ignorée"
+    echo "Binaires optimisés : build/pgo-use/"
+    exit 0
+fi
+
+echo "== BOLT : instrumentation et réordonnancement"
+OUT="$SRC/build/pgo-use"
+WORK=$(mktemp -d)
+trap 'rm -rf "$WORK"' EXIT
+for exe in pgo_train projet bench_image; do
+    [ -x "$OUT/$exe" ] || continue
+    "$BOLT" "$OUT/$exe" -instrument -o "$WORK/$exe.inst" \
+        --instrumentation-file="$WORK/$exe.fdata" --instrumentation-file-append-pid=0
+    # Même charge d'entraînement pour tous : le code de la bibliothèque est commun
+    mkdir -p "$WORK/out"
+    case $exe in
+        pgo_train)   "$WORK/$exe.inst" --out "$WORK/out" "$@" ;;
+        projet)      (cd "$WORK/out" && cp "$SRC/new-lulu-fit.png" "$SRC/pip-secret.png" . && "$WORK/$exe.inst") ;;
+        bench_image) "$WORK/$exe.inst" --sizes 256,1K --repetitions 1 --min-time 0.005 ;;
+    esac >/dev/null
+    "$BOLT" "$OUT/$exe" -o "$OUT/$exe.bolt" -data="$WORK/$exe.fdata" \
+        -reorder-blocks=ext-tsp -reorder-functions=hfsort -split-functions \
+        -split-all-cold -icf=1 -dyno-stats
+    mv "$OUT/$exe.bolt" "$OUT/$exe"
+done
+echo "Binaires optimisés (PGO + BOLT) : build/pgo-use/"
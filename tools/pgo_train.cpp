@@ -0,0 +1,133 @@
+// Charge d'entraînement PGO : la démonstration de main.cpp (load, +, -, ^,
+// seuillage, save) généralisée à un corpus d'images, plus les chemins que la
+// démo n'atteint pas (planaire, conversions de modèle, masques, relecture PNG).
+//
+//   pgo_train [--out DOSSIER] [--rounds N] IMAGE|DOSSIER...
+//
+// Les dossiers sont parcourus récursivement (.png, .jpg, .jpeg, .bmp, .tga).
+// Chaque image est combinée avec la suivante du corpus, de tailles en général
+// différentes, pour passer aussi par l'agrandissement (enlargeTo).
+#include "Pipeline.h"
+#include <chrono>
+#include <cstdio>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+namespace {
+
+// Sauvegarde puis relit le fichier : entraîne l'encodeur et le décodeur PNG
+size_t roundTrip(const Image& img, const fs::path& file) {
+    if (!img.save(file.string().c_str())) throw std::runtime_error("Failed to save " + file.string());
+    Image back = Image::load(file.string().c_str());
+    return static_cast<size_t>(back.getWidth()) * back.getHeight() * back.getChannels();
+}
+
+// === CHARGE PAR PAIRE D'IMAGES ===
+size_t train(const Image& a, const Image& b, const fs::path& out, const std::string& tag) {
+    size_t bytes = 0;
+    auto keep = [&](const Image& img, const char* name) { bytes += roundTrip(img, out / (tag + name)); };
+
+    // Démonstration de main.cpp
+    keep(a + b, "_addition.png");
+    keep(a - b, "_soustraction.png");
+    keep(a ^ b, "_difference.png");
+    keep(~a, "_inversee.png");
+    keep(a + 60, "_plus_lumineuse.png");
+    keep(a - 40, "_plus_sombre.png");
+    keep(a * 1.5, "_contraste.png");
+    keep(a / 2.0, "_divisee.png");
+    keep(a ^ 128, "_xor.png");
+    keep(a + std::vector<uint8_t>(a.getChannels(), 30), "_pixel.png");
+
+    Mask gt = a > 120;
+    keep(gt.toImage(), "_seuillage.png");
+    Mask band = (a >= 64) & (a <= 192);
+    Mask odd = (a == 0) | ((a != 255) ^ (a < 32));
+    bytes += band.count() + odd.count() + (~gt).count();
+    keep(Image(band), "_bande.png");
+
+    // Conversions de modèle
+    Image gray = a.convertTo(ColorModel::GRAY);
+    keep(gray, "_gris.png");
+    keep(a.convertTo(ColorModel::YUV).convertTo(ColorModel::RGB), "_yuv.png");
+    keep(a.convertTo(ColorModel::YUV, LumaStandard::BT709).convertTo(ColorModel::RGB, LumaStandard::BT709),
+         "_yuv709.png");
+    keep(a.convertTo(ColorModel::HSV).convertTo(ColorModel::RGB), "_hsv.png");
+    keep(a.convertTo(ColorModel::RGBA), "_rgba.png");
+    keep(gray.convertTo(ColorModel::RGB), "_gris_rgb.png");
+    bytes += (gray > 100).count();
+
+    // Layout planaire
+    Image pa = a.toLayout(Layout::Planar);
+    Image pb = b.toLayout(Layout::Planar);
+    Image mixed = pa + b;  // layouts différents : conversion de l'opérande
+    mixed -= pb;
+    mixed ^= a;
+    bytes += (pa > 100).count() + (pa != 7).count();
+    keep(mixed, "_planaire.png");
+    keep(pa.convertTo(ColorModel::GRAY), "_planaire_gris.png");
+    return bytes;
+}
+
+void usage() {
+    std::printf(
+        "Usage : pgo_train [--out DOSSIER] [--rounds N] IMAGE|DOSSIER...\n"
+        "  --out DOSSIER   où écrire les résultats (défaut : dossier temporaire)\n"
+        "  --rounds N      nombre de passes sur le corpus (défaut : 1)\n");
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    try {
+        fs::path out = fs::temp_directory_path() / "pgo_train";
+        int rounds = 1;
+        std::vector<std::string> inputs;
+        for (int i = 1; i < argc; ++i) {
+            std::string a = argv[i];
+            auto next = [&]() -> std::string {
+                if (i + 1 >= argc) throw std::invalid_argument("Missing value for " + a);
+                return argv[++i];
+            };
+            if (a == "--out") out = next();
+            else if (a == "--rounds") rounds = std::stoi(next());
+            else if (a == "--help" || a == "-h") { usage(); return 0; }
+            else if (!a.empty() && a[0] == '-') throw std::invalid_argument("Unknown option: " + a);
+            else inputs.push_back(a);
+        }
+        if (inputs.empty()) throw std::invalid_argument("No input image");
+
+        std::vector<fs::path> files;
+        for (const std::string& f : expandInputs(inputs)) files.push_back(f);
+        if (files.empty()) throw std::invalid_argument("No image found in the given inputs");
+        fs::create_directories(out);
+
+        auto start = std::chrono::steady_clock::now();
+        size_t bytes = 0;
+        for (int r = 0; r < rounds; ++r) {
+            for (size_t i = 0; i < files.size(); ++i) {
+                const fs::path& next = files[(i + 1) % files.size()];
+                std::string tag = files[i].stem().string();
+                // Forcé en RGB comme la démo, puis dans le nombre de canaux d'origine
+                Image a = Image::load(files[i].string().c_str(), 3);
+                Image b = Image::load(next.string().c_str(), 3);
+                bytes += train(a, b, out, tag);
+
+                Image native = Image::load(files[i].string().c_str());
+                bytes += roundTrip(~native, out / (tag + "_natif.png"));
+                bytes += (native > 128).count();
+            }
+        }
+        double s = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        std::printf("pgo_train: %zu image(s) x %d passe(s), %.1f Mo traités en %.2f s -> %s\n", files.size(),
+                    rounds, bytes / 1e6, s, out.string().c_str());
+    } catch (const std::exception& e) {
+        std::fprintf(stderr, "pgo_train: %s\n", e.what());
+        usage();
+        return 1;
+    }
+    return 0;
+}